@@ -2,10 +2,38 @@ extends Node
 
 var example: ExampleClass
 
+# run the game tics on their own thread, Godot frames only present
+@export var threaded_simulation := false
+
+var audio_player: AudioStreamPlayer
+var audio_playback: AudioStreamGeneratorPlayback
+
 func _ready() -> void:
 	example = ExampleClass.new()
 	example.print_type(example)
 	example.init()
+	if threaded_simulation:
+		example.start_simulation_thread()
+	start_audio()
+
+# the engine mixes into a ring buffer, this drains it into a generator stream
+func start_audio() -> void:
+	var generator := AudioStreamGenerator.new()
+	generator.mix_rate = example.get_audio_mix_rate()
+	generator.buffer_length = 0.1
+	audio_player = AudioStreamPlayer.new()
+	audio_player.stream = generator
+	add_child(audio_player)
+	audio_player.play()
+	audio_playback = audio_player.get_stream_playback()
 	
 func _process(delta: float) -> void:
 	example.tick()
+	if audio_playback:
+		var frames := audio_playback.get_frames_available()
+		if frames > 0:
+			audio_playback.push_buffer(example.read_audio(frames))
+
+func _exit_tree() -> void:
+	if example:
+		example.stop_simulation_thread()
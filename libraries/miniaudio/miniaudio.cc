@@ -1,9 +1,3 @@
-#define MA_NO_ENCODING
-#define MA_NO_GENERATION
-#define MA_NO_RESOURCE_MANAGER
-// We use our own custom minivorbis decoder
-#define MA_NO_VORBIS
-#define MA_USE_STDINT
 #ifdef _WIN32
 // We want to use the apartment model in order
 // to prevent conflicts with SDL
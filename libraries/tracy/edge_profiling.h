@@ -21,6 +21,40 @@ struct ECFrameStats
 
 extern ECFrameStats ec_frame_stats;
 
+// Built-in profiler (see e_profile.cc).  EDGE_ProfileZone marks the
+// coarse parts of a frame and is always compiled in; while nothing is
+// recording it costs a single relaxed load.  The finer EDGE_ZoneScoped
+// zones (per seg, per thing, recursive BSP nodes) stay Tracy only.
+
+#include <atomic>
+
+extern std::atomic<bool> ec_profile_recording;
+
+void ECProfileBegin(const char *name);
+void ECProfileEnd();
+
+class ECProfileScope
+{
+  public:
+	explicit ECProfileScope(const char *name) : active_(ec_profile_recording.load(std::memory_order_relaxed))
+	{
+		if (active_)
+			ECProfileBegin(name);
+	}
+
+	~ECProfileScope()
+	{
+		if (active_)
+			ECProfileEnd();
+	}
+
+  private:
+	bool active_;
+};
+
+#define EDGE_PROFILE_CONCAT_INNER(a, b) a##b
+#define EDGE_PROFILE_CONCAT(a, b) EDGE_PROFILE_CONCAT_INNER(a, b)
+
 #ifdef EDGE_PROFILING
 	
 	#include <tracy/Tracy.hpp>
@@ -45,6 +79,10 @@ extern ECFrameStats ec_frame_stats;
 	#define EDGE_FrameMarkStart(name) FrameMarkStart(name)
 	#define EDGE_FrameMarkEnd(name) FrameMarkEnd(name)
 
+	#define EDGE_ProfileZone(name) \
+		ZoneNamedN(EDGE_PROFILE_CONCAT(ec_tracy_zone_, __LINE__), name, true); \
+		ECProfileScope EDGE_PROFILE_CONCAT(ec_profile_zone_, __LINE__)(name)
+
 #else
 
 	#define EDGE_ZoneNamed(varname, active)
@@ -67,6 +105,8 @@ extern ECFrameStats ec_frame_stats;
 	#define EDGE_FrameMarkStart(name)
 	#define EDGE_FrameMarkEnd(name)
 
+	#define EDGE_ProfileZone(name) ECProfileScope EDGE_PROFILE_CONCAT(ec_profile_zone_, __LINE__)(name)
+
 #endif
 
 #else
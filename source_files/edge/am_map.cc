@@ -278,6 +278,84 @@ static inline float MapToFrameCoordinatesY(float y, float dy)
     return frame_y + frame_height * 0.5 - MapToFrameDistanceY(y - dy);
 }
 
+//
+// Per-line automap style.  Everything except the height comparisons
+// (which follow moving sectors) only depends on the line flags and type,
+// so it is worked out once and redone when either of those change.
+//
+// The wall geometry itself is not kept: it is rotated, zoomed and panned
+// into HUD space on the CPU every frame and goes out through the render
+// unit path anyway, and colour is a vertex attribute there, so only the
+// line width buckets in DrawAllLines() need separate batches.
+//
+enum AutomapWallKind
+{
+    kAutomapWallOneSided = 0,
+    kAutomapWallKeyedDoor,
+    kAutomapWallSecret,
+    kAutomapWallTwoSided
+};
+
+struct AutomapWallStyle
+{
+    int             flags;
+    const LineType *special;
+    AutomapWallKind kind;
+    RGBAColor       door_color;
+};
+
+static std::vector<AutomapWallStyle> automap_wall_styles;
+
+static void ResetWallStyles(void)
+{
+    automap_wall_styles.resize(total_level_lines);
+
+    for (AutomapWallStyle &style : automap_wall_styles)
+    {
+        style.flags   = -1; // force an update
+        style.special = nullptr;
+    }
+}
+
+static const AutomapWallStyle &GetWallStyle(const Line *line)
+{
+    AutomapWallStyle &style = automap_wall_styles[line - level_lines];
+
+    if (style.flags == line->flags && style.special == line->special)
+        return style;
+
+    style.flags      = line->flags;
+    style.special    = line->special;
+    style.door_color = kRGBAPurple;
+
+    if (!line->front_sector || !line->back_sector)
+        style.kind = kAutomapWallOneSided;
+    // Lobo 2022: give keyed doors the colour of the required key
+    else if (line->special && line->special->keys_)
+    {
+        style.kind = kAutomapWallKeyedDoor;
+
+        DoorKeyType keys = line->special->keys_;
+
+        if (keys & kDoorKeyStrictlyAllKeys)
+            style.door_color = kRGBAPurple;
+        else if (keys & (kDoorKeyBlueSkull | kDoorKeyBlueCard))
+            style.door_color = kRGBABlue;
+        else if (keys & (kDoorKeyYellowSkull | kDoorKeyYellowCard))
+            style.door_color = kRGBAYellow;
+        else if (keys & (kDoorKeyRedSkull | kDoorKeyRedCard))
+            style.door_color = kRGBARed;
+        else if (keys & (kDoorKeyGreenSkull | kDoorKeyGreenCard))
+            style.door_color = kRGBAGreen;
+    }
+    else if (line->flags & kLineFlagSecret)
+        style.kind = kAutomapWallSecret;
+    else
+        style.kind = kAutomapWallTwoSided;
+
+    return style;
+}
+
 //
 // adds a marker at the current location
 //
@@ -344,6 +422,8 @@ void AutomapInitLevel(void)
 
     FindMinMaxBoundaries();
 
+    ResetWallStyles();
+
     // Initial reservation if necessary
     if (map_line_pointers[0].capacity() < kDefaultAutomapLines)
     {
@@ -589,34 +669,79 @@ static inline void Rotate(float &x, float &y, BAMAngle a)
     y = new_y;
 }
 
-static void GetRotatedCoords(float sx, float sy, float &dx, float &dy)
+// rotation used by GetRotatedCoords, computed once per frame
+static float rotate_pivot_x, rotate_pivot_y;
+static float rotate_sin, rotate_cos;
+
+static void SetupRotation(void)
+{
+    BAMAngle ang;
+
+    if (!console_active && !paused && !menu_active)
+    {
+        rotate_pivot_x = frame_lerped_x;
+        rotate_pivot_y = frame_lerped_y;
+        ang            = frame_lerped_ang;
+    }
+    else
+    {
+        rotate_pivot_x = frame_focus->x;
+        rotate_pivot_y = frame_focus->y;
+        ang            = frame_focus->angle_;
+    }
+
+    rotate_sin = epi::BAMSin(kBAMAngle90 - ang);
+    rotate_cos = epi::BAMCos(kBAMAngle90 - ang);
+}
+
+static inline void GetRotatedCoords(float sx, float sy, float &dx, float &dy)
 {
     dx = sx;
     dy = sy;
 
     if (rotate_map)
     {
-        if (!console_active && !paused && !menu_active)
-        {
-            dx -= frame_lerped_x;
-            dy -= frame_lerped_y;
+        float x = sx - rotate_pivot_x;
+        float y = sy - rotate_pivot_y;
 
-            Rotate(dx, dy, kBAMAngle90 - frame_lerped_ang);
+        dx = x * rotate_cos - y * rotate_sin + rotate_pivot_x;
+        dy = x * rotate_sin + y * rotate_cos + rotate_pivot_y;
+    }
+}
 
-            dx += frame_lerped_x;
-            dy += frame_lerped_y;
-        }
-        else
-        {
-            dx -= frame_focus->x;
-            dy -= frame_focus->y;
+// map-space box (before rotation) which covers the visible frame
+static float view_bounding_box[4];
+
+static void ComputeViewBoundingBox(void)
+{
+    float half_w = frame_width * 0.5f / (map_scale * frame_scale * 1.2f);
+    float half_h = frame_height * 0.5f / (map_scale * frame_scale);
 
-            Rotate(dx, dy, kBAMAngle90 - frame_focus->angle_);
+    BoundingBoxClear(view_bounding_box);
 
-            dx += frame_focus->x;
-            dy += frame_focus->y;
+    for (int corner = 0; corner < 4; corner++)
+    {
+        float x = map_center_x + ((corner & 1) ? half_w : -half_w);
+        float y = map_center_y + ((corner & 2) ? half_h : -half_h);
+
+        // undo the rotation
+        if (rotate_map)
+        {
+            float rx = x - rotate_pivot_x;
+            float ry = y - rotate_pivot_y;
+
+            x = rx * rotate_cos + ry * rotate_sin + rotate_pivot_x;
+            y = ry * rotate_cos - rx * rotate_sin + rotate_pivot_y;
         }
+
+        BoundingBoxAddPoint(view_bounding_box, x, y);
     }
+
+    // a little slack for lines lying on the edge
+    view_bounding_box[kBoundingBoxLeft] -= 1.0f;
+    view_bounding_box[kBoundingBoxBottom] -= 1.0f;
+    view_bounding_box[kBoundingBoxRight] += 1.0f;
+    view_bounding_box[kBoundingBoxTop] += 1.0f;
 }
 
 static inline BAMAngle GetRotatedAngle(BAMAngle src)
@@ -816,6 +941,35 @@ static void CollectGridLines()
     }
 }
 
+// returns nullptr when the line is outside the map frame
+static AutomapLine *GetWallMapLine(const Line *line)
+{
+    float ax, ay, bx, by;
+
+    GetRotatedCoords(line->vertex_1->X, line->vertex_1->Y, ax, ay);
+    GetRotatedCoords(line->vertex_2->X, line->vertex_2->Y, bx, by);
+
+    // clip to map frame
+    float x1 = MapToFrameCoordinatesX(ax, map_center_x);
+    float x2 = MapToFrameCoordinatesX(bx, map_center_x);
+    float y1 = MapToFrameCoordinatesY(ay, map_center_y);
+    float y2 = MapToFrameCoordinatesY(by, map_center_y);
+    if ((x1 < frame_x && x2 < frame_x) || (x1 > frame_x + frame_width && x2 > frame_x + frame_width) ||
+        (y1 < frame_y && y2 < frame_y) || (y1 > frame_y + frame_height && y2 > frame_y + frame_height))
+    {
+        return nullptr;
+    }
+
+    AutomapLine *l = GetMapLine();
+
+    l->points.X = ax;
+    l->points.Y = ay;
+    l->points.Z = bx;
+    l->points.W = by;
+
+    return l;
+}
+
 //
 // Determines visible lines, draws them.
 //
@@ -828,80 +982,39 @@ static void AddWall(const Line *line)
         if ((line->flags & kLineFlagDontDraw) && !show_walls)
             return;
 
-        AutomapLine *l = GetMapLine();
-        GetRotatedCoords(line->vertex_1->X, line->vertex_1->Y, l->points.X, l->points.Y);
-        GetRotatedCoords(line->vertex_2->X, line->vertex_2->Y, l->points.Z, l->points.W);
-
-        // clip to map frame
-        float x1 = MapToFrameCoordinatesX(l->points.X, map_center_x);
-        float x2 = MapToFrameCoordinatesX(l->points.Z, map_center_x);
-        float y1 = MapToFrameCoordinatesY(l->points.Y, map_center_y);
-        float y2 = MapToFrameCoordinatesY(l->points.W, map_center_y);
-        if ((x1 < frame_x && x2 < frame_x) || (x1 > frame_x + frame_width && x2 > frame_x + frame_width) ||
-            (y1 < frame_y && y2 < frame_y) || (y1 > frame_y + frame_height && y2 > frame_y + frame_height))
-        {
-            automap_line_position--;
+        const AutomapWallStyle &style = GetWallStyle(line);
+
+        AutomapLine *l = GetWallMapLine(line);
+
+        if (!l)
             return;
-        }
 
-        Sector *front = line->front_sector;
-        Sector *back  = line->back_sector;
+        const Sector *front = line->front_sector;
+        const Sector *back  = line->back_sector;
 
-        if (!front || !back)
+        switch (style.kind)
         {
+        case kAutomapWallOneSided:
             l->color = am_colors[kAutomapColorWall];
             DrawMLine(l);
-        }
-        else
-        {
-            // Lobo 2022: give keyed doors the colour of the required key
-            if (line->special)
-            {
-                if (line->special->keys_)
-                {
-                    if (line->special->keys_ & kDoorKeyStrictlyAllKeys)
-                    {
-                        l->color = kRGBAPurple;
-                        DrawMLineDoor(l); // purple
-                    }
-                    else if (line->special->keys_ & (kDoorKeyBlueSkull | kDoorKeyBlueCard))
-                    {
-                        l->color = kRGBABlue;
-                        DrawMLineDoor(l); // blue
-                    }
-                    else if (line->special->keys_ & (kDoorKeyYellowSkull | kDoorKeyYellowCard))
-                    {
-                        l->color = kRGBAYellow;
-                        DrawMLineDoor(l); // yellow
-                    }
-                    else if (line->special->keys_ & (kDoorKeyRedSkull | kDoorKeyRedCard))
-                    {
-                        l->color = kRGBARed;
-                        DrawMLineDoor(l); // red
-                    }
-                    else if (line->special->keys_ & (kDoorKeyGreenSkull | kDoorKeyGreenCard))
-                    {
-                        l->color = kRGBAGreen;
-                        DrawMLineDoor(l); // green
-                    }
-                    else
-                    {
-                        l->color = kRGBAPurple;
-                        DrawMLineDoor(l); // purple
-                    }
-                    return;
-                }
-            }
-            if (line->flags & kLineFlagSecret)
-            {
-                // secret door
-                if (show_walls)
-                    l->color = am_colors[kAutomapColorSecret];
-                else
-                    l->color = am_colors[kAutomapColorWall];
-                DrawMLine(l);
-            }
-            else if (!AlmostEquals(back->floor_height, front->floor_height))
+            break;
+
+        case kAutomapWallKeyedDoor:
+            l->color = style.door_color;
+            DrawMLineDoor(l);
+            break;
+
+        case kAutomapWallSecret:
+            // secret door
+            if (show_walls)
+                l->color = am_colors[kAutomapColorSecret];
+            else
+                l->color = am_colors[kAutomapColorWall];
+            DrawMLine(l);
+            break;
+
+        case kAutomapWallTwoSided:
+            if (!AlmostEquals(back->floor_height, front->floor_height))
             {
                 float diff = fabs(back->floor_height - front->floor_height);
 
@@ -928,6 +1041,9 @@ static void AddWall(const Line *line)
                 l->color = am_colors[kAutomapColorCeil];
                 DrawMLine(l);
             }
+            else
+                automap_line_position--; // not drawn
+            break;
         }
     }
     else if (frame_focus->player_ &&
@@ -935,26 +1051,26 @@ static void AddWall(const Line *line)
     {
         if (!(line->flags & kLineFlagDontDraw))
         {
-            AutomapLine *l = GetMapLine();
-            GetRotatedCoords(line->vertex_1->X, line->vertex_1->Y, l->points.X, l->points.Y);
-            GetRotatedCoords(line->vertex_2->X, line->vertex_2->Y, l->points.Z, l->points.W);
-            // clip to map frame
-            float x1 = MapToFrameCoordinatesX(l->points.X, map_center_x);
-            float x2 = MapToFrameCoordinatesX(l->points.Z, map_center_x);
-            float y1 = MapToFrameCoordinatesY(l->points.Y, map_center_y);
-            float y2 = MapToFrameCoordinatesY(l->points.W, map_center_y);
-            if ((x1 < frame_x && x2 < frame_x) || (x1 > frame_x + frame_width && x2 > frame_x + frame_width) ||
-                (y1 < frame_y && y2 < frame_y) || (y1 > frame_y + frame_height && y2 > frame_y + frame_height))
-            {
-                automap_line_position--;
+            AutomapLine *l = GetWallMapLine(line);
+
+            if (!l)
                 return;
-            }
+
             l->color = am_colors[kAutomapColorAllmap];
             DrawMLine(l);
         }
     }
 }
 
+static bool AddWallIterator(Line *line, void *data)
+{
+    EPI_UNUSED(data);
+
+    AddWall(line);
+
+    return true;
+}
+
 static void DrawObjectBounds(MapObject *mo, RGBAColor rgb)
 {
     float R = mo->radius_;
@@ -1153,9 +1269,28 @@ static void CollectMapLines()
 {
     if (!hide_lines)
     {
-        for (int i = 0; i < total_level_lines; i++)
+        if ((int)automap_wall_styles.size() != total_level_lines)
+            ResetWallStyles();
+
+        // only visit the blockmap cells under the frame, unless it covers
+        // most of the map anyway
+        float view_w = view_bounding_box[kBoundingBoxRight] - view_bounding_box[kBoundingBoxLeft];
+        float view_h = view_bounding_box[kBoundingBoxTop] - view_bounding_box[kBoundingBoxBottom];
+
+        float view_blocks = (view_w / kBlockmapUnitSize + 1) * (view_h / kBlockmapUnitSize + 1);
+
+        if (view_blocks * 2 < (float)blockmap_width * blockmap_height)
         {
-            AddWall(&level_lines[i]);
+            BlockmapLineIterator(view_bounding_box[kBoundingBoxLeft], view_bounding_box[kBoundingBoxBottom],
+                                 view_bounding_box[kBoundingBoxRight], view_bounding_box[kBoundingBoxTop],
+                                 AddWallIterator);
+        }
+        else
+        {
+            for (int i = 0; i < total_level_lines; i++)
+            {
+                AddWall(&level_lines[i]);
+            }
         }
     }
 
@@ -1262,6 +1397,9 @@ void AutomapRender(float x, float y, float w, float h, MapObject *focus)
     frame_lerped_y   = HMM_Lerp(frame_focus->old_y_, fractional_tic, frame_focus->y);
     frame_lerped_ang = epi::BAMInterpolate(frame_focus->old_angle_, frame_focus->angle_, fractional_tic);
 
+    SetupRotation();
+    ComputeViewBoundingBox();
+
     if (grid && !rotate_map)
         CollectGridLines();
 
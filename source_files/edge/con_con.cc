@@ -34,6 +34,7 @@
 #include "dm_state.h"
 #include "e_input.h"
 #include "e_player.h"
+#include "e_profile.h"
 #include "edge_profiling.h"
 #include "epi.h"
 #include "epi_str_compare.h"
@@ -376,13 +377,11 @@ static RendererVertex *StartText()
     }
     else if (console_font->definition_->type_ == kFontTypeTrueType)
     {
-        const TTFFont *con_font = (TTFFont *)console_font;
-        if ((image_smoothing &&
+        TTFFont *con_font = (TTFFont *)console_font;
+        tex_id            = con_font->Texture(
+            (image_smoothing &&
              con_font->definition_->truetype_smoothing_ == FontDefinition::kTrueTypeSmoothOnDemand) ||
-            con_font->definition_->truetype_smoothing_ == FontDefinition::kTrueTypeSmoothAlways)
-            tex_id = con_font->truetype_smoothed_texture_id_[current_font_size];
-        else
-            tex_id = con_font->truetype_texture_id_[current_font_size];
+            con_font->definition_->truetype_smoothing_ == FontDefinition::kTrueTypeSmoothAlways);
 
         blend = kBlendingAlpha;
     }
@@ -458,9 +457,7 @@ static uint16_t AddText(float x, float y, const char *s, RGBAColor col, Renderer
         {
             if (*(s + 1))
             {
-                x += (float)stbtt_GetGlyphKernAdvance(ttf->truetype_info_, ttf->GetGlyphIndex(*s),
-                                                      ttf->GetGlyphIndex(*(s + 1))) *
-                     ttf->truetype_kerning_scale_[current_font_size] * FNSZ_ratio / pixel_aspect_ratio.f_;
+                x += ttf->Kerning(*s, *(s + 1)) * FNSZ_ratio / pixel_aspect_ratio.f_;
             }
         }
 
@@ -1508,7 +1505,7 @@ void ConsoleShowFPS(void)
 
     if (abs(debug_fps.d_) >= 3)
     {
-        y -= (FNSZ * 4);
+        y -= (FNSZ * 5);
         y -= (FNSZ * 7);
     }
 
@@ -1562,6 +1559,9 @@ void ConsoleShowFPS(void)
         stbsp_sprintf(textbuf, "%i thing", ec_frame_stats.draw_things);
         console_verts += AddText(x, y, textbuf, kRGBAWebGray, console_glvert);
         y -= FNSZ;
+        stbsp_sprintf(textbuf, "%i/%i think", thinkers_run, thinkers_run + thinkers_deferred);
+        console_verts += AddText(x, y, textbuf, kRGBAWebGray, console_glvert);
+        y -= FNSZ;
 
         FrameStats stats;
         render_backend->GetFrameStats(stats);
@@ -1601,6 +1601,58 @@ void ConsoleShowFPS(void)
     FinishUnitBatch();
 }
 
+void ConsoleShowProfile(void)
+{
+    if (!profile_show_frame)
+        return;
+
+    const std::vector<ProfileZoneSummary> &zones = ProfileFrameSummary();
+
+    int shown = HMM_MIN((int)zones.size(), 40);
+
+    StartUnitBatch(false);
+
+    ConsoleSetupFont();
+
+    int x = 0;
+    int y = current_screen_height;
+
+    SolidBox(x, y - FNSZ * (shown + 1) - FNSZ / 2, XMUL * 50, FNSZ * (shown + 1) + FNSZ / 2, kRGBABlack, 0.5);
+
+    RendererVertex *console_glvert = StartText();
+    uint16_t        console_verts  = 0;
+
+    char textbuf[128];
+
+    x += XMUL;
+    y -= FNSZ * (console_font->definition_->type_ == kFontTypeTrueType ? 0.25 : 1.25);
+    stbsp_sprintf(textbuf, "%-36s %6.2f ms", "frame", ProfileFrameMilliseconds());
+    console_verts += AddText(x, y, textbuf, kRGBAWebGray, console_glvert);
+
+    for (int i = 0; i < shown; i++)
+    {
+        const ProfileZoneSummary &zone = zones[i];
+
+        // zones from other threads (BSP, simulation) are tagged with it
+        char name[64];
+        if (zone.thread > 0)
+            stbsp_snprintf(name, sizeof(name), "%*s%s [%d]", HMM_MIN(zone.depth, 8) * 2, "", zone.name, zone.thread);
+        else
+            stbsp_snprintf(name, sizeof(name), "%*s%s", HMM_MIN(zone.depth, 8) * 2, "", zone.name);
+
+        if (zone.calls > 1.05f)
+            stbsp_sprintf(textbuf, "%-36.36s %6.2f ms x%.0f", name, zone.milliseconds, zone.calls);
+        else
+            stbsp_sprintf(textbuf, "%-36.36s %6.2f ms", name, zone.milliseconds);
+
+        y -= FNSZ;
+        console_verts += AddText(x, y, textbuf, kRGBAWebGray, console_glvert);
+    }
+
+    EndRenderUnit(console_verts);
+    FinishUnitBatch();
+}
+
 void ConsoleShowPosition(void)
 {
     if (debug_position.d_ <= 0)
@@ -24,13 +24,19 @@
 #include <stdarg.h>
 #include <string.h>
 
+#include <algorithm>
+#include <unordered_map>
+
 #include "con_var.h"
 #include "ddf_language.h"
 #include "ddf_sfx.h"
 #include "dm_state.h"
 #include "e_input.h"
+#include "e_profile.h"
+#include "edge_profiling.h"
 #include "epi_filesystem.h"
 #include "epi_str_compare.h"
+#include "epi_str_hash.h"
 #include "epi_str_util.h"
 #include "g_game.h"
 #include "i_system.h"
@@ -739,6 +745,42 @@ static int ConsoleCommandMemory(char **argv, int argc)
     return 0;
 }
 
+static int ConsoleCommandStat(char **argv, int argc)
+{
+    if (argc != 2)
+    {
+        LogPrint("Usage: stat frame | none\n");
+        return 1;
+    }
+
+    if (epi::StringCaseCompareASCII(argv[1], "frame") == 0)
+        profile_show_frame = !profile_show_frame;
+    else if (epi::StringCaseCompareASCII(argv[1], "none") == 0)
+        profile_show_frame = false;
+    else
+    {
+        LogPrint("Unknown stat: %s\n", argv[1]);
+        return 1;
+    }
+
+    return 0;
+}
+
+static int ConsoleCommandProfileTrace(char **argv, int argc)
+{
+    if (argc != 2)
+    {
+        LogPrint("Usage: profile_trace <filename.json>\n");
+        return 1;
+    }
+
+    if (!ec_profile_recording.load(std::memory_order_relaxed))
+        LogPrint("Nothing is being recorded, set debug_profile to 1 first.\n");
+
+    ProfileWriteChromeTrace(argv[1]);
+    return 0;
+}
+
 //----------------------------------------------------------------------------
 
 // oh lordy....
@@ -839,15 +881,40 @@ const ConsoleCommand builtin_commands[] = {{"cat", ConsoleCommandType},
                                            {"spawn", ConsoleCommandSpawn},
                                            {"god", ConsoleCommandGodMode},
                                            {"noclip", ConsoleCommandNoClip},
+                                           {"stat", ConsoleCommandStat},
+                                           {"profile_trace", ConsoleCommandProfileTrace},
                                            // end of list
                                            {nullptr, nullptr}};
 
-static int FindCommand(const char *name)
+// case-insensitive hash of the command names, and the commands sorted by
+// name for completion.  Built on first use.
+static std::unordered_multimap<epi::StringHash, int> command_hash;
+static std::vector<int>                              command_array;
+
+static void BuildCommandIndex(void)
 {
     for (int i = 0; builtin_commands[i].name; i++)
     {
-        if (epi::StringCaseCompareASCII(name, builtin_commands[i].name) == 0)
-            return i;
+        command_hash.emplace(epi::StringHash::Create(builtin_commands[i].name), i);
+        command_array.push_back(i);
+    }
+
+    std::sort(command_array.begin(), command_array.end(), [](int A, int B) {
+        return epi::StringCaseCompareASCII(builtin_commands[A].name, builtin_commands[B].name) < 0;
+    });
+}
+
+static int FindCommand(const char *name)
+{
+    if (command_array.empty())
+        BuildCommandIndex();
+
+    auto range = command_hash.equal_range(epi::StringHash::Create(name));
+
+    for (auto iter = range.first; iter != range.second; ++iter)
+    {
+        if (epi::StringCaseCompareASCII(name, builtin_commands[iter->second].name) == 0)
+            return iter->second;
     }
 
     return -1; // not found
@@ -909,12 +976,24 @@ int MatchConsoleCommands(std::vector<const char *> &list, const char *pattern)
 {
     list.clear();
 
-    for (int i = 0; builtin_commands[i].name; i++)
+    if (command_array.empty())
+        BuildCommandIndex();
+
+    auto iter = std::lower_bound(command_array.begin(), command_array.end(), pattern, [](int cmd, const char *pat) {
+        return epi::StringCaseCompareASCII(builtin_commands[cmd].name, pat) < 0;
+    });
+
+    size_t pattern_length = strlen(pattern);
+
+    for (; iter != command_array.end(); ++iter)
     {
-        if (!ConsoleMatchPattern(builtin_commands[i].name, pattern))
-            continue;
+        const char *name = builtin_commands[*iter].name;
+
+        if (pattern_length > 0 && epi::StringCaseCompareMaxASCII(name, pattern, pattern_length) != 0)
+            break;
 
-        list.push_back(builtin_commands[i].name);
+        if (ConsoleMatchPattern(name, pattern))
+            list.push_back(name);
     }
 
     return (int)list.size();
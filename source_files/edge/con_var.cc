@@ -20,10 +20,14 @@
 
 #include <string.h>
 
+#include <algorithm>
+#include <unordered_map>
+
 #include "con_main.h"
 #include "epi.h"
 #include "epi_filesystem.h"
 #include "epi_str_compare.h"
+#include "epi_str_hash.h"
 #include "epi_str_util.h"
 #include "m_argv.h"
 #include "stb_sprintf.h"
@@ -34,6 +38,14 @@
 
 static ConsoleVariable *all_console_variables = nullptr;
 
+// Lookup index over the list, built from it once main is running: a
+// case-insensitive hash of the names, and the variables sorted by name
+// for prefix matching.  A variable added later marks it stale.
+static bool console_variable_index_stale = true;
+
+static std::unordered_multimap<epi::StringHash, ConsoleVariable *> console_variable_hash;
+static std::vector<ConsoleVariable *>                              console_variable_array;
+
 ConsoleVariable::ConsoleVariable(const char *name, const char *def, ConsoleVariableFlag flags,
                                  ConsoleVariableCallback cb, float min, float max)
     : d_(), f_(), s_(def), name_(name), def_(def), flags_(flags), min_(min), max_(max), callback_(cb), modified_(0)
@@ -43,6 +55,8 @@ ConsoleVariable::ConsoleVariable(const char *name, const char *def, ConsoleVaria
     // add this cvar into the list.  it is sorted later.
     next_                 = all_console_variables;
     all_console_variables = this;
+
+    console_variable_index_stale = true;
 }
 
 ConsoleVariable::~ConsoleVariable()
@@ -216,6 +230,17 @@ static ConsoleVariable *MergeSort(ConsoleVariable *list)
 void SortConsoleVariables()
 {
     all_console_variables = MergeSort(all_console_variables);
+
+    console_variable_hash.clear();
+    console_variable_array.clear();
+
+    for (ConsoleVariable *var = all_console_variables; var != nullptr; var = var->next_)
+    {
+        console_variable_hash.emplace(epi::StringHash::Create(var->name_), var);
+        console_variable_array.push_back(var);
+    }
+
+    console_variable_index_stale = false;
 }
 
 void ResetAllConsoleVariables()
@@ -229,10 +254,15 @@ void ResetAllConsoleVariables()
 
 ConsoleVariable *FindConsoleVariable(const char *name)
 {
-    for (ConsoleVariable *var = all_console_variables; var != nullptr; var = var->next_)
+    if (console_variable_index_stale)
+        SortConsoleVariables();
+
+    auto range = console_variable_hash.equal_range(epi::StringHash::Create(name));
+
+    for (auto iter = range.first; iter != range.second; ++iter)
     {
-        if (epi::StringCaseCompareASCII(var->name_, name) == 0)
-            return var;
+        if (epi::StringCaseCompareASCII(iter->second->name_, name) == 0)
+            return iter->second;
     }
 
     return nullptr;
@@ -256,12 +286,25 @@ int MatchConsoleVariables(std::vector<const char *> &list, const char *pattern)
 {
     list.clear();
 
-    for (ConsoleVariable *var = all_console_variables; var != nullptr; var = var->next_)
+    if (console_variable_index_stale)
+        SortConsoleVariables();
+
+    // every name starting with the pattern sorts at or after it, and they
+    // are all together.
+    auto iter = std::lower_bound(console_variable_array.begin(), console_variable_array.end(), pattern,
+                                 [](const ConsoleVariable *var, const char *pat) {
+                                     return epi::StringCaseCompareASCII(var->name_, pat) < 0;
+                                 });
+
+    size_t pattern_length = strlen(pattern);
+
+    for (; iter != console_variable_array.end(); ++iter)
     {
-        if (!ConsoleMatchPattern(var->name_, pattern))
-            continue;
+        if (pattern_length > 0 && epi::StringCaseCompareMaxASCII((*iter)->name_, pattern, pattern_length) != 0)
+            break;
 
-        list.push_back(var->name_);
+        if (ConsoleMatchPattern((*iter)->name_, pattern))
+            list.push_back((*iter)->name_);
     }
 
     return (int)list.size();
@@ -102,13 +102,15 @@ class ConsoleVariable
     void ParseString();
 };
 
-// called by ConsoleInitConsole.
+// called by ConsoleInit; also builds the lookup index.
 void SortConsoleVariables();
 
 // sets all cvars to their default value.
 void ResetAllConsoleVariables();
 
-// look for a CVAR with the given name.
+// look for a CVAR with the given name (case-insensitive).  Variables live
+// for the whole run, so callers which ask often (e.g. scripts) can keep
+// the returned pointer instead of looking it up again.
 ConsoleVariable *FindConsoleVariable(const char *name);
 
 bool ConsoleMatchPattern(const char *name, const char *pat);
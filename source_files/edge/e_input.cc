@@ -42,10 +42,12 @@
 #include "epi_str_util.h"
 #include "hu_stuff.h"
 #include "i_movie.h"
+#include "i_system.h"
 #include "m_math.h"
 #include "m_misc.h"
 #include "r_misc.h"
 #include "stb_sprintf.h"
+#include "thread.h"
 
 extern bool ConsoleResponder(InputEvent *ev);
 extern bool MenuResponder(InputEvent *ev);
@@ -65,6 +67,24 @@ static InputEvent events[kMaximumInputEvents];
 static int        event_head;
 static int        event_tail;
 
+//
+// Events from the host application (e.g. Godot) arrive through a lock-free
+// single producer / single consumer ring, so they can be pushed from any
+// one thread.  Each carries a GetMilliseconds() timestamp which lets
+// NetworkUpdate() hand them to the tic they happened in.
+//
+static constexpr int kInputEventRingSize = 256; // must be a power of two
+
+struct TimedInputEvent
+{
+    InputEvent event;
+    uint32_t   time;
+};
+
+static TimedInputEvent     event_ring[kInputEventRingSize];
+static thread_atomic_int_t event_ring_head; // written by the producer
+static thread_atomic_int_t event_ring_tail; // written by the consumer
+
 //
 // controls (have defaults)
 //
@@ -677,6 +697,60 @@ void PostEvent(InputEvent *ev)
 #endif
 }
 
+//
+// Called by the host, from a single thread, when input is detected.
+// Returns false if the ring is full and the event was dropped.
+//
+bool QueueInputEvent(const InputEvent *ev, uint32_t time)
+{
+    int head = thread_atomic_int_load(&event_ring_head);
+    int tail = thread_atomic_int_load(&event_ring_tail);
+
+    if (head - tail >= kInputEventRingSize)
+        return false;
+
+    TimedInputEvent &slot = event_ring[head & (kInputEventRingSize - 1)];
+
+    slot.event = *ev;
+    slot.time  = time;
+
+    // publish the slot only once it has been filled in
+    thread_atomic_int_store(&event_ring_head, head + 1);
+
+    return true;
+}
+
+//
+// True when the host has queued events which have not been taken yet.
+//
+bool HaveQueuedInputEvents(void)
+{
+    return thread_atomic_int_load(&event_ring_head) != thread_atomic_int_load(&event_ring_tail);
+}
+
+//
+// Moves the queued host events which happened at or before the given
+// tic (in GetTime() units) into the event queue.
+//
+void TakeQueuedInputEvents(int up_to_tic)
+{
+    int head = thread_atomic_int_load(&event_ring_head);
+    int tail = thread_atomic_int_load(&event_ring_tail);
+
+    for (; tail != head; tail++)
+    {
+        const TimedInputEvent &slot = event_ring[tail & (kInputEventRingSize - 1)];
+
+        if (TicsFromMilliseconds(slot.time) > up_to_tic)
+            break;
+
+        InputEvent ev = slot.event;
+        PostEvent(&ev);
+    }
+
+    thread_atomic_int_store(&event_ring_tail, tail);
+}
+
 //
 // Send all the events of the given timestamp down the responder chain
 //
@@ -37,6 +37,10 @@ void UpdateKeyState(void);
 void ProcessInputEvents(void);
 void PostEvent(InputEvent *ev);
 
+bool QueueInputEvent(const InputEvent *ev, uint32_t time);
+bool HaveQueuedInputEvents(void);
+void TakeQueuedInputEvents(int up_to_tic);
+
 bool IsKeyPressed(int keyvar);
 bool CheckKeyMatch(int keyvar, int key);
 
@@ -48,6 +48,7 @@
 #include "dm_state.h"
 #include "dstrings.h"
 #include "e_input.h"
+#include "e_profile.h"
 #include "edge_profiling.h"
 #include "epi_file.h"
 #include "epi_filesystem.h"
@@ -63,6 +64,7 @@
 #include "i_movie.h"
 #include "i_sound.h"
 #include "i_system.h"
+#include "im_data.h"
 #include "m_argv.h"
 #include "m_bbox.h"
 #include "m_cheat.h"
@@ -74,6 +76,7 @@
 #include "p_spec.h"
 #include "platform/gd_platform.h"
 #include "r_backend.h"
+#include "r_benchmark.h"
 #include "r_colormap.h"
 #include "r_draw.h"
 #include "r_gldefs.h"
@@ -531,6 +534,8 @@ static void ShowNotice(void)
 static void DoSystemStartup(void)
 {
     // startup the system now
+    ImageDataSelfCheck();
+    SoundOutputSelfCheck();
     InitializeImages();
 
     LogDebug("- System startup begun.\n");
@@ -598,11 +603,15 @@ static bool wipe_gl_active = false;
 
 void EdgeDisplay(void)
 {
-    EDGE_ZoneScoped;
+    EDGE_ProfileZone("EdgeDisplay");
+
+    ProfileFrameMark();
 
     // Start the frame - should we need to.
     StartFrame();
 
+    ProcessImageUploads();
+
     HUDFrameSetup();
 
     bool draw_menu = true;
@@ -622,11 +631,11 @@ void EdgeDisplay(void)
                 need_save_screenshot = false;
             }
             {
-                EDGE_ZoneNamedN(ZoneHUDDrawer, "HUDDrawer", true);
+                EDGE_ProfileZone("HUDDrawer");
                 HUDDrawer();
             }
             {
-                EDGE_ZoneNamedN(ZoneScriptDrawer, "ScriptDrawer", true);
+                EDGE_ProfileZone("ScriptDrawer");
                 ScriptDrawer();
             }
             break;
@@ -648,7 +657,7 @@ void EdgeDisplay(void)
         }
 
         {
-            EDGE_ZoneNamedN(ZoneWipe, "Wipe", true);
+            EDGE_ProfileZone("Wipe");
 
             if (wipe_gl_active)
             {
@@ -675,7 +684,7 @@ void EdgeDisplay(void)
             DisplayPauseImage();
 
         {
-            EDGE_ZoneNamedN(ZoneDrawMenu, "DrawMenu", true);
+            EDGE_ProfileZone("DrawMenu");
 
             // menus go directly to the screen
             if (draw_menu)
@@ -686,25 +695,27 @@ void EdgeDisplay(void)
     }
     else
     {
-        EDGE_ZoneNamedN(ZoneMovieDrawer, "MovieDrawer", true);
+        EDGE_ProfileZone("MovieDrawer");
         MovieDrawer();
     }
 
     // process mouse and keyboard events
     {
-        EDGE_ZoneNamedN(ZoneNetworkUpdate, "NetworkUpdate", true);
+        EDGE_ProfileZone("NetworkUpdate");
         NetworkUpdate();
     }
 
     {
-        EDGE_ZoneNamedN(ZoneConsoleDraw, "ConsoleDraw", true);
+        EDGE_ProfileZone("ConsoleDraw");
 
         if (!playing_movie)
             ConsoleDrawer();
+
+        ConsoleShowProfile();
     }
 
     {
-        EDGE_ZoneNamedN(ZoneHudOverlays, "HudOverlays", true);
+        EDGE_ProfileZone("HudOverlays");
         if (!need_wipe && epi::StringCompare(video_overlay.s_, "None") != 0)
         {
             ImageData   *ov_data = available_overlays[video_overlay.s_].first;
@@ -1779,6 +1790,8 @@ static void InitializeDDF(void)
 
 void EdgeShutdown(void)
 {
+    ProfileShutdown();
+
     StopMusic();
     StopAllSoundEffects();
     LevelShutdown();
@@ -1851,6 +1864,8 @@ static void EdgeStartup(void)
 
     ShowDateAndVersion();
 
+    ProfileStartup();
+
     LoadDefaults();
 
     HandleProgramArguments();
@@ -2083,10 +2098,12 @@ void EdgeIdle(void)
 //
 void EdgeTicker(void)
 {
-    EDGE_ZoneScoped;
+    EDGE_ProfileZone("EdgeTicker");
 
     DoBigGameStuff();
 
+    RenderBenchmarkTicker();
+
     // Update display, next frame, with current state.
     EdgeDisplay();
 
@@ -2109,6 +2126,58 @@ void EdgeTicker(void)
         // process mouse and keyboard events
         NetworkUpdate();
     }
+
+    // top up the output ring when there is no sound device (-nosounddevice)
+    PumpSoundOutput();
+}
+
+//
+// Hosts which run the game simulation on its own thread (see the Godot
+// platform) call EdgeSimulate() from that thread and EdgePresent() from
+// the one owning the render backend, never both at once.  Everything
+// which can touch the render backend (level loading and precaching, the
+// movie decoder, drawing) is kept in EdgePresent().
+//
+static int pending_movie_tics = 0;
+
+void EdgeSimulate(void)
+{
+    EDGE_ProfileZone("EdgeSimulate");
+
+    // this also runs the responder chain via ProcessInputEvents
+    int counts = TryRunTicCommands();
+
+    // run the tics
+    for (; counts > 0; counts--)
+    {
+        // run a step in the physics (etc)
+        GameTicker();
+
+        // user interface stuff (skull anim, etc)
+        pending_movie_tics++;
+        ConsoleTicker();
+        MenuTicker();
+        SoundTicker();
+        MusicTicker();
+
+        // process mouse and keyboard events
+        NetworkUpdate();
+    }
+}
+
+void EdgePresent(void)
+{
+    EDGE_ProfileZone("EdgePresent");
+
+    DoBigGameStuff();
+
+    RenderBenchmarkTicker();
+
+    for (; pending_movie_tics > 0; pending_movie_tics--)
+        MovieTicker();
+
+    // Update display, next frame, with current state.
+    EdgeDisplay();
 }
 
 //--- editor settings ---
@@ -30,6 +30,8 @@
 void EdgeMain(int argc, const char **argv);
 void EdgeIdle(void);
 void EdgeTicker(void);
+void EdgeSimulate(void);
+void EdgePresent(void);
 void EdgeDisplay(void);
 void EdgeShutdown(void);
 
@@ -0,0 +1,530 @@
+//----------------------------------------------------------------------------
+//  EDGE Built-in Profiler
+//----------------------------------------------------------------------------
+//
+//  Copyright (c) 2024 The EDGE Team.
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//----------------------------------------------------------------------------
+//
+//  A small scoped timer system which works without Tracy.  Every thread
+//  which enters an EDGE_ProfileZone gets its own ring of finished zones,
+//  so recording never takes a lock.  The main thread reads the rings once
+//  per frame to build the `stat frame` overlay, and the whole lot can be
+//  written out as a Chrome trace, e.g. from a headless (null platform)
+//  run with `-profile trace.json`.
+//
+//  Readers don't stop the writers: an event being overwritten while it is
+//  read just shows up with odd times.  That is fine for a diagnostic.
+//
+//  With `-profile` the rings are copied into growing per-thread lists at
+//  every frame mark, so the trace covers the whole run rather than just
+//  the last kProfileRingSize zones of each thread.
+//
+//----------------------------------------------------------------------------
+
+#include "e_profile.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <chrono>
+
+#include "edge_profiling.h"
+#include "epi.h"
+#include "epi_filesystem.h"
+#include "i_system.h"
+#include "m_argv.h"
+#include "thread.h"
+
+EDGE_DEFINE_CONSOLE_VARIABLE(debug_profile, "0", kConsoleVariableFlagNone)
+
+std::atomic<bool> ec_profile_recording(false);
+
+bool profile_show_frame = false;
+
+static constexpr uint32_t kProfileRingSize      = (1 << 15); // per thread, must be a power of two
+static constexpr int      kProfileStackSize     = 32;
+static constexpr uint32_t kProfileFrameRingSize = 1024;
+static constexpr int64_t  kProfileReportPeriod  = 500000000; // nanoseconds
+
+struct ProfileEvent
+{
+    const char *name;
+    int64_t     start;
+    int64_t     end;
+    int         depth;
+};
+
+struct ProfileThread
+{
+    int id;
+
+    ProfileEvent          ring[kProfileRingSize];
+    std::atomic<uint32_t> head;
+
+    // set when the owning thread exits, so the next new thread reuses it
+    std::atomic<bool> retired;
+
+    // zones which have been entered but not left yet
+    const char *stack_name[kProfileStackSize];
+    int64_t     stack_start[kProfileStackSize];
+    int         depth;
+
+    // with -profile: everything up to `spilled` has been copied into
+    // `spill` (both only used under profile_threads_mutex)
+    uint32_t                  spilled = 0;
+    std::vector<ProfileEvent> spill;
+};
+
+struct ProfileFrame
+{
+    int64_t      time;
+    ECFrameStats stats;
+};
+
+static bool profile_started = false;
+
+static std::chrono::steady_clock::time_point profile_epoch;
+
+static thread_mutex_t               profile_threads_mutex;
+static std::vector<ProfileThread *> profile_threads;
+
+struct ProfileThreadOwner
+{
+    ProfileThread *thread = nullptr;
+
+    ~ProfileThreadOwner()
+    {
+        if (thread)
+            thread->retired.store(true, std::memory_order_release);
+    }
+};
+
+static thread_local ProfileThreadOwner profile_this_thread;
+
+// frame marks, written by the thread which calls ProfileFrameMark while
+// holding profile_threads_mutex (so a trace sees them with the zones)
+static ProfileFrame profile_frames[kProfileFrameRingSize];
+static uint32_t     profile_frame_head = 0;
+static int64_t      profile_last_mark  = 0;
+
+// with -profile: every frame mark, and zones lost to a ring wrapping
+// between two frame marks
+static std::vector<ProfileFrame> profile_spilled_frames;
+static uint32_t                  profile_dropped_zones = 0;
+
+// `stat frame` accumulation, published every kProfileReportPeriod
+static std::vector<ProfileEvent>       profile_scratch;
+static std::vector<ProfileZoneSummary> profile_accumulated;
+static std::vector<ProfileZoneSummary> profile_summary;
+static int64_t                         profile_accumulated_time   = 0;
+static int                             profile_accumulated_frames = 0;
+static float                           profile_frame_milliseconds = 0;
+
+static std::string profile_trace_filename;
+
+static inline int64_t ProfileNow(void)
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - profile_epoch)
+        .count();
+}
+
+static ProfileThread *ProfileRegisterThread(void)
+{
+    ProfileThread *pt = nullptr;
+
+    thread_mutex_lock(&profile_threads_mutex);
+
+    for (ProfileThread *old : profile_threads)
+    {
+        if (old->retired.load(std::memory_order_acquire))
+        {
+            pt = old;
+            break;
+        }
+    }
+
+    if (pt == nullptr)
+    {
+        pt = new ProfileThread;
+
+        pt->id = (int)profile_threads.size();
+        pt->head.store(0, std::memory_order_relaxed);
+        profile_threads.push_back(pt);
+    }
+
+    pt->retired.store(false, std::memory_order_relaxed);
+    pt->depth = 0;
+
+    thread_mutex_unlock(&profile_threads_mutex);
+
+    profile_this_thread.thread = pt;
+    return pt;
+}
+
+void ECProfileBegin(const char *name)
+{
+    ProfileThread *pt = profile_this_thread.thread;
+
+    if (pt == nullptr)
+        pt = ProfileRegisterThread();
+
+    if (pt->depth < kProfileStackSize)
+    {
+        pt->stack_name[pt->depth]  = name;
+        pt->stack_start[pt->depth] = ProfileNow();
+    }
+
+    pt->depth++;
+}
+
+void ECProfileEnd()
+{
+    ProfileThread *pt = profile_this_thread.thread;
+
+    if (pt == nullptr || pt->depth == 0)
+        return;
+
+    pt->depth--;
+
+    if (pt->depth >= kProfileStackSize)
+        return;
+
+    uint32_t head = pt->head.load(std::memory_order_relaxed);
+
+    ProfileEvent &ev = pt->ring[head & (kProfileRingSize - 1)];
+
+    ev.name  = pt->stack_name[pt->depth];
+    ev.start = pt->stack_start[pt->depth];
+    ev.end   = ProfileNow();
+    ev.depth = pt->depth;
+
+    pt->head.store(head + 1, std::memory_order_release);
+}
+
+void ProfileStartup(void)
+{
+    profile_epoch = std::chrono::steady_clock::now();
+
+    thread_mutex_init(&profile_threads_mutex);
+
+    profile_started = true;
+
+    // make the calling thread the first one in the trace
+    ProfileRegisterThread();
+
+    profile_trace_filename = ArgumentValue("profile");
+
+    if (!profile_trace_filename.empty())
+    {
+        LogPrint("Profiling to %s\n", profile_trace_filename.c_str());
+        ec_profile_recording.store(true, std::memory_order_relaxed);
+    }
+}
+
+void ProfileShutdown(void)
+{
+    if (!profile_started)
+        return;
+
+    ec_profile_recording.store(false, std::memory_order_relaxed);
+
+    if (!profile_trace_filename.empty())
+        ProfileWriteChromeTrace(profile_trace_filename);
+}
+
+static void ProfileAccumulate(std::vector<ProfileZoneSummary> &zones, const ProfileEvent &ev, int thread)
+{
+    float ms = (float)(ev.end - ev.start) / 1000000.0f;
+
+    for (ProfileZoneSummary &zone : zones)
+    {
+        if (zone.depth == ev.depth && zone.thread == thread && strcmp(zone.name, ev.name) == 0)
+        {
+            zone.milliseconds += ms;
+            zone.calls += 1;
+            return;
+        }
+    }
+
+    zones.push_back({ev.name, ev.depth, thread, ms, 1});
+}
+
+int64_t ProfileTime(void)
+{
+    return ProfileNow();
+}
+
+//
+// Within a thread the zones are sorted by start time so that parents come
+// before their children, which is all the overlay needs to indent them.
+//
+void ProfileGatherZones(int64_t from, int64_t to, std::vector<ProfileZoneSummary> &zones)
+{
+    if (!profile_started)
+        return;
+
+    thread_mutex_lock(&profile_threads_mutex);
+
+    for (ProfileThread *pt : profile_threads)
+    {
+        profile_scratch.clear();
+
+        uint32_t head  = pt->head.load(std::memory_order_acquire);
+        uint32_t count = std::min(head, kProfileRingSize);
+
+        for (uint32_t i = 1; i <= count; i++)
+        {
+            const ProfileEvent &ev = pt->ring[(head - i) & (kProfileRingSize - 1)];
+
+            // events are stored in the order they ended
+            if (ev.end < from)
+                break;
+
+            if (ev.end < to)
+                profile_scratch.push_back(ev);
+        }
+
+        std::sort(profile_scratch.begin(), profile_scratch.end(), [](const ProfileEvent &A, const ProfileEvent &B) {
+            if (A.start != B.start)
+                return A.start < B.start;
+            return A.depth < B.depth;
+        });
+
+        for (const ProfileEvent &ev : profile_scratch)
+            ProfileAccumulate(zones, ev, pt->id);
+    }
+
+    thread_mutex_unlock(&profile_threads_mutex);
+}
+
+// copies the zones finished since the last call out of the rings, must
+// hold profile_threads_mutex.
+static void ProfileSpillRings(void)
+{
+    for (ProfileThread *pt : profile_threads)
+    {
+        uint32_t head  = pt->head.load(std::memory_order_acquire);
+        uint32_t first = pt->spilled;
+
+        if (head - first > kProfileRingSize)
+        {
+            profile_dropped_zones += head - first - kProfileRingSize;
+            first = head - kProfileRingSize;
+        }
+
+        for (uint32_t i = first; i != head; i++)
+            pt->spill.push_back(pt->ring[i & (kProfileRingSize - 1)]);
+
+        pt->spilled = head;
+    }
+}
+
+void ProfileFrameMark(void)
+{
+    if (!profile_started)
+        return;
+
+    int64_t now = ProfileNow();
+
+    bool recording = debug_profile.d_ != 0 || profile_show_frame || !profile_trace_filename.empty();
+
+    if (ec_profile_recording.load(std::memory_order_relaxed))
+    {
+        thread_mutex_lock(&profile_threads_mutex);
+
+        ProfileFrame &frame = profile_frames[profile_frame_head & (kProfileFrameRingSize - 1)];
+
+        frame.time  = now;
+        frame.stats = ec_frame_stats;
+
+        profile_frame_head++;
+
+        if (!profile_trace_filename.empty())
+        {
+            profile_spilled_frames.push_back(frame);
+            ProfileSpillRings();
+        }
+
+        thread_mutex_unlock(&profile_threads_mutex);
+
+        if (profile_show_frame && profile_last_mark > 0)
+        {
+            ProfileGatherZones(profile_last_mark, now, profile_accumulated);
+
+            profile_accumulated_time += now - profile_last_mark;
+            profile_accumulated_frames++;
+
+            if (profile_accumulated_time >= kProfileReportPeriod)
+            {
+                float frames = (float)profile_accumulated_frames;
+
+                for (ProfileZoneSummary &zone : profile_accumulated)
+                {
+                    zone.milliseconds /= frames;
+                    zone.calls /= frames;
+                }
+
+                profile_summary.swap(profile_accumulated);
+                profile_accumulated.clear();
+
+                profile_frame_milliseconds = (float)profile_accumulated_time / 1000000.0f / frames;
+
+                profile_accumulated_time   = 0;
+                profile_accumulated_frames = 0;
+            }
+        }
+    }
+
+    // the platforms don't all reset the counters, so do it here
+    ec_frame_stats.Clear();
+
+    profile_last_mark = recording ? now : 0;
+
+    ec_profile_recording.store(recording, std::memory_order_relaxed);
+}
+
+float ProfileFrameMilliseconds(void)
+{
+    return profile_frame_milliseconds;
+}
+
+const std::vector<ProfileZoneSummary> &ProfileFrameSummary(void)
+{
+    return profile_summary;
+}
+
+static inline double ProfileMicroseconds(int64_t nanoseconds)
+{
+    return (double)nanoseconds / 1000.0;
+}
+
+// writes the string in quotes, escaped as JSON needs
+static void ProfileWriteString(FILE *fp, const char *s)
+{
+    fputc('"', fp);
+
+    for (; *s; s++)
+    {
+        unsigned char ch = (unsigned char)*s;
+
+        if (ch == '"' || ch == '\\')
+            fprintf(fp, "\\%c", ch);
+        else if (ch < 0x20)
+            fprintf(fp, "\\u%04x", ch);
+        else
+            fputc(ch, fp);
+    }
+
+    fputc('"', fp);
+}
+
+static void ProfileWriteEvent(FILE *fp, const ProfileEvent &ev, int thread)
+{
+    fprintf(fp, "{\"name\":");
+    ProfileWriteString(fp, ev.name);
+    fprintf(fp, ",\"cat\":\"edge\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%d},\n",
+            ProfileMicroseconds(ev.start), ProfileMicroseconds(ev.end - ev.start), thread);
+}
+
+bool ProfileWriteChromeTrace(const std::string &filename)
+{
+    if (!profile_started)
+        return false;
+
+    FILE *fp = epi::FileOpenRaw(filename, epi::kFileAccessWrite);
+
+    if (fp == nullptr)
+    {
+        LogWarning("Unable to write profile trace: %s\n", filename.c_str());
+        return false;
+    }
+
+    fprintf(fp, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n");
+
+    int total = 0;
+
+    std::vector<ProfileFrame> frames;
+
+    thread_mutex_lock(&profile_threads_mutex);
+
+    for (ProfileThread *pt : profile_threads)
+    {
+        char thread_name[64];
+
+        if (pt->id == 0)
+            snprintf(thread_name, sizeof(thread_name), "Main");
+        else
+            snprintf(thread_name, sizeof(thread_name), "Thread %d", pt->id);
+
+        fprintf(fp, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":", pt->id);
+        ProfileWriteString(fp, thread_name);
+        fprintf(fp, "}},\n");
+
+        // whatever was spilled, then what is still only in the ring
+        for (const ProfileEvent &ev : pt->spill)
+        {
+            ProfileWriteEvent(fp, ev, pt->id);
+            total++;
+        }
+
+        uint32_t head  = pt->head.load(std::memory_order_acquire);
+        uint32_t count = std::min(head - pt->spilled, kProfileRingSize);
+
+        for (uint32_t i = head - count; i != head; i++)
+        {
+            ProfileWriteEvent(fp, pt->ring[i & (kProfileRingSize - 1)], pt->id);
+            total++;
+        }
+    }
+
+    if (!profile_spilled_frames.empty())
+    {
+        frames = profile_spilled_frames;
+    }
+    else
+    {
+        uint32_t frame_count = std::min(profile_frame_head, kProfileFrameRingSize);
+
+        for (uint32_t i = profile_frame_head - frame_count; i != profile_frame_head; i++)
+            frames.push_back(profile_frames[i & (kProfileFrameRingSize - 1)]);
+    }
+
+    uint32_t dropped = profile_dropped_zones;
+
+    thread_mutex_unlock(&profile_threads_mutex);
+
+    for (const ProfileFrame &frame : frames)
+    {
+        fprintf(fp,
+                "{\"name\":\"frame_stats\",\"ph\":\"C\",\"ts\":%.3f,\"pid\":1,\"args\":{\"render_units\":%d,"
+                "\"wall_parts\":%d,\"planes\":%d,\"things\":%d}},\n",
+                ProfileMicroseconds(frame.time), frame.stats.draw_render_units, frame.stats.draw_wall_parts,
+                frame.stats.draw_planes, frame.stats.draw_things);
+    }
+
+    // a closing event saves fussing over the trailing comma
+    fprintf(fp, "{\"name\":\"end\",\"ph\":\"i\",\"s\":\"g\",\"ts\":%.3f,\"pid\":1,\"tid\":0}\n]}\n",
+            ProfileMicroseconds(ProfileNow()));
+
+    fclose(fp);
+
+    LogPrint("Wrote %d profile zones to %s\n", total, filename.c_str());
+
+    if (dropped > 0)
+        LogWarning("Profile trace is missing %u zones (a thread overran its ring within one frame)\n", dropped);
+    return true;
+}
+
+//--- editor settings ---
+// vi:ts=4:sw=4:noexpandtab
@@ -0,0 +1,63 @@
+//----------------------------------------------------------------------------
+//  EDGE Built-in Profiler
+//----------------------------------------------------------------------------
+//
+//  Copyright (c) 2024 The EDGE Team.
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//----------------------------------------------------------------------------
+
+#pragma once
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "con_var.h"
+
+// One line of the `stat frame` overlay: a zone averaged over the last
+// reporting period.  Zones are listed parent first, children indented
+// by their depth.
+struct ProfileZoneSummary
+{
+    const char *name;
+    int         depth;
+    int         thread;
+    float       milliseconds;
+    float       calls;
+};
+
+extern ConsoleVariable debug_profile;
+
+extern bool profile_show_frame;
+
+void ProfileStartup(void);
+void ProfileShutdown(void);
+
+// Called once per displayed frame from the thread which runs EdgeDisplay.
+void ProfileFrameMark(void);
+
+// Profiler clock in nanoseconds.  ProfileGatherZones adds up the zones
+// of every thread which finished between two readings of it.
+int64_t ProfileTime(void);
+void    ProfileGatherZones(int64_t from, int64_t to, std::vector<ProfileZoneSummary> &zones);
+
+float                                  ProfileFrameMilliseconds(void);
+const std::vector<ProfileZoneSummary> &ProfileFrameSummary(void);
+
+// Writes everything still held in the per-thread rings as a Chrome trace
+// (chrome://tracing, Perfetto).  Returns false if the file can't be made.
+bool ProfileWriteChromeTrace(const std::string &filename);
+
+//--- editor settings ---
+// vi:ts=4:sw=4:noexpandtab
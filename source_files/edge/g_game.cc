@@ -36,6 +36,7 @@
 #include "dstrings.h"
 #include "e_input.h"
 #include "e_main.h"
+#include "edge_profiling.h"
 #include "epi_endian.h"
 #include "epi_filesystem.h"
 #include "epi_str_compare.h"
@@ -455,6 +456,8 @@ void DoBigGameStuff(void)
 
 void GameTicker(void)
 {
+    EDGE_ProfileZone("GameTicker");
+
     if (playing_movie)
         return;
 
@@ -19,6 +19,7 @@
 #include "hu_draw.h"
 
 #include <map>
+#include <vector>
 
 #include "am_map.h"
 #include "con_main.h"
@@ -50,6 +51,10 @@ extern ConsoleVariable video_overlay;
 
 static Font *default_font;
 
+EDGE_DEFINE_CONSOLE_VARIABLE(renderer_world_view_targets, "1", kConsoleVariableFlagArchive)
+EDGE_DEFINE_CONSOLE_VARIABLE_CLAMPED(renderer_world_view_interval, "1", kConsoleVariableFlagArchive, 1, 35)
+EDGE_DEFINE_CONSOLE_VARIABLE_CLAMPED(renderer_world_view_scale, "1.0", kConsoleVariableFlagArchive, 0.25f, 1.0f)
+
 extern int game_tic;
 int        hud_tic;
 
@@ -477,14 +482,12 @@ void HUDRawImage(float hx1, float hy1, float hx2, float hy2, const Image *image,
 
         if (current_font->definition_->type_ == kFontTypeTrueType)
         {
-            const TTFFont *cur_font = (const TTFFont *)current_font;
-            blend                   = kBlendingAlpha;
-            if ((image_smoothing &&
+            TTFFont *cur_font = (TTFFont *)current_font;
+            blend             = kBlendingAlpha;
+            tex_id            = cur_font->Texture(
+                (image_smoothing &&
                  cur_font->definition_->truetype_smoothing_ == FontDefinition::kTrueTypeSmoothOnDemand) ||
-                cur_font->definition_->truetype_smoothing_ == FontDefinition::kTrueTypeSmoothAlways)
-                tex_id = cur_font->truetype_smoothed_texture_id_[current_font_size];
-            else
-                tex_id = cur_font->truetype_texture_id_[current_font_size];
+                cur_font->definition_->truetype_smoothing_ == FontDefinition::kTrueTypeSmoothAlways);
         }
         else // patch font
         {
@@ -536,7 +539,11 @@ void HUDRawImage(float hx1, float hy1, float hx2, float hy2, const Image *image,
         return;
     }
 
-    tex_id = ImageCache(image, true, nullptr, do_whiten);
+    // scrolling needs the image's own texture (for wrapping)
+    if (do_whiten || sx != 0.0 || sy != 0.0)
+        tex_id = ImageCache(image, true, nullptr, do_whiten);
+    else
+        tex_id = ImageCacheAtlas(image, true, &tx1, &ty1, &tx2, &ty2);
 
     if (alpha >= 0.99f && image->opacity_ == kOpacitySolid)
         blend = kBlendingNone;
@@ -1205,9 +1212,7 @@ void HUDDrawText(float x, float y, const char *str, float size)
                 total_w += cur_font->CharWidth(str[i]) * factor * current_scale;
                 if (str[i + 1])
                 {
-                    total_w += stbtt_GetGlyphKernAdvance(cur_font->truetype_info_, cur_font->GetGlyphIndex(str[i]),
-                                                         cur_font->GetGlyphIndex(str[i + 1])) *
-                               cur_font->truetype_kerning_scale_[current_font_size] * factor * current_scale;
+                    total_w += cur_font->Kerning(str[i], str[i + 1]) * factor * current_scale;
                 }
             }
         }
@@ -1272,9 +1277,7 @@ void HUDDrawText(float x, float y, const char *str, float size)
                 cx += cur_font->CharWidth(ch) * factor * current_scale;
                 if (str[k + 1])
                 {
-                    cx += stbtt_GetGlyphKernAdvance(cur_font->truetype_info_, cur_font->GetGlyphIndex(str[k]),
-                                                    cur_font->GetGlyphIndex(str[k + 1])) *
-                          cur_font->truetype_kerning_scale_[current_font_size] * factor * current_scale;
+                    cx += cur_font->Kerning(str[k], str[k + 1]) * factor * current_scale;
                 }
             }
         }
@@ -1441,10 +1444,108 @@ void HUDDrawQuitScreen()
     }
 }
 
-void HUDRenderWorld(float x, float y, float w, float h, MapObject *camera, int flags)
+// Extra camera views (security monitors and the like) are drawn into an
+// offscreen target and shown from there.  The target is only drawn again
+// when the camera has moved or something in the subsectors it showed has
+// changed, checked at most once every renderer_world_view_interval tics.
+struct WorldView
 {
-    render_backend->BeginWorldRender();
+    bool valid;
+
+    MapObject *camera;
+    int        rect[4];
+
+    int     width;
+    int     height;
+    int64_t last_frame;
+    int     rendered_tic;
+    int     checked_tic;
+
+    Position camera_position;
+    BAMAngle camera_angle;
+    BAMAngle camera_vertical_angle;
+    float    expand_w;
+
+    std::vector<Subsector *> subsectors;
+    uint64_t                 state_hash;
+};
+
+static WorldView world_views[kRenderWorldTargetMax];
+
+void HUDClearWorldViews(void)
+{
+    for (WorldView &view : world_views)
+    {
+        view.valid      = false;
+        view.camera     = nullptr;
+        view.last_frame = 0;
+        view.subsectors.clear();
+    }
+}
+
+// Finds the view showing this camera in this screen rectangle, else takes
+// over the one unused the longest.  Returns nullptr if they're all in use
+// this frame.
+static WorldView *FindWorldView(MapObject *camera, const int *rect)
+{
+    int64_t frame = render_backend->GetFrameNumber();
+
+    WorldView *oldest = nullptr;
+
+    for (WorldView &view : world_views)
+    {
+        if (view.valid && view.camera == camera && !memcmp(view.rect, rect, sizeof(view.rect)))
+        {
+            view.last_frame = frame;
+            return &view;
+        }
+
+        if (view.last_frame != frame && (!oldest || view.last_frame < oldest->last_frame))
+            oldest = &view;
+    }
+
+    if (oldest)
+    {
+        oldest->valid      = false;
+        oldest->camera     = camera;
+        oldest->last_frame = frame;
+        memcpy(oldest->rect, rect, sizeof(oldest->rect));
+    }
+
+    return oldest;
+}
 
+static bool WorldViewChanged(WorldView *view, MapObject *camera, int width, int height, float expand_w)
+{
+    if (!view->valid || view->width != width || view->height != height || view->expand_w != expand_w)
+        return true;
+
+    if (game_tic - view->rendered_tic < renderer_world_view_interval.d_ || game_tic == view->checked_tic)
+        return false;
+
+    view->checked_tic = game_tic;
+
+    if (view->camera_position.x != camera->x || view->camera_position.y != camera->y ||
+        view->camera_position.z != camera->z || view->camera_angle != camera->angle_ ||
+        view->camera_vertical_angle != camera->vertical_angle_)
+        return true;
+
+    return SubsectorStateHash(view->subsectors) != view->state_hash;
+}
+
+static void DrawWorldView(WorldView *view)
+{
+    bool     upside_down = false;
+    uint32_t tex_id      = render_backend->GetWorldTargetTexture((int)(view - world_views), upside_down);
+
+    float ty1 = upside_down ? 1.0f : 0.0f;
+
+    HUDRawFromTexID(view->rect[0], view->rect[1], view->rect[2], view->rect[3], tex_id, kOpacitySolid, 0, ty1, 1,
+                    1.0f - ty1, 1.0f);
+}
+
+void HUDRenderWorld(float x, float y, float w, float h, MapObject *camera, int flags)
+{
     HUDPushScissor(x, y, x + w, y + h, (flags & 1) == 0);
 
     hud_visible_bottom = y + h;
@@ -1465,6 +1566,53 @@ void HUDRenderWorld(float x, float y, float w, float h, MapObject *camera, int f
     float x2 = xy[2]; // HUDToRealCoordinatesX(x+w);
     float y2 = xy[3]; // HUDToRealCoordinatesY(y+h);
 
+    WorldView *view = nullptr;
+
+    // the player's own view (and full screen ones) are always drawn direct
+    if (renderer_world_view_targets.d_ && !camera->player_ && !full_height)
+        view = FindWorldView(camera, xy);
+
+    int target_w = HMM_MAX(1, RoundToInteger((x2 - x1) * renderer_world_view_scale.f_));
+    int target_h = HMM_MAX(1, RoundToInteger((y2 - y1) * renderer_world_view_scale.f_));
+
+    if (view && !WorldViewChanged(view, camera, target_w, target_h, expand_w))
+    {
+        DrawWorldView(view);
+        HUDPopScissor();
+        return;
+    }
+
+    render_backend->BeginWorldRender();
+
+    if (view && render_backend->BeginWorldTarget((int)(view - world_views), target_w, target_h))
+    {
+        render_state->Scissor(0, 0, target_w, target_h);
+
+        RenderView(0, 0, target_w, target_h, camera, full_height, expand_w);
+
+        render_backend->FinishWorldTarget();
+
+        render_state->Scissor(xy[0], xy[1], xy[2] - xy[0], xy[3] - xy[1]);
+
+        view->valid                 = true;
+        view->width                 = target_w;
+        view->height                = target_h;
+        view->rendered_tic          = game_tic;
+        view->checked_tic           = game_tic;
+        view->camera_position       = {camera->x, camera->y, camera->z};
+        view->camera_angle          = camera->angle_;
+        view->camera_vertical_angle = camera->vertical_angle_;
+        view->expand_w              = expand_w;
+        view->subsectors            = RenderViewSubsectors();
+        view->state_hash            = SubsectorStateHash(view->subsectors);
+
+        render_backend->FinishWorldRender();
+
+        DrawWorldView(view);
+        HUDPopScissor();
+        return;
+    }
+
     RenderView(x1, y1, x2 - x1, y2 - y1, camera, full_height, expand_w);
 
     HUDPopScissor();
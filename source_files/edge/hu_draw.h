@@ -131,6 +131,9 @@ void HUDDrawQuitScreen();
 // render a view of the world using the given camera object.
 void HUDRenderWorld(float x, float y, float w, float h, MapObject *camera, int flags);
 
+// forget the cached camera views, called at level shutdown
+void HUDClearWorldViews(void);
+
 // render the automap
 void HUDRenderAutomap(float x, float y, float w, float h, MapObject *focus, int flags);
 
@@ -312,6 +312,9 @@ TTFFont::TTFFont(FontDefinition *definition)
     EPI_CLEAR_MEMORY(truetype_reference_yshift_, float, 3);
     EPI_CLEAR_MEMORY(truetype_texture_id_, unsigned int, 3);
     EPI_CLEAR_MEMORY(truetype_smoothed_texture_id_, unsigned int, 3);
+    EPI_CLEAR_MEMORY(truetype_bitmap_, uint8_t *, 3);
+    EPI_CLEAR_MEMORY(truetype_character_width_, int, 3);
+    EPI_CLEAR_MEMORY(truetype_character_height_, int, 3);
 
     if (definition_->truetype_name_.empty())
     {
@@ -353,8 +356,7 @@ TTFFont::TTFFont(FontDefinition *definition)
     }
 
     TrueTypeCharacter ref;
-
-    ref.glyph_index = 0;
+    EPI_CLEAR_MEMORY(&ref, TrueTypeCharacter, 1);
 
     char ch = 0;
 
@@ -389,81 +391,144 @@ TTFFont::TTFFont(FontDefinition *definition)
     if (ref.glyph_index == 0)
         FatalError("LoadFontTTF: No suitable characters in font %s.\n", definition_->name_.c_str());
 
+    if (definition_->default_size_ == 0.0)
+        definition_->default_size_ = 7.0f;
+
     for (int i = 0; i < 3; i++)
+        truetype_kerning_scale_[i] = stbtt_ScaleForPixelHeight(truetype_info_, definition_->default_size_);
+
+    truetype_reference_char_ = ch;
+    truetype_glyph_map_.try_emplace((uint8_t)ch, ref);
+
+    spacing_ = definition_->spacing_ + 0.5; // + 0.5 for at least a minimal buffer
+                                            // between letters by default
+
+    // Only the tier for the current screen size is packed up front; the
+    // others follow if the resolution ever changes.
+    LoadSize(current_font_size);
+}
+
+//
+// Pack one size tier of the font.  The coverage is kept as a single
+// channel bitmap and only widened to RGBA while a texture is uploaded,
+// and only the texture variant(s) the font can actually use are made.
+//
+void TTFFont::LoadSize(int size)
+{
+    EPI_ASSERT(size >= 0 && size < 3);
+
+    if (truetype_atlas_[size])
+        return;
+
+    truetype_atlas_[size]                                   = new stbtt_pack_range;
+    truetype_atlas_[size]->first_unicode_codepoint_in_range = 0;
+    truetype_atlas_[size]->array_of_unicode_codepoints      = (int *)kCP437UnicodeValues;
+    truetype_atlas_[size]->font_size                        = truetype_scaling_font_sizes[size];
+    truetype_atlas_[size]->num_chars                        = 256;
+    truetype_atlas_[size]->chardata_for_range               = new stbtt_packedchar[256];
+
+    const int32_t bitmap_size = truetype_scaling_bitmap_sizes[size];
+
+    truetype_bitmap_[size] = new uint8_t[bitmap_size * bitmap_size];
+
+    stbtt_pack_context spc;
+    stbtt_PackBegin(&spc, truetype_bitmap_[size], bitmap_size, bitmap_size, 0, 1, nullptr);
+    stbtt_PackSetOversampling(&spc, 2, 2);
+    stbtt_PackFontRanges(&spc, truetype_buffer_, 0, truetype_atlas_[size], 1);
+    stbtt_PackEnd(&spc);
+
+    float x       = 0.0f;
+    float y       = 0.0f;
+    float ascent  = 0.0f;
+    float descent = 0.0f;
+    float linegap = 0.0f;
+
+    TrueTypeCharacter  &ref = truetype_glyph_map_.at((uint8_t)truetype_reference_char_);
+    stbtt_aligned_quad &q   = ref.character_quad[size];
+
+    stbtt_GetPackedQuad(truetype_atlas_[size]->chardata_for_range, bitmap_size, bitmap_size,
+                        (uint8_t)truetype_reference_char_, &x, &y, &q, 0);
+    stbtt_GetScaledFontVMetrics(truetype_buffer_, 0, truetype_scaling_font_sizes[size], &ascent, &descent, &linegap);
+
+    const float ratio = definition_->default_size_ / truetype_scaling_font_sizes[size];
+
+    truetype_character_width_[size]  = (q.x1 - q.x0) * ratio;
+    truetype_character_height_[size] = (ascent - descent) * ratio;
+
+    // Glyphs cached before this tier existed (the reference one included)
+    // get their metrics for it now.
+    for (auto &glyph : truetype_glyph_map_)
+        MeasureGlyph(glyph.second, (char)glyph.first, size);
+
+    truetype_reference_yshift_[size] = ref.y_shift[size];
+
+    switch (definition_->truetype_smoothing_)
     {
-        truetype_atlas_[i]                                   = new stbtt_pack_range;
-        truetype_atlas_[i]->first_unicode_codepoint_in_range = 0;
-        truetype_atlas_[i]->array_of_unicode_codepoints      = (int *)kCP437UnicodeValues;
-        truetype_atlas_[i]->font_size                        = truetype_scaling_font_sizes[i];
-        truetype_atlas_[i]->num_chars                        = 256;
-        truetype_atlas_[i]->chardata_for_range               = new stbtt_packedchar[256];
+    case FontDefinition::kTrueTypeSmoothAlways:
+        UploadAtlas(size, true);
+        break;
+    case FontDefinition::kTrueTypeSmoothNever:
+        UploadAtlas(size, false);
+        break;
+    default:
+        UploadAtlas(size, image_smoothing);
+        break;
+    }
+}
 
-        if (definition_->default_size_ == 0.0)
-            definition_->default_size_ = 7.0f;
+void TTFFont::UploadAtlas(int size, bool smoothed)
+{
+    EPI_ASSERT(truetype_bitmap_[size]);
 
-        truetype_kerning_scale_[i] = stbtt_ScaleForPixelHeight(truetype_info_, definition_->default_size_);
+    const int32_t bitmap_size = truetype_scaling_bitmap_sizes[size];
 
-        const int32_t bitmap_size = truetype_scaling_bitmap_sizes[i];
+    // The render backends only take RGBA, so widen the coverage just for
+    // the upload.
+    uint8_t *font_bitmap = new uint8_t[bitmap_size * bitmap_size * 4];
+    memset(font_bitmap, 255, bitmap_size * bitmap_size * 4);
 
-        uint8_t *temp_bitmap = new uint8_t[bitmap_size * bitmap_size];
+    uint8_t *src  = truetype_bitmap_[size];
+    uint8_t *dest = &font_bitmap[3];
+    for (int32_t j = 0; j < bitmap_size * bitmap_size; j++, src++, dest += 4)
+    {
+        *dest = *src;
+    }
 
-        stbtt_pack_context spc;
-        stbtt_PackBegin(&spc, temp_bitmap, bitmap_size, bitmap_size, 0, 1, nullptr);
-        stbtt_PackSetOversampling(&spc, 2, 2);
-        stbtt_PackFontRanges(&spc, truetype_buffer_, 0, truetype_atlas_[i], 1);
-        stbtt_PackEnd(&spc);
+    unsigned int *tex_id = smoothed ? &truetype_smoothed_texture_id_[size] : &truetype_texture_id_[size];
 
-        // Convert to RGBA, couldn't get the pack stride to work properly above
-        uint8_t *font_bitmap = new uint8_t[bitmap_size * bitmap_size * 4];
-        memset(font_bitmap, 255, bitmap_size * bitmap_size * 4);
+    render_state->GenTextures(1, tex_id);
+    render_state->BindTexture(*tex_id);
+    render_state->TextureMinFilter(smoothed ? GL_LINEAR : GL_NEAREST);
+    render_state->TextureMagFilter(smoothed ? GL_LINEAR : GL_NEAREST);
+    render_state->TexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, bitmap_size, bitmap_size, 0, GL_RGBA, GL_UNSIGNED_BYTE,
+                             font_bitmap);
+    render_state->FinishTextures(1, tex_id);
 
-        uint8_t *src  = temp_bitmap;
-        uint8_t *dest = &font_bitmap[3];
-        for (int32_t j = 0; j < bitmap_size * bitmap_size; j++, src++, dest += 4)
-        {
-            *dest = *src;
-        }
+    delete[] font_bitmap;
 
-        render_state->GenTextures(1, &truetype_texture_id_[i]);
-        render_state->BindTexture(truetype_texture_id_[i]);
-        render_state->TextureMinFilter(GL_NEAREST);
-        render_state->TextureMagFilter(GL_NEAREST);
-        render_state->TexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, bitmap_size, bitmap_size, 0, GL_RGBA, GL_UNSIGNED_BYTE,
-                                 font_bitmap);
-        render_state->FinishTextures(1, &truetype_texture_id_[i]);
+    // Only fonts smoothed on demand can ever want the other variant.
+    if (definition_->truetype_smoothing_ != FontDefinition::kTrueTypeSmoothOnDemand ||
+        (truetype_texture_id_[size] && truetype_smoothed_texture_id_[size]))
+    {
+        delete[] truetype_bitmap_[size];
+        truetype_bitmap_[size] = nullptr;
+    }
+}
 
-        render_state->GenTextures(1, &truetype_smoothed_texture_id_[i]);
-        render_state->BindTexture(truetype_smoothed_texture_id_[i]);
-        render_state->TextureMinFilter(GL_LINEAR);
-        render_state->TextureMagFilter(GL_LINEAR);
-        render_state->TexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, bitmap_size, bitmap_size, 0, GL_RGBA, GL_UNSIGNED_BYTE,
-                                 font_bitmap);
-        render_state->FinishTextures(1, &truetype_smoothed_texture_id_[i]);
-
-        delete[] temp_bitmap;
-        delete[] font_bitmap;
-        float x       = 0.0f;
-        float y       = 0.0f;
-        float ascent  = 0.0f;
-        float descent = 0.0f;
-        float linegap = 0.0f;
-        stbtt_GetPackedQuad(truetype_atlas_[i]->chardata_for_range, bitmap_size, bitmap_size, (uint8_t)ch, &x, &y,
-                            &ref.character_quad[i], 0);
-        stbtt_GetScaledFontVMetrics(truetype_buffer_, 0, truetype_scaling_font_sizes[i], &ascent, &descent, &linegap);
-        ref.width[i] = (ref.character_quad[i].x1 - ref.character_quad[i].x0) *
-                       (definition_->default_size_ / truetype_scaling_font_sizes[i]);
-        ref.height[i] = (ref.character_quad[i].y1 - ref.character_quad[i].y0) *
-                        (definition_->default_size_ / truetype_scaling_font_sizes[i]);
-        truetype_character_width_[i] = ref.width[i];
-        truetype_character_height_[i] =
-            (ascent - descent) * (definition_->default_size_ / truetype_scaling_font_sizes[i]);
-        ref.y_shift[i] = (truetype_character_height_[i] - ref.height[i]) +
-                         (ref.character_quad[i].y1 * (definition_->default_size_ / truetype_scaling_font_sizes[i]));
-        truetype_reference_yshift_[i] = ref.y_shift[i];
+unsigned int TTFFont::Texture(bool smoothed)
+{
+    LoadSize(current_font_size);
+
+    unsigned int tex_id =
+        smoothed ? truetype_smoothed_texture_id_[current_font_size] : truetype_texture_id_[current_font_size];
+
+    if (!tex_id && truetype_bitmap_[current_font_size])
+    {
+        UploadAtlas(current_font_size, smoothed);
+        tex_id = smoothed ? truetype_smoothed_texture_id_[current_font_size] : truetype_texture_id_[current_font_size];
     }
-    truetype_glyph_map_.try_emplace((uint8_t)ch, ref);
-    spacing_ = definition_->spacing_ + 0.5; // + 0.5 for at least a minimal buffer
-                                            // between letters by default
+
+    return tex_id;
 }
 
 ImageFont::~ImageFont()
@@ -491,6 +556,11 @@ TTFFont::~TTFFont()
             delete truetype_atlas_[i];
             truetype_atlas_[i] = nullptr;
         }
+        if (truetype_bitmap_[i])
+        {
+            delete[] truetype_bitmap_[i];
+            truetype_bitmap_[i] = nullptr;
+        }
     }
 }
 
@@ -602,74 +672,79 @@ float PatchFont::CharWidth(char ch)
         return rect.image_width + spacing_;
 }
 
-float TTFFont::CharWidth(char ch)
+void TTFFont::MeasureGlyph(TrueTypeCharacter &character, char ch, int size)
 {
-    auto find_glyph = truetype_glyph_map_.find((uint8_t)ch);
-    if (find_glyph != truetype_glyph_map_.end())
-        return (find_glyph->second.width[current_font_size] + spacing_) * pixel_aspect_ratio.f_;
+    const int   bitmap_size = truetype_scaling_bitmap_sizes[size];
+    const float ratio       = definition_->default_size_ / truetype_scaling_font_sizes[size];
+    float       x           = 0.0f;
+    float       y           = 0.0f;
+
+    stbtt_GetPackedQuad(truetype_atlas_[size]->chardata_for_range, bitmap_size, bitmap_size, (uint8_t)ch, &x, &y,
+                        &character.character_quad[size], 0);
+    if (ch == ' ')
+        character.width[size] = truetype_character_width_[size] * 3 / 5;
     else
-    {
-        TrueTypeCharacter character;
-        for (int i = 0; i < 3; i++)
-        {
-            float x = 0.0f;
-            float y = 0.0f;
-            stbtt_GetPackedQuad(truetype_atlas_[i]->chardata_for_range, truetype_scaling_bitmap_sizes[i],
-                                truetype_scaling_bitmap_sizes[i], (uint8_t)ch, &x, &y, &character.character_quad[i], 0);
-            if (ch == ' ')
-                character.width[i] = truetype_character_width_[i] * 3 / 5;
-            else
-                character.width[i] = (character.character_quad[i].x1 - character.character_quad[i].x0) *
-                                     (definition_->default_size_ / truetype_scaling_font_sizes[i]);
-            character.height[i] = (character.character_quad[i].y1 - character.character_quad[i].y0) *
-                                  (definition_->default_size_ / truetype_scaling_font_sizes[i]);
-            character.y_shift[i] =
-                (truetype_character_height_[i] - character.height[i]) +
-                (character.character_quad[i].y1 * (definition_->default_size_ / truetype_scaling_font_sizes[i]));
-        }
-        character.glyph_index = stbtt_FindGlyphIndex(truetype_info_, kCP437UnicodeValues[(uint8_t)ch]);
-        truetype_glyph_map_.try_emplace((uint8_t)ch, character);
-        return (character.width[current_font_size] + spacing_) * pixel_aspect_ratio.f_;
-    }
+        character.width[size] = (character.character_quad[size].x1 - character.character_quad[size].x0) * ratio;
+    character.height[size]  = (character.character_quad[size].y1 - character.character_quad[size].y0) * ratio;
+    character.y_shift[size] = (truetype_character_height_[size] - character.height[size]) +
+                              (character.character_quad[size].y1 * ratio);
 }
 
 //
-// Get glyph index for TTF Character. If character hasn't been cached yet, cache
-// it.
+// Get the cached metrics for a TTF character, caching them for every
+// packed tier if this is the first time it's been asked for.
 //
-int TTFFont::GetGlyphIndex(char ch)
+TrueTypeCharacter &TTFFont::CacheGlyph(char ch)
 {
+    LoadSize(current_font_size);
+
     auto find_glyph = truetype_glyph_map_.find((uint8_t)ch);
     if (find_glyph != truetype_glyph_map_.end())
-        return find_glyph->second.glyph_index;
-    else
+        return find_glyph->second;
+
+    TrueTypeCharacter character;
+    EPI_CLEAR_MEMORY(&character, TrueTypeCharacter, 1);
+    for (int i = 0; i < 3; i++)
     {
-        TrueTypeCharacter character;
-        for (int i = 0; i < 3; i++)
-        {
-            float x = 0.0f;
-            float y = 0.0f;
-            stbtt_GetPackedQuad(truetype_atlas_[i]->chardata_for_range, truetype_scaling_bitmap_sizes[i],
-                                truetype_scaling_bitmap_sizes[i], (uint8_t)ch, &x, &y, &character.character_quad[i], 0);
-            if (ch == ' ')
-                character.width[i] = truetype_character_width_[i] * 3 / 5;
-            else
-                character.width[i] = (character.character_quad[i].x1 - character.character_quad[i].x0) *
-                                     (definition_->default_size_ / truetype_scaling_font_sizes[i]);
-            character.height[i] = (character.character_quad[i].y1 - character.character_quad[i].y0) *
-                                  (definition_->default_size_ / truetype_scaling_font_sizes[i]);
-            character.y_shift[i] =
-                (truetype_character_height_[i] - character.height[i]) +
-                (character.character_quad[i].y1 * (definition_->default_size_ / truetype_scaling_font_sizes[i]));
-        }
-        character.glyph_index = stbtt_FindGlyphIndex(truetype_info_, kCP437UnicodeValues[(uint8_t)ch]);
-        truetype_glyph_map_.try_emplace((uint8_t)ch, character);
-        return character.glyph_index;
+        if (truetype_atlas_[i])
+            MeasureGlyph(character, ch, i);
     }
+    character.glyph_index = stbtt_FindGlyphIndex(truetype_info_, kCP437UnicodeValues[(uint8_t)ch]);
+
+    return truetype_glyph_map_.try_emplace((uint8_t)ch, character).first->second;
+}
+
+float TTFFont::CharWidth(char ch)
+{
+    return (CacheGlyph(ch).width[current_font_size] + spacing_) * pixel_aspect_ratio.f_;
+}
+
+int TTFFont::GetGlyphIndex(char ch)
+{
+    return CacheGlyph(ch).glyph_index;
+}
+
+//
+// Kerning pairs are looked up once and remembered, since the GPOS/kern
+// table walk in stb_truetype is far slower than the rest of a string
+// measurement.
+//
+float TTFFont::Kerning(char left, char right)
+{
+    if (truetype_kerning_.empty())
+        truetype_kerning_.resize(256 * 256, INT16_MIN);
+
+    int16_t &kern = truetype_kerning_[(uint8_t)left * 256 + (uint8_t)right];
+
+    if (kern == INT16_MIN)
+        kern = (int16_t)stbtt_GetGlyphKernAdvance(truetype_info_, GetGlyphIndex(left), GetGlyphIndex(right));
+
+    return kern * truetype_kerning_scale_[current_font_size];
 }
 
 float TTFFont::GetYShift()
 {
+    LoadSize(current_font_size);
     return truetype_reference_yshift_[current_font_size];
 }
 
@@ -738,9 +813,7 @@ float TTFFont::StringWidth(const char *str)
     {
         w += CharWidth(width_check[i]);
         if (i + 1 < width_check.size())
-            w += stbtt_GetGlyphKernAdvance(truetype_info_, GetGlyphIndex(width_check[i]),
-                                           GetGlyphIndex(width_check[i + 1])) *
-                 truetype_kerning_scale_[current_font_size];
+            w += Kerning(width_check[i], width_check[i + 1]);
     }
 
     return w;
@@ -811,5 +884,14 @@ Font *FontContainer::Lookup(FontDefinition *definition)
     return new_f;
 }
 
+void FontContainer::LoadTrueTypeSize(int size)
+{
+    for (Font *f : *this)
+    {
+        if (f->definition_->type_ == kFontTypeTrueType)
+            ((TTFFont *)f)->LoadSize(size);
+    }
+}
+
 //--- editor settings ---
 // vi:ts=4:sw=4:noexpandtab
@@ -163,6 +163,16 @@ class TTFFont final : public Font
     int   GetGlyphIndex(char ch);
     float GetYShift() override;
 
+    // Kerning between two characters, already scaled to the font size.
+    float Kerning(char left, char right);
+
+    // Texture for the current size tier, uploaded on first use.
+    unsigned int Texture(bool smoothed);
+
+    // Packs the glyphs for one size tier; normally done on first use, or
+    // by FontContainer::LoadTrueTypeSize when the screen size changes.
+    void LoadSize(int size);
+
     bool HasChar(char ch) const override;
 
   public:
@@ -173,11 +183,23 @@ class TTFFont final : public Font
     stbtt_fontinfo                            *truetype_info_;
 
   private:
+    void               MeasureGlyph(TrueTypeCharacter &character, char ch, int size);
+    TrueTypeCharacter &CacheGlyph(char ch);
+    void               UploadAtlas(int size, bool smoothed);
+
     float             truetype_reference_yshift_[3];
     stbtt_pack_range *truetype_atlas_[3];
     int               truetype_character_width_[3];
     int               truetype_character_height_[3];
     uint8_t          *truetype_buffer_;
+    char              truetype_reference_char_;
+
+    // Single channel coverage, kept only while a texture variant for the
+    // tier may still need uploading.
+    uint8_t *truetype_bitmap_[3];
+
+    // 256x256 table of kerning in font units, filled in as pairs are used.
+    std::vector<int16_t> truetype_kerning_;
 };
 
 class FontContainer : public std::vector<Font *>
@@ -217,6 +239,9 @@ class FontContainer : public std::vector<Font *>
     // Search Functions
     Font *Lookup(FontDefinition *definition);
 
+    // Makes sure every TrueType font has the given size tier ready.
+    void LoadTrueTypeSize(int size);
+
   private:
     std::unordered_map<epi::StringHash, stbtt_fontinfo *> ttf_infos;
     std::unordered_map<epi::StringHash, uint8_t *>        ttf_buffers;
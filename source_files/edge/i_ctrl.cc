@@ -58,8 +58,11 @@ void HandleFocusLost(void)
 
 int GetTime(void)
 {
-    uint32_t t = gd::Platform::GetTicks();
+    return TicsFromMilliseconds(gd::Platform::GetTicks());
+}
 
+int TicsFromMilliseconds(uint32_t t)
+{
     // more complex than "t*35/1000" to give more accuracy
     return (t / 1000) * kTicRate + (t % 1000) * kTicRate / 1000;
 }
@@ -32,15 +32,23 @@
 #include "s_blit.h"
 #include "s_music.h"
 #include "s_sound.h"
+#include "thread.h"
 #include "w_files.h"
 #include "w_wad.h"
 
+// SSE2 is always there on x86-64, other targets use the plain loop.
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define EDGE_MOVIE_SSE2
+#include <emmintrin.h>
+#endif
+
 extern int sound_device_frequency;
 
 bool             playing_movie = false;
 static bool      skip_bar_active;
 static GLuint    canvas            = 0;
-static uint8_t  *rgb_data          = nullptr;
+static int       canvas_width      = 0;
+static int       canvas_height     = 0;
 static plm_t    *decoder           = nullptr;
 static int       movie_sample_rate = 0;
 static float     skip_time;
@@ -60,6 +68,152 @@ static double    last_time    = 0;
 static ma_pcm_rb movie_ring_buffer;
 static ma_sound  movie_sound_buffer;
 static bool      canvas_can_update;
+static bool      movie_has_audio;
+static bool      movie_ended;
+static double    movie_clock;
+
+// Frames are decoded and converted on their own thread, a few ahead of
+// the one on screen.  The decoder only writes the slot at head and the
+// ticker only reads the slot at tail, so neither needs a lock.
+static constexpr int kMovieFrameQueueSize = 4;
+
+struct MovieFrame
+{
+    uint8_t *pixels;
+    double   time;
+};
+
+static MovieFrame          movie_frames[kMovieFrameQueueSize];
+static thread_atomic_int_t movie_frame_head;
+static thread_atomic_int_t movie_frame_tail;
+static thread_ptr_t        movie_decoder_thread = nullptr;
+static thread_signal_t     movie_decoder_wake;
+static thread_atomic_int_t movie_decoder_exit;
+static thread_atomic_int_t movie_decoder_finished;
+
+// PCM frames handed to the ring buffer so far; together with what is
+// still queued in the ring this gives the playback position.
+static thread_atomic_int_t movie_audio_written;
+
+static inline uint8_t MovieClamp(int n)
+{
+    return (uint8_t)(n < 0 ? 0 : (n > 255 ? 255 : n));
+}
+
+//
+// BT.601 YCbCr to RGBA, producing exactly what plm_frame_to_rgba does.
+// pl_mpeg's fixed point constants don't fit in 16 bits, so each is split
+// into a whole multiple of 65536 plus a 16-bit remainder, which lets the
+// SIMD path use 16-bit multiplies without changing the rounding.
+//
+static void MovieFrameToRGBA(const plm_frame_t *frame, uint8_t *dest, int stride)
+{
+    const int cols = frame->width >> 1;
+    const int rows = frame->height >> 1;
+    const int yw   = frame->y.width;
+    const int cw   = frame->cb.width;
+
+    for (int row = 0; row < rows; row++)
+    {
+        const uint8_t *y0  = frame->y.data + row * 2 * yw;
+        const uint8_t *y1  = y0 + yw;
+        const uint8_t *cbp = frame->cb.data + row * cw;
+        const uint8_t *crp = frame->cr.data + row * cw;
+        uint8_t       *d0  = dest + row * 2 * stride;
+        uint8_t       *d1  = d0 + stride;
+
+        int col = 0;
+
+#ifdef EDGE_MOVIE_SSE2
+        const __m128i zero  = _mm_setzero_si128();
+        const __m128i c128  = _mm_set1_epi16(128);
+        const __m128i c16   = _mm_set1_epi16(16);
+        const __m128i alpha = _mm_set1_epi8((char)255);
+        const __m128i y_mul = _mm_set1_epi16(10773);  // 76309 - 65536
+        const __m128i r_mul = _mm_set1_epi16(-26475); // 104597 - 2 * 65536
+        const __m128i b_mul = _mm_set1_epi16(1129);   // 132201 - 2 * 65536
+        const __m128i g_mul = _mm_set_epi16(-12258, 25674, -12258, 25674, -12258, 25674, -12258, 25674);
+
+        // eight chroma samples (sixteen pixels on each of two rows) a go
+        for (; col + 8 <= cols; col += 8)
+        {
+            __m128i cb = _mm_sub_epi16(_mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(cbp + col)), zero), c128);
+            __m128i cr = _mm_sub_epi16(_mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(crp + col)), zero), c128);
+
+            // r = 2cr + (cr * -26475) >> 16, b = 2cb + (cb * 1129) >> 16
+            __m128i r = _mm_add_epi16(_mm_add_epi16(cr, cr), _mm_mulhi_epi16(cr, r_mul));
+            __m128i b = _mm_add_epi16(_mm_add_epi16(cb, cb), _mm_mulhi_epi16(cb, b_mul));
+
+            // g = cr + (cb * 25674 - cr * 12258) >> 16, needs the sum before the shift
+            __m128i g_lo = _mm_srai_epi32(_mm_madd_epi16(_mm_unpacklo_epi16(cb, cr), g_mul), 16);
+            __m128i g_hi = _mm_srai_epi32(_mm_madd_epi16(_mm_unpackhi_epi16(cb, cr), g_mul), 16);
+            __m128i g    = _mm_add_epi16(cr, _mm_packs_epi32(g_lo, g_hi));
+
+            // each chroma sample covers two pixels across
+            __m128i r_px[2] = {_mm_unpacklo_epi16(r, r), _mm_unpackhi_epi16(r, r)};
+            __m128i g_px[2] = {_mm_unpacklo_epi16(g, g), _mm_unpackhi_epi16(g, g)};
+            __m128i b_px[2] = {_mm_unpacklo_epi16(b, b), _mm_unpackhi_epi16(b, b)};
+
+            const uint8_t *src[2] = {y0 + col * 2, y1 + col * 2};
+            uint8_t       *dst[2] = {d0 + col * 8, d1 + col * 8};
+
+            for (int line = 0; line < 2; line++)
+            {
+                __m128i luma = _mm_loadu_si128((const __m128i *)src[line]);
+                __m128i out[2][3];
+
+                for (int half = 0; half < 2; half++)
+                {
+                    __m128i y = half ? _mm_unpackhi_epi8(luma, zero) : _mm_unpacklo_epi8(luma, zero);
+                    y         = _mm_sub_epi16(y, c16);
+                    y         = _mm_add_epi16(y, _mm_mulhi_epi16(y, y_mul));
+
+                    out[half][0] = _mm_add_epi16(y, r_px[half]);
+                    out[half][1] = _mm_sub_epi16(y, g_px[half]);
+                    out[half][2] = _mm_add_epi16(y, b_px[half]);
+                }
+
+                // saturating packs do the clamp to 0..255
+                __m128i rr = _mm_packus_epi16(out[0][0], out[1][0]);
+                __m128i gg = _mm_packus_epi16(out[0][1], out[1][1]);
+                __m128i bb = _mm_packus_epi16(out[0][2], out[1][2]);
+
+                __m128i rg_lo = _mm_unpacklo_epi8(rr, gg);
+                __m128i rg_hi = _mm_unpackhi_epi8(rr, gg);
+                __m128i ba_lo = _mm_unpacklo_epi8(bb, alpha);
+                __m128i ba_hi = _mm_unpackhi_epi8(bb, alpha);
+
+                _mm_storeu_si128((__m128i *)(dst[line] + 0), _mm_unpacklo_epi16(rg_lo, ba_lo));
+                _mm_storeu_si128((__m128i *)(dst[line] + 16), _mm_unpackhi_epi16(rg_lo, ba_lo));
+                _mm_storeu_si128((__m128i *)(dst[line] + 32), _mm_unpacklo_epi16(rg_hi, ba_hi));
+                _mm_storeu_si128((__m128i *)(dst[line] + 48), _mm_unpackhi_epi16(rg_hi, ba_hi));
+            }
+        }
+#endif
+
+        for (; col < cols; col++)
+        {
+            int cr = crp[col] - 128;
+            int cb = cbp[col] - 128;
+            int r  = (cr * 104597) >> 16;
+            int g  = (cb * 25674 + cr * 53278) >> 16;
+            int b  = (cb * 132201) >> 16;
+
+            const uint8_t *src[4] = {y0 + col * 2, y0 + col * 2 + 1, y1 + col * 2, y1 + col * 2 + 1};
+            uint8_t       *dst[4] = {d0 + col * 8, d0 + col * 8 + 4, d1 + col * 8, d1 + col * 8 + 4};
+
+            for (int p = 0; p < 4; p++)
+            {
+                int y     = ((*src[p] - 16) * 76309) >> 16;
+                dst[p][0] = MovieClamp(y + r);
+                dst[p][1] = MovieClamp(y - g);
+                dst[p][2] = MovieClamp(y + b);
+                dst[p][3] = 255;
+            }
+        }
+    }
+}
+
 
 static bool MovieSetupAudioStream(int rate)
 {
@@ -77,7 +231,6 @@ static bool MovieSetupAudioStream(int rate)
         LogWarning("MovieSetupAudioStream: Failed to initialize the ring buffer.");
         return false;
     }
-    plm_set_audio_lead_time(decoder, (double)1024 / (double)rate);
     // ring buffer based sounds need to unconditionally "loop" so that even if the buffer
     // has no data ready to read it will not report being "finished"
     ma_node_attach_output_bus(&movie_sound_buffer, 0, &music_node, 0);
@@ -128,24 +281,139 @@ void MovieAudioCallback(plm_t *mpeg, plm_samples_t *samples, void *user)
 
             framesWritten += framesToWrite;
         }
+
+        thread_atomic_int_add(&movie_audio_written, (int)framesWritten);
     }
 }
 
-void MovieVideoCallback(plm_t *mpeg, plm_frame_t *frame, void *user)
+//
+// Runs until the movie is finished or EndMovie asks it to stop.  Video is
+// kept kMovieFrameQueueSize frames ahead and audio as far ahead as the
+// ring buffer allows; the decoder is owned by this thread while it runs.
+//
+static int32_t MovieDecoderProc(void *thread_data)
 {
-    EPI_UNUSED(mpeg);
-    EPI_UNUSED(user);
+    EPI_UNUSED(thread_data);
 
-    if (canvas_can_update)
+    bool video_done = false;
+    bool audio_done = !movie_has_audio;
+
+    while (thread_atomic_int_load(&movie_decoder_exit) == 0 && !(video_done && audio_done))
     {
-        plm_frame_to_rgba(frame, rgb_data, frame->width * 4);
+        bool worked = false;
+
+        int head = thread_atomic_int_load(&movie_frame_head);
 
-        render_state->BindTexture(canvas);
-        render_state->TexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, frame->width, frame->height, 0, GL_RGBA, GL_UNSIGNED_BYTE,
-                                 rgb_data);
+        if (!video_done && head - thread_atomic_int_load(&movie_frame_tail) < kMovieFrameQueueSize)
+        {
+            plm_frame_t *frame = plm_decode_video(decoder);
+
+            if (frame)
+            {
+                MovieFrame &slot = movie_frames[head % kMovieFrameQueueSize];
+
+                MovieFrameToRGBA(frame, slot.pixels, frame->width * 4);
+                slot.time = frame->time;
+
+                thread_atomic_int_store(&movie_frame_head, head + 1);
+                worked = true;
+            }
+            else
+                video_done = true;
+        }
+
+        if (!audio_done && ma_pcm_rb_available_write(&movie_ring_buffer) >= PLM_AUDIO_SAMPLES_PER_FRAME)
+        {
+            plm_samples_t *samples = plm_decode_audio(decoder);
+
+            if (samples)
+            {
+                MovieAudioCallback(decoder, samples, nullptr);
+                worked = true;
+            }
+            else
+                audio_done = true;
+        }
 
-        canvas_can_update = false;
+        if (!worked)
+            thread_signal_wait(&movie_decoder_wake, 5);
     }
+
+    thread_atomic_int_store(&movie_decoder_finished, 1);
+
+    return 0;
+}
+
+static void StartMovieDecoder(int width, int height)
+{
+    canvas_width  = width;
+    canvas_height = height;
+
+    for (int i = 0; i < kMovieFrameQueueSize; i++)
+    {
+        movie_frames[i].pixels = new uint8_t[width * height * 4];
+        movie_frames[i].time   = 0;
+    }
+
+    thread_atomic_int_store(&movie_frame_head, 0);
+    thread_atomic_int_store(&movie_frame_tail, 0);
+    thread_atomic_int_store(&movie_decoder_exit, 0);
+    thread_atomic_int_store(&movie_decoder_finished, 0);
+    thread_atomic_int_store(&movie_audio_written, 0);
+    thread_signal_init(&movie_decoder_wake);
+
+    movie_decoder_thread = thread_create(MovieDecoderProc, nullptr, THREAD_STACK_SIZE_DEFAULT);
+}
+
+static void StopMovieDecoder(void)
+{
+    if (!movie_decoder_thread)
+        return;
+
+    thread_atomic_int_store(&movie_decoder_exit, 1);
+    thread_signal_raise(&movie_decoder_wake);
+    thread_join(movie_decoder_thread);
+    thread_destroy(movie_decoder_thread);
+    movie_decoder_thread = nullptr;
+
+    thread_signal_term(&movie_decoder_wake);
+
+    for (int i = 0; i < kMovieFrameQueueSize; i++)
+    {
+        delete[] movie_frames[i].pixels;
+        movie_frames[i].pixels = nullptr;
+    }
+}
+
+//
+// Upload the newest decoded frame which is due, dropping any older ones
+// which were missed.  The sokol backend only allows one update of the
+// canvas per frame, hence canvas_can_update.
+//
+static void MovieShowFrame(void)
+{
+    if (!canvas_can_update)
+        return;
+
+    int tail = thread_atomic_int_load(&movie_frame_tail);
+    int head = thread_atomic_int_load(&movie_frame_head);
+    int show = -1;
+
+    for (; tail != head && movie_frames[tail % kMovieFrameQueueSize].time <= movie_clock; tail++)
+        show = tail;
+
+    if (show < 0)
+        return;
+
+    render_state->BindTexture(canvas);
+    render_state->TexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, canvas_width, canvas_height, 0, GL_RGBA, GL_UNSIGNED_BYTE,
+                             movie_frames[show % kMovieFrameQueueSize].pixels);
+
+    canvas_can_update = false;
+
+    // the slots are only handed back once the upload has copied them
+    thread_atomic_int_store(&movie_frame_tail, tail);
+    thread_signal_raise(&movie_decoder_wake);
 }
 
 void PlayMovie(const std::string &name)
@@ -185,6 +453,7 @@ void PlayMovie(const std::string &name)
 
     if (decoder)
     {
+        StopMovieDecoder();
         plm_destroy(decoder);
         decoder = nullptr;
     }
@@ -199,6 +468,8 @@ void PlayMovie(const std::string &name)
         return;
     }
 
+    movie_has_audio = false;
+
     if (!no_sound && !(movie->special_ & kMovieSpecialMute) && plm_get_num_audio_streams(decoder) > 0)
     {
         movie_sample_rate = plm_get_samplerate(decoder);
@@ -210,6 +481,7 @@ void PlayMovie(const std::string &name)
             decoder     = nullptr;
             return;
         }
+        movie_has_audio = true;
     }
 
     if (canvas)
@@ -220,12 +492,6 @@ void PlayMovie(const std::string &name)
     render_state->TextureMagFilter(GL_LINEAR);
     render_state->TextureMinFilter(GL_LINEAR);
 
-    if (rgb_data)
-    {
-        delete[] rgb_data;
-        rgb_data = nullptr;
-    }
-
     int   movie_width  = plm_get_width(decoder);
     int   movie_height = plm_get_height(decoder);
     float movie_ratio  = (float)movie_width / movie_height;
@@ -278,16 +544,10 @@ void PlayMovie(const std::string &name)
     vy1 = current_screen_height / 2 + frame_height / 2;
     vy2 = current_screen_height / 2 - frame_height / 2;
 
-    int num_pixels = movie_width * movie_height * 4;
-    rgb_data       = new uint8_t[num_pixels];
-    EPI_CLEAR_MEMORY(rgb_data, uint8_t, num_pixels);
-    plm_set_video_decode_callback(decoder, MovieVideoCallback, nullptr);
-    plm_set_audio_decode_callback(decoder, MovieAudioCallback, nullptr);
-    if (!no_sound)
-    {
-        plm_set_audio_enabled(decoder, 1);
+    // Unused audio would otherwise pile up in the demuxer's buffer
+    plm_set_audio_enabled(decoder, movie_has_audio ? 1 : 0);
+    if (movie_has_audio)
         plm_set_audio_stream(decoder, 0);
-    }
 
     BlackoutWipeTexture();
 
@@ -295,29 +555,33 @@ void PlayMovie(const std::string &name)
     fadein    = 0;
     fadeout   = 0;
 
+    movie_clock       = 0;
+    movie_ended       = false;
     playing_movie     = true;
     canvas_can_update = true;
+
+    StartMovieDecoder(movie_width, movie_height);
 }
 
 static void EndMovie()
 {
+    StopMovieDecoder();
     plm_destroy(decoder);
     decoder = nullptr;
     delete[] movie_bytes;
     movie_bytes = nullptr;
-    if (rgb_data)
-    {
-        delete[] rgb_data;
-        rgb_data = nullptr;
-    }
     if (canvas)
     {
         render_state->DeleteTexture(&canvas);
         canvas = 0;
     }
-    ma_sound_stop(&movie_sound_buffer);
-    ma_sound_uninit(&movie_sound_buffer);
-    ma_pcm_rb_uninit(&movie_ring_buffer);
+    if (movie_has_audio)
+    {
+        ma_sound_stop(&movie_sound_buffer);
+        ma_sound_uninit(&movie_sound_buffer);
+        ma_pcm_rb_uninit(&movie_ring_buffer);
+        movie_has_audio = false;
+    }
     ResumeMusic();
 }
 
@@ -326,7 +590,7 @@ void MovieDrawer()
     if (!playing_movie)
         return;
 
-    if (!plm_has_ended(decoder))
+    if (!movie_ended)
     {
         StartUnitBatch(false);
 
@@ -351,7 +615,7 @@ void MovieDrawer()
         EndRenderUnit(4);
 
         // Fade-in
-        fadein = plm_get_time(decoder);
+        fadein = movie_clock;
         if (fadein <= 0.25f)
         {
             unit_col = epi::MakeRGBAFloat(0.0f, 0.0f, 0.0f, ((0.25f - (float)fadein) / 0.25f));
@@ -469,7 +733,7 @@ void MovieTicker()
         playing_movie = false;
         return;
     }
-    if (!plm_has_ended(decoder))
+    if (!movie_ended)
     {
         double current_time = (double)gd::Platform::GetTicks() / 1000.0;
         elapsed_time        = current_time - last_time;
@@ -477,7 +741,24 @@ void MovieTicker()
             elapsed_time = 1.0 / 30.0;
         last_time = current_time;
 
-        plm_decode(decoder, elapsed_time);
+        movie_clock += elapsed_time;
+
+        // While there is sound queued, the position of the audio actually
+        // handed to the mixer is the clock; otherwise fall back to the
+        // wall clock (silent movies, or audio which ran out early).
+        if (movie_has_audio)
+        {
+            int queued = (int)ma_pcm_rb_available_read(&movie_ring_buffer);
+            if (queued > 0)
+                movie_clock =
+                    (double)(thread_atomic_int_load(&movie_audio_written) - queued) / (double)movie_sample_rate;
+        }
+
+        MovieShowFrame();
+
+        if (thread_atomic_int_load(&movie_decoder_finished) &&
+            thread_atomic_int_load(&movie_frame_tail) == thread_atomic_int_load(&movie_frame_head))
+            movie_ended = true;
 
         if (skip_bar_active)
         {
@@ -18,7 +18,10 @@
 
 #include "i_sound.h"
 
+#include <string.h>
+
 #include <set>
+#include <vector>
 
 #include "ddf_reverb.h"
 #include "epi.h"
@@ -35,6 +38,7 @@
 #include "s_cache.h"
 #include "s_midi.h"
 #include "s_sound.h"
+#include "thread.h"
 #include "w_wad.h"
 
 // If true, sound system is off/not working. Changed to false if sound init ok.
@@ -61,13 +65,334 @@ ma_freeverb_node reverb_node;
 
 EDGE_DEFINE_CONSOLE_VARIABLE_CLAMPED(dynamic_reverb, "0", kConsoleVariableFlagArchive, 0, 2)
 
+// in frames; read once at startup
+EDGE_DEFINE_CONSOLE_VARIABLE_CLAMPED(sound_output_buffer, "2048", kConsoleVariableFlagArchive, 256, 32768)
+
+static constexpr ma_uint32 kSoundOutputSampleRate = 44100;
+static constexpr ma_uint32 kSoundOutputChannels   = 2;
+
+static bool      sound_output_external = false;
+static ma_pcm_rb sound_output_ring;
+static ma_uint32 sound_output_frames = 0;
+
+static thread_atomic_int_t sound_output_read_frames;
+static thread_atomic_int_t sound_output_underruns;
+static thread_atomic_int_t sound_output_underrun_frames;
+static thread_atomic_int_t sound_output_dropped_frames;
+
+#ifndef GD_PLATFORM_GODOT
+// no host reads the ring, so PumpSoundOutput drains it at the rate real
+// time passes (throwing the frames away), which keeps the mixer running
+static int       sound_output_drain_time      = -1;
+static ma_uint64 sound_output_drain_remainder = 0;
+#endif
+
+static bool StartupSoundOutputRing(void)
+{
+    sound_output_frames = sound_output_buffer.d_;
+
+    if (ma_pcm_rb_init(ma_format_f32, kSoundOutputChannels, sound_output_frames, NULL, NULL, &sound_output_ring) !=
+        MA_SUCCESS)
+        return false;
+
+    thread_atomic_int_store(&sound_output_read_frames, 0);
+    thread_atomic_int_store(&sound_output_underruns, 0);
+    thread_atomic_int_store(&sound_output_underrun_frames, 0);
+    thread_atomic_int_store(&sound_output_dropped_frames, 0);
+
+    return true;
+}
+
+bool SoundOutputIsExternal(void)
+{
+    return sound_output_external && !no_sound;
+}
+
+#ifndef GD_PLATFORM_GODOT
+static void DrainSoundOutput(void)
+{
+    int now_time = GetMilliseconds();
+
+    if (sound_output_drain_time < 0)
+        sound_output_drain_time = now_time;
+
+    ma_uint64 wanted = (ma_uint64)(now_time - sound_output_drain_time) * sound_device_frequency +
+                       sound_output_drain_remainder;
+
+    sound_output_drain_time      = now_time;
+    sound_output_drain_remainder = wanted % 1000;
+
+    ma_uint64 frames = wanted / 1000;
+
+    float scratch[512 * kSoundOutputChannels];
+
+    while (frames > 0)
+    {
+        uint32_t count = (uint32_t)HMM_MIN(frames, (ma_uint64)512);
+
+        ReadSoundOutput(scratch, count);
+
+        frames -= count;
+    }
+}
+#endif
+
+typedef void (*SoundOutputMixer)(void *buffer, ma_uint32 frames, void *data);
+
+//
+// Mixes into all the free space of the ring, which may wrap around its
+// end.  A full ring is the normal state between reads and is left alone.
+// Returns the frames written; `dropped` gets any which were mixed but
+// could not be committed.
+//
+static ma_uint32 FillSoundOutputRing(ma_pcm_rb *ring, SoundOutputMixer mix, void *data, ma_uint32 *dropped)
+{
+    ma_uint32 space   = ma_pcm_rb_available_write(ring);
+    ma_uint32 written = 0;
+
+    *dropped = 0;
+
+    while (space > 0)
+    {
+        ma_uint32 frames = space;
+        void     *buffer = nullptr;
+
+        if (ma_pcm_rb_acquire_write(ring, &frames, &buffer) != MA_SUCCESS || frames == 0)
+            break;
+
+        mix(buffer, frames, data);
+
+        if (ma_pcm_rb_commit_write(ring, frames) != MA_SUCCESS)
+        {
+            *dropped += frames;
+            break;
+        }
+
+        written += frames;
+        space -= frames;
+    }
+
+    return written;
+}
+
+// Copies up to `frames` frames out of the ring, returns how many it got.
+static uint32_t ReadSoundOutputRing(ma_pcm_rb *ring, float *interleaved, uint32_t frames)
+{
+    uint32_t done = 0;
+
+    while (done < frames)
+    {
+        ma_uint32 count  = frames - done;
+        void     *buffer = nullptr;
+
+        if (ma_pcm_rb_acquire_read(ring, &count, &buffer) != MA_SUCCESS || count == 0)
+            break;
+
+        memcpy(interleaved + done * kSoundOutputChannels, buffer, count * kSoundOutputChannels * sizeof(float));
+
+        ma_pcm_rb_commit_read(ring, count);
+
+        done += count;
+    }
+
+    return done;
+}
+
+static void MixSoundEngine(void *buffer, ma_uint32 frames, void *data)
+{
+    EPI_UNUSED(data);
+
+    ma_uint64 mixed = 0;
+    ma_engine_read_pcm_frames(&sound_engine, buffer, frames, &mixed);
+}
+
+//
+// Mix until the ring is full.  The engine only advances as fast as the
+// host drains, so nothing is ever mixed only to be thrown away.  Called
+// once per frame by the engine loop (EdgeTicker, or GDD_Tick when the
+// simulation has its own thread).
+//
+void PumpSoundOutput(void)
+{
+    if (!SoundOutputIsExternal())
+        return;
+
+#ifndef GD_PLATFORM_GODOT
+    DrainSoundOutput();
+#endif
+
+    ma_uint32 dropped = 0;
+
+    FillSoundOutputRing(&sound_output_ring, MixSoundEngine, nullptr, &dropped);
+
+    if (dropped > 0)
+        thread_atomic_int_add(&sound_output_dropped_frames, (int)dropped);
+}
+
+uint32_t ReadSoundOutput(float *interleaved, uint32_t frames)
+{
+    uint32_t done = 0;
+
+    if (SoundOutputIsExternal())
+    {
+        done = ReadSoundOutputRing(&sound_output_ring, interleaved, frames);
+
+        thread_atomic_int_add(&sound_output_read_frames, (int)done);
+    }
+
+    // the host still needs a full buffer, so pad with silence
+    if (done < frames)
+    {
+        memset(interleaved + done * kSoundOutputChannels, 0, (frames - done) * kSoundOutputChannels * sizeof(float));
+
+        thread_atomic_int_inc(&sound_output_underruns);
+        thread_atomic_int_add(&sound_output_underrun_frames, (int)(frames - done));
+    }
+
+    return frames;
+}
+
+#ifndef NDEBUG
+
+// writes a running frame number into both channels, negated on the right
+static void MixSelfCheckRamp(void *buffer, ma_uint32 frames, void *data)
+{
+    float    *out  = (float *)buffer;
+    uint32_t *next = (uint32_t *)data;
+
+    for (ma_uint32 i = 0; i < frames; i++, (*next)++)
+    {
+        out[i * 2 + 0] = (float)*next;
+        out[i * 2 + 1] = -(float)*next;
+    }
+}
+
+static void SelfCheckRead(ma_pcm_rb *ring, uint32_t want, uint32_t expect, uint32_t *first)
+{
+    std::vector<float> buffer(want * kSoundOutputChannels);
+
+    uint32_t got = ReadSoundOutputRing(ring, buffer.data(), want);
+
+    if (got != expect)
+        FatalError("SoundOutputSelfCheck: read of %u frames got %u, expected %u\n", want, got, expect);
+
+    for (uint32_t i = 0; i < got; i++, (*first)++)
+    {
+        if (buffer[i * 2 + 0] != (float)*first || buffer[i * 2 + 1] != -(float)*first)
+            FatalError("SoundOutputSelfCheck: frame %u came back out of order\n", *first);
+    }
+}
+
+static void SelfCheckFill(ma_pcm_rb *ring, uint32_t *next, ma_uint32 expect)
+{
+    ma_uint32 dropped = 0;
+    ma_uint32 written = FillSoundOutputRing(ring, MixSelfCheckRamp, next, &dropped);
+
+    if (written != expect || dropped != 0)
+    {
+        FatalError("SoundOutputSelfCheck: fill wrote %u frames (%u dropped), expected %u\n", written, dropped,
+                   expect);
+    }
+}
+
+void SoundOutputSelfCheck(void)
+{
+    static constexpr ma_uint32 kRingFrames = 256;
+
+    ma_pcm_rb ring;
+
+    if (ma_pcm_rb_init(ma_format_f32, kSoundOutputChannels, kRingFrames, nullptr, nullptr, &ring) != MA_SUCCESS)
+        FatalError("SoundOutputSelfCheck: unable to create the ring\n");
+
+    uint32_t written = 0;
+    uint32_t read    = 0;
+
+    // empty ring: everything the reader asks for is an underrun
+    SelfCheckRead(&ring, 64, 0, &read);
+
+    SelfCheckFill(&ring, &written, kRingFrames);
+
+    // a full ring is left alone rather than counted as lost audio
+    SelfCheckFill(&ring, &written, 0);
+
+    SelfCheckRead(&ring, 100, 100, &read);
+
+    // the free space now wraps around the end of the ring
+    SelfCheckFill(&ring, &written, 100);
+
+    // asking for more than is there hands back what it has, in order
+    SelfCheckRead(&ring, 300, kRingFrames, &read);
+    SelfCheckRead(&ring, 1, 0, &read);
+
+    // and several small reads against a refill in between
+    SelfCheckFill(&ring, &written, kRingFrames);
+    SelfCheckRead(&ring, 7, 7, &read);
+    SelfCheckRead(&ring, 200, 200, &read);
+    SelfCheckFill(&ring, &written, 207);
+    SelfCheckRead(&ring, kRingFrames + 1, kRingFrames, &read);
+
+    if (read != written)
+        FatalError("SoundOutputSelfCheck: %u frames written but %u read\n", written, read);
+
+    ma_pcm_rb_uninit(&ring);
+}
+
+#else
+
+void SoundOutputSelfCheck(void)
+{
+    // only done by debug builds
+}
+
+#endif
+
+void GetSoundOutputStats(SoundOutputStats &stats)
+{
+    EPI_CLEAR_MEMORY(&stats, SoundOutputStats, 1);
+
+    if (!SoundOutputIsExternal())
+        return;
+
+    stats.buffer_frames   = sound_output_frames;
+    stats.queued_frames   = ma_pcm_rb_available_read(&sound_output_ring);
+    stats.read_frames     = thread_atomic_int_load(&sound_output_read_frames);
+    stats.underruns       = thread_atomic_int_load(&sound_output_underruns);
+    stats.underrun_frames = thread_atomic_int_load(&sound_output_underrun_frames);
+    stats.dropped_frames  = thread_atomic_int_load(&sound_output_dropped_frames);
+}
+
 void StartupAudio(void)
 {
     if (no_sound)
         return;
 
-    if (ma_engine_init(NULL, &sound_engine) != MA_SUCCESS)
+#ifdef GD_PLATFORM_GODOT
+    sound_output_external = true;
+#else
+    sound_output_external = (FindArgument("nosounddevice") > 0);
+#endif
+
+    ma_engine_config engine_config = ma_engine_config_init();
+
+    if (sound_output_external)
+    {
+        engine_config.noDevice   = MA_TRUE;
+        engine_config.channels   = kSoundOutputChannels;
+        engine_config.sampleRate = kSoundOutputSampleRate;
+
+        if (!StartupSoundOutputRing())
+        {
+            LogPrint("StartupSound: Unable to create the output ring!\n");
+            no_sound = true;
+            return;
+        }
+    }
+
+    if (ma_engine_init(&engine_config, &sound_engine) != MA_SUCCESS)
     {
+        if (sound_output_external)
+            ma_pcm_rb_uninit(&sound_output_ring);
+
         LogPrint("StartupSound: Unable to initialize sound engine!\n");
         no_sound = true;
         return;
@@ -82,6 +407,8 @@ void StartupAudio(void)
         if (ma_sound_group_init(&sound_engine, 0, NULL, &sfx_node) != MA_SUCCESS)
         {
             ma_engine_uninit(&sound_engine);
+            if (sound_output_external)
+                ma_pcm_rb_uninit(&sound_output_ring);
             LogPrint("StartupSound: Unable to initialize sound engine!\n");
             no_sound = true;
             return;
@@ -122,6 +449,9 @@ void StartupAudio(void)
     LogPrint("StartupSound: Success @ %d Hz, %d channels\n", sound_device_frequency,
              ma_engine_get_channels(&sound_engine));
 
+    if (sound_output_external)
+        LogPrint("StartupSound: No device, host drains a %d frame ring\n", sound_output_buffer.d_);
+
     return;
 }
 
@@ -132,6 +462,17 @@ void AudioShutdown(void)
 
     ShutdownSound();
 
+    if (sound_output_external)
+    {
+        SoundOutputStats stats;
+        GetSoundOutputStats(stats);
+
+        LogPrint("AudioShutdown: %d frames read from the output ring, %d underruns (%d frames), %d frames dropped\n",
+                 stats.read_frames, stats.underruns, stats.underrun_frames, stats.dropped_frames);
+
+        ma_pcm_rb_uninit(&sound_output_ring);
+    }
+
     no_sound = true;
 }
 
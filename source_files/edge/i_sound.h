@@ -34,4 +34,31 @@ extern ma_freeverb_node reverb_node;
 extern ma_delay_node    underwater_node;
 extern ma_lpf_node      vacuum_node;
 extern bool             sector_reverb; // true if we are in a sector with DDF reverb
-extern ConsoleVariable  dynamic_reverb;
\ No newline at end of file
+extern ConsoleVariable  dynamic_reverb;
+
+// Host driven output.  With -nosounddevice (always in the Godot build)
+// the engine opens no device of its own: PumpSoundOutput, called by the
+// engine loop, mixes into a lock-free ring of interleaved stereo floats,
+// and the host's audio stream drains it with ReadSoundOutput.  The ring
+// has one producer and one consumer, which may be different threads.
+// Builds without a host (SDL, null) drain the ring themselves.
+struct SoundOutputStats
+{
+    uint32_t buffer_frames;   // ring capacity
+    uint32_t queued_frames;   // mixed and not yet read
+    int      read_frames;     // taken out of the ring by reads
+    int      underruns;       // reads which found too few frames
+    int      underrun_frames; // silence handed out for them
+    int      dropped_frames;  // mixed but never made it into the ring
+};
+
+extern ConsoleVariable sound_output_buffer;
+
+bool     SoundOutputIsExternal(void);
+void     PumpSoundOutput(void);
+uint32_t ReadSoundOutput(float *interleaved, uint32_t frames);
+void     GetSoundOutputStats(SoundOutputStats &stats);
+
+// debug builds run the fill and read paths against a small ring, through
+// wrap-around, underrun and a full ring, and FatalError on any mismatch.
+void SoundOutputSelfCheck(void);
\ No newline at end of file
@@ -96,6 +96,9 @@ int PureRandomNumber(void);
 // The starting value should be close to zero.
 int GetTime(void);
 
+// Converts a GetMilliseconds() value into GetTime() units.
+int TicsFromMilliseconds(uint32_t milliseconds);
+
 // Returns a value that increases by 1000 every second (i.e. each unit is
 // a single millisecond).  This timer begins at zero when the application
 // is first begun, hence it won't normally overflow (unless the engine
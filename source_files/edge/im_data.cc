@@ -26,6 +26,27 @@
 #include "epi.h"
 #include "epi_color.h"
 
+// SSE2 is always there on x86-64, other targets use the plain loops
+// (which are written so the compiler can vectorise them).
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define EDGE_IMAGE_SSE2
+#include <emmintrin.h>
+
+// copy one channel of each 16-bit RGBA pixel to all four lanes
+template <int kChannel> static inline __m128i SplatChannel16(__m128i c)
+{
+    c = _mm_shufflelo_epi16(c, _MM_SHUFFLE(kChannel, kChannel, kChannel, kChannel));
+    return _mm_shufflehi_epi16(c, _MM_SHUFFLE(kChannel, kChannel, kChannel, kChannel));
+}
+
+// debug builds can turn the SSE2 paths off, see ImageDataSelfCheck()
+#ifdef NDEBUG
+static constexpr bool image_sse2_paths = true;
+#else
+static bool image_sse2_paths = true;
+#endif
+#endif
+
 ImageData::ImageData(int width, int height, int depth)
     : width_(width), height_(height), depth_(depth), used_width_(width), used_height_(height)
 {
@@ -51,18 +72,52 @@ void ImageData::Whiten()
 {
     EPI_ASSERT(depth_ >= 3);
 
-    for (int y = 0; y < height_; y++)
-        for (int x = 0; x < width_; x++)
+    uint8_t *src   = pixels_;
+    uint8_t *s_end = src + (width_ * height_ * depth_);
+
+#ifdef EDGE_IMAGE_SSE2
+    if (depth_ == 4 && image_sse2_paths)
+    {
+        // four pixels at a time, widened to 16 bits.  The largest value
+        // is 255 * 196 + 765 * 20 = 65280, so nothing overflows.
+        const __m128i zero       = _mm_setzero_si128();
+        const __m128i alpha_mask = _mm_set_epi16(-1, 0, 0, 0, -1, 0, 0, 0);
+        const __m128i k196       = _mm_set1_epi16(196);
+        const __m128i k20        = _mm_set1_epi16(20);
+
+        for (; src + 16 <= s_end; src += 16)
         {
-            uint8_t *src = PixelAt(x, y);
+            __m128i pix       = _mm_loadu_si128((const __m128i *)src);
+            __m128i halves[2] = {_mm_unpacklo_epi8(pix, zero), _mm_unpackhi_epi8(pix, zero)};
+
+            for (__m128i &c : halves)
+            {
+                __m128i r = SplatChannel16<0>(c);
+                __m128i g = SplatChannel16<1>(c);
+                __m128i b = SplatChannel16<2>(c);
 
-            int ity = HMM_MAX(src[0], HMM_MAX(src[1], src[2]));
+                __m128i ity = _mm_max_epi16(r, _mm_max_epi16(g, b));
+                __m128i sum = _mm_add_epi16(r, _mm_add_epi16(g, b));
 
-            // soften the above equation, take average into account
-            ity = (ity * 196 + src[0] * 20 + src[1] * 20 + src[2] * 20) >> 8;
+                ity = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(ity, k196), _mm_mullo_epi16(sum, k20)), 8);
 
-            src[0] = src[1] = src[2] = ity;
+                c = _mm_or_si128(_mm_andnot_si128(alpha_mask, ity), _mm_and_si128(alpha_mask, c));
+            }
+
+            _mm_storeu_si128((__m128i *)src, _mm_packus_epi16(halves[0], halves[1]));
         }
+    }
+#endif
+
+    for (; src < s_end; src += depth_)
+    {
+        int ity = HMM_MAX(src[0], HMM_MAX(src[1], src[2]));
+
+        // soften the above equation, take average into account
+        ity = (ity * 196 + src[0] * 20 + src[1] * 20 + src[2] * 20) >> 8;
+
+        src[0] = src[1] = src[2] = ity;
+    }
 }
 
 void ImageData::Invert()
@@ -161,6 +216,47 @@ void ImageData::Shrink(int new_w, int new_h)
                 dest_pix[2] = b / total;
             }
     }
+    else if (step_x == 2 && step_y == 2)
+    {
+        // the usual case: halving an RGBA image for the next mip level.
+        // Note that the output never overtakes the rows being read.
+        for (int dy = 0; dy < new_h; dy++)
+        {
+            const uint8_t *row_a    = PixelAt(0, dy * 2);
+            const uint8_t *row_b    = PixelAt(0, dy * 2 + 1);
+            uint8_t       *dest_pix = pixels_ + dy * new_w * 4;
+
+            int dx = 0;
+
+#ifdef EDGE_IMAGE_SSE2
+            const __m128i zero = _mm_setzero_si128();
+
+            for (; image_sse2_paths && dx + 2 <= new_w; dx += 2, row_a += 16, row_b += 16, dest_pix += 8)
+            {
+                __m128i a = _mm_loadu_si128((const __m128i *)row_a);
+                __m128i b = _mm_loadu_si128((const __m128i *)row_b);
+
+                // vertical sums, two source pixels in each register
+                __m128i lo = _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero));
+                __m128i hi = _mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero));
+
+                // horizontal sums
+                lo = _mm_add_epi16(lo, _mm_srli_si128(lo, 8));
+                hi = _mm_add_epi16(hi, _mm_srli_si128(hi, 8));
+
+                __m128i avg = _mm_srli_epi16(_mm_unpacklo_epi64(lo, hi), 2);
+
+                _mm_storel_epi64((__m128i *)dest_pix, _mm_packus_epi16(avg, avg));
+            }
+#endif
+
+            for (; dx < new_w; dx++, row_a += 8, row_b += 8, dest_pix += 4)
+            {
+                for (int c = 0; c < 4; c++)
+                    dest_pix[c] = (row_a[c] + row_a[c + 4] + row_b[c] + row_b[c + 4]) / 4;
+            }
+        }
+    }
     else /* depth_ == 4 */
     {
         for (int dy = 0; dy < new_h; dy++)
@@ -213,6 +309,48 @@ void ImageData::ShrinkMasked(int new_w, int new_h)
     int step_y = height_ / new_h;
     int total  = step_x * step_y;
 
+    if (step_x == 2 && step_y == 2)
+    {
+        // halving for the next mip level, unrolled
+        for (int dy = 0; dy < new_h; dy++)
+        {
+            const uint8_t *row_a    = PixelAt(0, dy * 2);
+            const uint8_t *row_b    = PixelAt(0, dy * 2 + 1);
+            uint8_t       *dest_pix = pixels_ + dy * new_w * 4;
+
+            for (int dx = 0; dx < new_w; dx++, row_a += 8, row_b += 8, dest_pix += 4)
+            {
+                int w0 = row_a[3];
+                int w1 = row_a[7];
+                int w2 = row_b[3];
+                int w3 = row_b[7];
+                int a  = w0 + w1 + w2 + w3;
+
+                if (a == 0)
+                {
+                    dest_pix[0] = dest_pix[1] = dest_pix[2] = dest_pix[3] = 0;
+                    continue;
+                }
+
+                int r = row_a[0] * w0 + row_a[4] * w1 + row_b[0] * w2 + row_b[4] * w3;
+                int g = row_a[1] * w0 + row_a[5] * w1 + row_b[1] * w2 + row_b[5] * w3;
+                int b = row_a[2] * w0 + row_a[6] * w1 + row_b[2] * w2 + row_b[6] * w3;
+
+                dest_pix[0] = r / a;
+                dest_pix[1] = g / a;
+                dest_pix[2] = b / a;
+                dest_pix[3] = a / 4;
+            }
+        }
+
+        used_width_  = HMM_MAX(1, used_width_ * new_w / width_);
+        used_height_ = HMM_MAX(1, used_height_ * new_h / height_);
+
+        width_  = new_w;
+        height_ = new_h;
+        return;
+    }
+
     for (int dy = 0; dy < new_h; dy++)
         for (int dx = 0; dx < new_w; dx++)
         {
@@ -285,10 +423,22 @@ void ImageData::SetAlpha(int alphaness)
     }
     else
     {
-        for (int i = 3; i < width_ * height_ * 4; i += 4)
+        uint8_t *src   = pixels_;
+        uint8_t *s_end = src + (width_ * height_ * 4);
+
+#ifdef EDGE_IMAGE_SSE2
+        const __m128i alpha_mask = _mm_set1_epi32((int)0xFF000000);
+        const __m128i alpha      = _mm_set1_epi32((int)((uint32_t)(uint8_t)alphaness << 24));
+
+        for (; image_sse2_paths && src + 16 <= s_end; src += 16)
         {
-            pixels_[i] = alphaness;
+            __m128i pix = _mm_loadu_si128((const __m128i *)src);
+            _mm_storeu_si128((__m128i *)src, _mm_or_si128(_mm_andnot_si128(alpha_mask, pix), alpha));
         }
+#endif
+
+        for (; src < s_end; src += 4)
+            src[3] = alphaness;
     }
 }
 
@@ -300,6 +450,22 @@ void ImageData::ThresholdAlpha(uint8_t alpha)
     uint8_t *src   = pixels_;
     uint8_t *s_end = src + (width_ * height_ * depth_);
 
+#ifdef EDGE_IMAGE_SSE2
+    const __m128i alpha_mask = _mm_set1_epi32((int)0xFF000000);
+    const __m128i limit      = _mm_set1_epi8((char)alpha);
+
+    for (; image_sse2_paths && src + 16 <= s_end; src += 16)
+    {
+        __m128i pix = _mm_loadu_si128((const __m128i *)src);
+
+        // 0xFF wherever pix >= alpha
+        __m128i solid = _mm_cmpeq_epi8(_mm_max_epu8(pix, limit), pix);
+
+        pix = _mm_or_si128(_mm_andnot_si128(alpha_mask, pix), _mm_and_si128(alpha_mask, solid));
+        _mm_storeu_si128((__m128i *)src, pix);
+    }
+#endif
+
     for (; src < s_end; src += 4)
     {
         src[3] = (src[3] < alpha) ? 0 : 255;
@@ -665,5 +831,84 @@ void ImageData::SetHSV(int rotation, int saturation, int value)
         }
 }
 
+//----------------------------------------------------------------------------
+
+#if defined(EDGE_IMAGE_SSE2) && !defined(NDEBUG)
+
+static uint8_t SelfCheckRandom(uint32_t &seed)
+{
+    seed = seed * 1664525 + 1013904223;
+    return (uint8_t)(seed >> 24);
+}
+
+static void SelfCheckKernel(const char *name, int w, int h, int depth, uint32_t &seed, void (*kernel)(ImageData *))
+{
+    ImageData fast(w, h, depth);
+    ImageData plain(w, h, depth);
+
+    for (int i = 0; i < w * h * depth; i++)
+    {
+        uint8_t value = SelfCheckRandom(seed);
+
+        // alpha is mostly 0 or 255 in real images, make sure both get hit
+        if (depth == 4 && (i & 3) == 3 && (value & 1))
+            value = (value & 2) ? 255 : 0;
+
+        fast.pixels_[i] = value;
+    }
+
+    memcpy(plain.pixels_, fast.pixels_, w * h * depth);
+
+    kernel(&fast);
+
+    image_sse2_paths = false;
+    kernel(&plain);
+    image_sse2_paths = true;
+
+    if (fast.width_ != plain.width_ || fast.height_ != plain.height_ || fast.depth_ != plain.depth_ ||
+        fast.used_width_ != plain.used_width_ || fast.used_height_ != plain.used_height_ ||
+        memcmp(fast.pixels_, plain.pixels_, fast.width_ * fast.height_ * fast.depth_) != 0)
+    {
+        FatalError("ImageDataSelfCheck: SSE2 %s differs from the plain loop (%dx%d depth %d)\n", name, w, h,
+                   depth);
+    }
+}
+
+void ImageDataSelfCheck(void)
+{
+    // sizes with and without a tail after the last group of four pixels
+    static constexpr int kSizes[][2] = {{1, 1}, {2, 2}, {3, 5}, {4, 4}, {7, 3}, {16, 16}, {33, 17}, {64, 128}};
+
+    // Shrink() wants powers of two
+    static constexpr int kShrinkSizes[][2] = {{2, 2}, {4, 2}, {4, 4}, {8, 32}, {64, 64}, {256, 128}};
+
+    uint32_t seed = 0x2545F491;
+
+    for (const int *size : kSizes)
+    {
+        SelfCheckKernel("Whiten", size[0], size[1], 4, seed, [](ImageData *img) { img->Whiten(); });
+        SelfCheckKernel("SetAlpha", size[0], size[1], 4, seed, [](ImageData *img) { img->SetAlpha(77); });
+        SelfCheckKernel("ThresholdAlpha", size[0], size[1], 4, seed,
+                        [](ImageData *img) { img->ThresholdAlpha(144); });
+        SelfCheckKernel("ThresholdAlpha", size[0], size[1], 4, seed,
+                        [](ImageData *img) { img->ThresholdAlpha(96); });
+    }
+
+    for (const int *size : kShrinkSizes)
+    {
+        SelfCheckKernel("Shrink", size[0], size[1], 4, seed,
+                        [](ImageData *img) { img->Shrink(img->width_ / 2, img->height_ / 2); });
+    }
+}
+
+#else
+
+void ImageDataSelfCheck(void)
+{
+    // only done by debug builds with the SSE2 paths
+}
+
+#endif
+
 //--- editor settings ---
 // vi:ts=4:sw=4:noexpandtab
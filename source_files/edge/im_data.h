@@ -127,5 +127,9 @@ class ImageData
     void SetHSV(int rotation, int saturation, int value);
 };
 
+// debug builds check the SSE2 kernels against the plain loops on random
+// images, and fail with a FatalError if they ever differ.
+void ImageDataSelfCheck(void);
+
 //--- editor settings ---
 // vi:ts=4:sw=4:noexpandtab
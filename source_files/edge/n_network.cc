@@ -98,6 +98,7 @@ static void PreInput()
 {
     // process input
     gd::Platform::ControlGetEvents();
+    TakeQueuedInputEvents(INT_MAX);
     ProcessInputEvents();
 }
 
@@ -181,7 +182,7 @@ int NetworkUpdate()
     int new_tics    = now_time - last_update_tic;
     last_update_tic = now_time;
 
-    if (new_tics > 0)
+    if (new_tics > 0 && !HaveQueuedInputEvents())
     {
         PreInput();
 
@@ -194,13 +195,38 @@ int NetworkUpdate()
 
         PostInput();
     }
+    else if (new_tics > 0)
+    {
+        // events queued by the host carry a timestamp (SDL ones don't),
+        // so build the ticcmds one at a time, each seeing only the events
+        // which happened up to its tic.
+
+        gd::Platform::ControlGetEvents();
+
+        for (int tic = now_time - new_tics + 1; tic <= now_time; tic++)
+        {
+            TakeQueuedInputEvents(tic);
+            ProcessInputEvents();
+
+            if (!NetworkBuildTicCommands())
+                break;
+
+            UpdateKeyState();
+        }
+
+        // responders still get whatever is left
+        TakeQueuedInputEvents(now_time);
+        ProcessInputEvents();
+
+        PostInput();
+    }
 
     return now_time;
 }
 
 int TryRunTicCommands()
 {
-    EDGE_ZoneScoped;
+    EDGE_ProfileZone("TryRunTicCommands");
 
     if (single_tics)
     {
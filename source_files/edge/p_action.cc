@@ -1035,32 +1035,8 @@ void A_MakeIntoCorpse(MapObject *mo)
     // object is on ground, it can be walked over
     mo->flags_ &= ~kMapObjectFlagSolid;
 
-    if (mo->tag_)
-    {
-        auto mobjs = active_tagged_map_objects.equal_range(mo->tag_);
-        for (auto mobj = mobjs.first; mobj != mobjs.second;)
-        {
-            if (mobj->second == mo)
-                mobj = active_tagged_map_objects.erase(mobj);
-            else
-                ++mobj;
-        }
-    }
-
-    if (mo->tid_)
-    {
-        auto mobjs = active_tids.equal_range(mo->tid_);
-        for (auto mobj = mobjs.first; mobj != mobjs.second;)
-        {
-            if (mobj->second == mo)
-                mobj = active_tids.erase(mobj);
-            else
-                ++mobj;
-        }
-    }
-
-    mo->tag_ = 0;
-    mo->tid_ = 0;
+    MapObjectSetTag(mo, 0);
+    MapObjectSetTID(mo, 0);
 
     HitLiquidFloor(mo);
 }
@@ -1082,8 +1058,8 @@ void BringCorpseToLife(MapObject *corpse)
     // UDMF check
     if (!AlmostEquals(corpse->alpha_, 1.0f))
         corpse->target_visibility_ = corpse->alpha_;
-    corpse->tag_ = corpse->spawnpoint_.tag;
-    corpse->tid_ = corpse->spawnpoint_.tid;
+    MapObjectSetTag(corpse, corpse->spawnpoint_.tag);
+    MapObjectSetTID(corpse, corpse->spawnpoint_.tid);
 
     corpse->flags_ &= ~kMapObjectFlagCountKill; // Lobo 2023: don't add to killcount
 
@@ -2906,14 +2882,8 @@ static void ObjectSpawning(MapObject *parent, BAMAngle angle)
                    parent->info_->name_.c_str(), attack->name_.c_str());
     }
 
-    if (attack->spawn_limit_ > 0)
-    {
-        int count = 0;
-        for (MapObject *mo = map_object_list_head; mo; mo = mo->next_)
-            if (mo->info_ == shoottype)
-                if (++count >= attack->spawn_limit_)
-                    return;
-    }
+    if (attack->spawn_limit_ > 0 && CountMapObjectsOfType(shoottype) >= attack->spawn_limit_)
+        return;
 
     // -AJA- 1999/09/10: apply the angle offset of the attack.
     angle -= attack->angle_offset_;
@@ -4122,14 +4092,11 @@ void A_KeenDie(MapObject *mo)
     A_MakeIntoCorpse(mo);
 
     // see if all other Keens are dead
-    for (MapObject *cur = map_object_list_head; cur != nullptr; cur = cur->next_)
+    for (MapObject *cur = FirstMapObjectOfType(mo->info_); cur != nullptr; cur = cur->type_next_)
     {
         if (cur == mo)
             continue;
 
-        if (cur->info_ != mo->info_)
-            continue;
-
         if (cur->health_ > 0)
             return; // other Keen not dead
     }
@@ -4347,7 +4314,7 @@ void A_Become(MapObject *mo)
 
     UnsetThingPosition(mo);
     {
-        mo->info_ = become->info_;
+        MapObjectSetType(mo, become->info_);
 
         mo->morph_timeout_ = mo->info_->morphtimeout_;
 
@@ -4422,7 +4389,7 @@ void A_UnBecome(MapObject *mo)
 
     UnsetThingPosition(mo);
     {
-        mo->info_ = preBecome;
+        MapObjectSetType(mo, preBecome);
 
         mo->morph_timeout_ = mo->info_->morphtimeout_;
 
@@ -4500,7 +4467,7 @@ void A_Morph(MapObject *mo)
 
     UnsetThingPosition(mo);
     {
-        mo->info_   = morph->info_;
+        MapObjectSetType(mo, morph->info_);
         mo->health_ = mo->info_->spawn_health_; // Set health to full again
 
         mo->morph_timeout_ = mo->info_->morphtimeout_;
@@ -4576,7 +4543,7 @@ void A_UnMorph(MapObject *mo)
 
     UnsetThingPosition(mo);
     {
-        mo->info_ = preBecome;
+        MapObjectSetType(mo, preBecome);
 
         mo->health_ = mo->info_->spawn_health_; // Set health to max again
 
@@ -548,11 +548,15 @@ void SetThingPosition(MapObject *mo)
         }
     }
 
+    // remember the cell for thinker LOD, even when not linked in
+    mo->think_block_x_ = BlockmapGetX(mo->x);
+    mo->think_block_y_ = BlockmapGetY(mo->y);
+
     // link into blockmap
     if (!(mo->flags_ & kMapObjectFlagNoBlockmap))
     {
-        blockx = BlockmapGetX(mo->x);
-        blocky = BlockmapGetY(mo->y);
+        blockx = mo->think_block_x_;
+        blocky = mo->think_block_y_;
 
         if (blockx >= 0 && blockx < blockmap_width && blocky >= 0 && blocky < blockmap_height)
         {
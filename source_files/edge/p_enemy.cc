@@ -580,8 +580,8 @@ MapObject *LookForShootSpot(const MapObjectDefinition *spot_type)
 
     std::vector<MapObject *> spots;
 
-    for (MapObject *cur = map_object_list_head; cur != nullptr; cur = cur->next_)
-        if (cur->info_ == spot_type && !cur->IsRemoved())
+    for (MapObject *cur = FirstMapObjectOfType(spot_type); cur != nullptr; cur = cur->type_next_)
+        if (!cur->IsRemoved())
             spots.push_back(cur);
 
     if (spots.empty())
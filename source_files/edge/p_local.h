@@ -112,11 +112,20 @@ extern RespawnQueueItem *respawn_queue_head;
 extern MapObject *map_object_list_head;
 
 void RemoveMapObject(MapObject *th);
+void MapObjectSetTag(MapObject *mobj, int tag);
+void MapObjectSetTID(MapObject *mobj, int tid);
+void MapObjectSetType(MapObject *mobj, const MapObjectDefinition *info);
+void RelinkMapObjectTypes(void);
+
+// objects of one type, in mobj list order; follow type_next_
+MapObject *FirstMapObjectOfType(const MapObjectDefinition *info);
+int        CountMapObjectsOfType(const MapObjectDefinition *info);
 int  MapObjectFindLabel(MapObject *mobj, const char *label);
 bool MapObjectSetState(MapObject *mobj, int state);
 bool MapObjectSetStateDeferred(MapObject *mobj, int state, int tic_skip);
 void MapObjectSetDirectionAndSpeed(MapObject *mobj, BAMAngle angle, float slope, float speed);
 void RunMapObjectThinkers();
+bool MapObjectActsThisTic(const MapObject *mo);
 void SpawnDebris(float x, float y, float z, BAMAngle angle, const MapObjectDefinition *debris);
 void SpawnPuff(float x, float y, float z, const MapObjectDefinition *puff, BAMAngle angle);
 void SpawnBlood(float x, float y, float z, float damage, BAMAngle angle, const MapObjectDefinition *blood);
@@ -199,6 +208,10 @@ bool       SolidSectorMove(Sector *sec, bool is_ceiling, float dh, int crush = 1
 bool       CheckAbsolutePosition(MapObject *thing, float x, float y, float z);
 bool       CheckSight(MapObject *src, MapObject *dest);
 bool       CheckSightToPoint(MapObject *src, float x, float y, float z);
+void       SightGeometryChanged(void);
+void       BeginSightPrepass(bool time_stop);
+void       FinishSightPrepass(void);
+void       ShutdownSightPrepass(void);
 void       RadiusAttack(MapObject *spot, MapObject *source, float radius, float damage, const DamageClass *damtype,
                         bool thrust_only);
 
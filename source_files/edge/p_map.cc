@@ -2024,6 +2024,8 @@ void UnblockLineEffectDebris(Line *TheLine, const LineType *special)
         return;
     }
 
+    SightGeometryChanged();
+
     bool TwoSided = false;
 
     if (TheLine->side[0] && TheLine->side[1])
@@ -2915,6 +2917,8 @@ bool SolidSectorMove(Sector *sec, bool is_ceiling, float dh, int crush, bool noc
     // first update real sector
     //
 
+    SightGeometryChanged();
+
     if (is_ceiling)
         sec->ceiling_height += dh;
     else
@@ -431,6 +431,8 @@ void ComputeGaps(Line *ld)
     Sector *front = ld->front_sector;
     Sector *back  = ld->back_sector;
 
+    SightGeometryChanged();
+
     bool        has_temp_gap;
     VerticalGap temp_gap;
 
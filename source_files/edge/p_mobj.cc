@@ -51,6 +51,10 @@
 
 #include "p_mobj.h"
 
+#include <limits.h>
+#include <stdlib.h>
+
+#include <algorithm>
 #include <list>
 
 #include "AlmostEquals.h"
@@ -93,9 +97,9 @@ MapObject *map_object_list_head;
 RespawnQueueItem *respawn_queue_head;
 
 // List of tagged mobjs
-std::multimap<int, MapObject *> active_tagged_map_objects;
-std::multimap<int, MapObject *> active_tids;
-int                             next_available_tid = 1;
+std::unordered_map<int, std::vector<MapObject *>> active_tagged_map_objects;
+std::unordered_map<int, std::vector<MapObject *>> active_tids;
+int                                               next_available_tid = 1;
 
 // List of mobj types actually seen in this map
 // (help avoid wait until dead scripts that would never fire, etc)
@@ -103,12 +107,64 @@ std::unordered_set<const MapObjectDefinition *> seen_monsters;
 
 bool time_stop_active = false;
 
+// thinker LOD counts for the last tic (shown by debug_fps 3)
+int thinkers_run      = 0;
+int thinkers_deferred = 0;
+
 static int MapObjectGetTID()
 {
     next_available_tid++;
     return next_available_tid - 1;
 }
 
+static void ReplaceTaggedMapObject(std::unordered_map<int, std::vector<MapObject *>> &table, int old_tag,
+                                   int new_tag, MapObject *mobj)
+{
+    if (old_tag)
+    {
+        auto find = table.find(old_tag);
+
+        if (find != table.end())
+        {
+            // keep the others in order, scripts may rely on it
+            std::vector<MapObject *> &mobjs = find->second;
+
+            auto iter = std::find(mobjs.begin(), mobjs.end(), mobj);
+
+            if (iter != mobjs.end())
+                mobjs.erase(iter);
+
+            if (mobjs.empty())
+                table.erase(find);
+        }
+    }
+
+    if (new_tag)
+        table[new_tag].push_back(mobj);
+}
+
+//
+// Changes the tag or TID of a thing, keeping the tagged lists which RTS
+// and Lua look things up in up to date.  Zero removes it from the list.
+//
+void MapObjectSetTag(MapObject *mobj, int tag)
+{
+    if (mobj->tag_ != tag)
+    {
+        ReplaceTaggedMapObject(active_tagged_map_objects, mobj->tag_, tag, mobj);
+        mobj->tag_ = tag;
+    }
+}
+
+void MapObjectSetTID(MapObject *mobj, int tid)
+{
+    if (mobj->tid_ != tid)
+    {
+        ReplaceTaggedMapObject(active_tids, mobj->tid_, tid, mobj);
+        mobj->tid_ = tid;
+    }
+}
+
 static void AddItemToQueue(const MapObject *mo)
 {
     // only respawn items in deathmatch or forced by level flags
@@ -423,8 +479,9 @@ static void TeleportRespawn(MapObject *mobj)
     new_mo->spawnpoint_     = mobj->spawnpoint_;
     new_mo->angle_          = mobj->spawnpoint_.angle;
     new_mo->vertical_angle_ = mobj->spawnpoint_.vertical_angle;
-    new_mo->tag_            = mobj->spawnpoint_.tag;
-    new_mo->tid_            = mobj->spawnpoint_.tid;
+
+    MapObjectSetTag(new_mo, mobj->spawnpoint_.tag);
+    MapObjectSetTID(new_mo, mobj->spawnpoint_.tid);
 
     if (mobj->spawnpoint_.flags & kMapObjectFlagAmbush)
         new_mo->flags_ |= kMapObjectFlagAmbush;
@@ -510,8 +567,8 @@ static void ResurrectRespawn(MapObject *mobj)
     mobj->SetSource(nullptr);
     mobj->SetTarget(nullptr);
 
-    mobj->tag_ = mobj->spawnpoint_.tag;
-    mobj->tid_ = mobj->spawnpoint_.tid;
+    MapObjectSetTag(mobj, mobj->spawnpoint_.tag);
+    MapObjectSetTID(mobj, mobj->spawnpoint_.tid);
 
     if (mobj->spawnpoint_.flags & kMapObjectFlagAmbush)
         mobj->flags_ |= kMapObjectFlagAmbush;
@@ -1380,7 +1437,13 @@ static void P_ZMovement(MapObject *mo, const RegionProperties *props)
 //
 // P_MobjThinker
 //
-static void P_MobjThinker(MapObject *mobj)
+// Normally called with tics = 1.  A far away thing which the thinker
+// LOD has held back is called once with all the tics it is owed.  Its
+// timers and states are advanced by that many tics in one go, but its
+// movement is still run a tic at a time (friction, drag and gravity
+// compound), which only costs anything while it is actually moving.
+//
+static void P_MobjThinker(MapObject *mobj, int tics)
 {
     if (mobj->next_ == (MapObject *)-1)
         FatalError("P_MobjThinker INTERNAL ERROR: mobj has been freed");
@@ -1402,6 +1465,9 @@ static void P_MobjThinker(MapObject *mobj)
     RegionProperties        mobj_props;
     const RegionProperties *props = &mobj_props;
 
+    // added to the momentum before each tic of movement
+    HMM_Vec3 push = {{0, 0, 0}};
+
     mobj->old_z_       = mobj->z;
     mobj->old_floor_z_ = mobj->floor_z_;
     mobj->on_slope_    = false;
@@ -1411,13 +1477,16 @@ static void P_MobjThinker(MapObject *mobj)
     EPI_ASSERT(mobj->state_);
     EPI_ASSERT(mobj->reference_count_ >= 0);
 
-    mobj->visibility_      = (15 * mobj->visibility_ + mobj->target_visibility_) / 16;
-    mobj->dynamic_light_.r = (15 * mobj->dynamic_light_.r + mobj->dynamic_light_.target) / 16;
+    for (int i = 0; i < tics; i++)
+    {
+        mobj->visibility_      = (15 * mobj->visibility_ + mobj->target_visibility_) / 16;
+        mobj->dynamic_light_.r = (15 * mobj->dynamic_light_.r + mobj->dynamic_light_.target) / 16;
+    }
 
     // position interpolation
     if (mobj->interpolation_number_ > 1)
     {
-        mobj->interpolation_position_++;
+        mobj->interpolation_position_ += tics;
 
         if (mobj->interpolation_position_ >= mobj->interpolation_number_)
         {
@@ -1448,11 +1517,7 @@ static void P_MobjThinker(MapObject *mobj)
         CalculateFullRegionProperties(mobj, &mobj_props);
 
         if (!(mobj->flags_ & kMapObjectFlagNoClip))
-        {
-            mobj->momentum_.X += mobj_props.push.X;
-            mobj->momentum_.Y += mobj_props.push.Y;
-            mobj->momentum_.Z += mobj_props.push.Z;
-        }
+            push = mobj_props.push;
     }
     else
     {
@@ -1497,11 +1562,11 @@ static void P_MobjThinker(MapObject *mobj)
                             }
 
                             if (tn_props.push.X)
-                                mobj->momentum_.X += push_mul * tn_props.push.X;
+                                push.X += push_mul * tn_props.push.X;
                             if (tn_props.push.Y)
-                                mobj->momentum_.Y += push_mul * tn_props.push.Y;
+                                push.Y += push_mul * tn_props.push.Y;
                             if (tn_props.push.Z)
-                                mobj->momentum_.Z += push_mul * tn_props.push.Z;
+                                push.Z += push_mul * tn_props.push.Z;
                         }
                     }
                 }
@@ -1534,25 +1599,46 @@ static void P_MobjThinker(MapObject *mobj)
             mobj->on_slope_ = true;
     }
 
-    if (!AlmostEquals(mobj->momentum_.X, 0.0f) || !AlmostEquals(mobj->momentum_.Y, 0.0f) || mobj->player_)
+    bool pushed = (push.X || push.Y || push.Z);
+
+    for (int i = 0; i < tics; i++)
     {
-        P_XYMovement(mobj, props);
+        mobj->momentum_.X += push.X;
+        mobj->momentum_.Y += push.Y;
+        mobj->momentum_.Z += push.Z;
 
-        if (mobj->IsRemoved())
-            return;
-    }
+        bool moved = false;
 
-    if ((!AlmostEquals(mobj->z, mobj->floor_z_)) || !AlmostEquals(mobj->momentum_.Z, 0.0f)) //  || mobj->ride_em)
-    {
-        P_ZMovement(mobj, props);
+        if (!AlmostEquals(mobj->momentum_.X, 0.0f) || !AlmostEquals(mobj->momentum_.Y, 0.0f) || mobj->player_)
+        {
+            P_XYMovement(mobj, props);
+            moved = true;
 
-        if (mobj->IsRemoved())
-            return;
+            if (mobj->IsRemoved())
+                return;
+        }
+
+        if ((!AlmostEquals(mobj->z, mobj->floor_z_)) || !AlmostEquals(mobj->momentum_.Z, 0.0f)) //  || mobj->ride_em)
+        {
+            P_ZMovement(mobj, props);
+            moved = true;
+
+            if (mobj->IsRemoved())
+                return;
+        }
+
+        // at rest, so the tics left would not move it either
+        if (!moved && !pushed)
+            break;
     }
 
     if (mobj->fuse_ >= 0)
     {
-        if (!--mobj->fuse_)
+        bool expired = (mobj->fuse_ > 0 && mobj->fuse_ <= tics);
+
+        mobj->fuse_ = expired ? 0 : HMM_MAX(-1, mobj->fuse_ - tics);
+
+        if (expired)
             ExplodeMissile(mobj);
 
         if (mobj->IsRemoved())
@@ -1563,7 +1649,11 @@ static void P_MobjThinker(MapObject *mobj)
     //  have one. If there is no MORPH state then the mobj is removed
     if (mobj->health_ > 0 && mobj->morph_timeout_ >= 0)
     {
-        if (!--mobj->morph_timeout_)
+        bool expired = (mobj->morph_timeout_ > 0 && mobj->morph_timeout_ <= tics);
+
+        mobj->morph_timeout_ = expired ? 0 : HMM_MAX(-1, mobj->morph_timeout_ - tics);
+
+        if (expired)
             MapObjectSetState(mobj, mobj->info_->morph_state_);
 
         if (mobj->IsRemoved())
@@ -1585,7 +1675,7 @@ static void P_MobjThinker(MapObject *mobj)
         if (mobj->extended_flags_ & kExtendedFlagNoRespawn)
             return;
 
-        mobj->move_count_++;
+        mobj->move_count_ += tics;
 
         //
         // Uses movecount as a timer, when movecount hits 12*kTicRate the
@@ -1596,8 +1686,8 @@ static void P_MobjThinker(MapObject *mobj)
             return;
 
         // if the first 5 bits of level_time_elapsed are on, don't respawn
-        // now...ok?
-        if (level_time_elapsed & 31)
+        // now...ok?  (a thing catching up checks each tic it missed)
+        if ((level_time_elapsed & 31) >= tics)
             return;
 
         // give a limited "random" chance that respawn don't respawn now
@@ -1618,14 +1708,27 @@ static void P_MobjThinker(MapObject *mobj)
     // -AJA- 1999/09/12: reworked for deferred states.
     // -AJA- 2000/10/17: reworked again.
 
-    for (int loop_count = 0; loop_count < kMaxThinkLoop; loop_count++)
+    // `tics` counts down the tics still to run, including the current one.
+
+    int max_loops = kMaxThinkLoop * tics;
+
+    for (int loop_count = 0; loop_count < max_loops; loop_count++)
     {
-        if (level_flags.fast_monsters)
-            mobj->tics_ -= (1 * (mobj->state_->flags & kStateFrameFlagFast ? 2 : mobj->info_->fast_) + mobj->tic_skip_);
-        else
-            mobj->tics_ -= (1 + mobj->tic_skip_);
+        for (;;)
+        {
+            if (level_flags.fast_monsters)
+                mobj->tics_ -=
+                    (1 * (mobj->state_->flags & kStateFrameFlagFast ? 2 : mobj->info_->fast_) + mobj->tic_skip_);
+            else
+                mobj->tics_ -= (1 + mobj->tic_skip_);
 
-        mobj->tic_skip_ = 0;
+            mobj->tic_skip_ = 0;
+
+            if (mobj->tics_ < 1 || tics == 1)
+                break;
+
+            tics--;
+        }
 
         if (mobj->tics_ >= 1)
             break;
@@ -1638,8 +1741,14 @@ static void P_MobjThinker(MapObject *mobj)
         if (mobj->IsRemoved())
             return;
 
-        if (mobj->tics_ != 0)
+        if (mobj->tics_ == 0)
+            continue;
+
+        // the new state starts counting down on the next owed tic
+        if (mobj->tics_ < 0 || tics == 1)
             break;
+
+        tics--;
     }
 }
 
@@ -1759,6 +1868,118 @@ void ClearAllStaleReferences(void)
     }
 }
 
+//
+// Every object in the mobj list is also linked into a list of the objects
+// sharing its MapObjectDefinition, kept in the same order as the main
+// list, so code which only cares about one kind of thing (boss deaths,
+// brain spots, spawn limits, scripts) needn't look at all the others.
+// Removed objects stay in it for as long as they stay in the main list.
+//
+struct MapObjectTypeList
+{
+    MapObject *head  = nullptr;
+    int        count = 0;
+};
+
+static std::unordered_map<const MapObjectDefinition *, MapObjectTypeList> map_object_types;
+
+static void LinkMobjType(MapObject *mo)
+{
+    MapObjectTypeList &list = map_object_types[mo->info_];
+
+    // find the closest earlier object of this type in the main list,
+    // which for a newly created object is none.
+    MapObject *prev = mo->previous_;
+
+    while (prev != nullptr && prev->info_ != mo->info_)
+        prev = prev->previous_;
+
+    mo->type_previous_ = prev;
+    mo->type_next_     = (prev != nullptr) ? prev->type_next_ : list.head;
+
+    if (mo->type_next_ != nullptr)
+        mo->type_next_->type_previous_ = mo;
+
+    if (prev != nullptr)
+        prev->type_next_ = mo;
+    else
+        list.head = mo;
+
+    list.count++;
+}
+
+static void UnlinkMobjType(MapObject *mo)
+{
+    auto iter = map_object_types.find(mo->info_);
+
+    if (iter == map_object_types.end())
+        return;
+
+    MapObjectTypeList &list = iter->second;
+
+    // not linked (e.g. still being loaded from a savegame)
+    if (mo->type_previous_ == nullptr && list.head != mo)
+        return;
+
+    if (mo->type_previous_ != nullptr)
+        mo->type_previous_->type_next_ = mo->type_next_;
+    else
+        list.head = mo->type_next_;
+
+    if (mo->type_next_ != nullptr)
+        mo->type_next_->type_previous_ = mo->type_previous_;
+
+    mo->type_next_     = nullptr;
+    mo->type_previous_ = nullptr;
+
+    list.count--;
+}
+
+MapObject *FirstMapObjectOfType(const MapObjectDefinition *info)
+{
+    auto iter = map_object_types.find(info);
+
+    return (iter == map_object_types.end()) ? nullptr : iter->second.head;
+}
+
+int CountMapObjectsOfType(const MapObjectDefinition *info)
+{
+    auto iter = map_object_types.find(info);
+
+    return (iter == map_object_types.end()) ? 0 : iter->second.count;
+}
+
+//
+// Changes what kind of thing an object is (BECOME, MORPH, REPLACE_THING),
+// moving it to the list for its new type.
+//
+void MapObjectSetType(MapObject *mobj, const MapObjectDefinition *info)
+{
+    if (mobj->info_ == info)
+        return;
+
+    UnlinkMobjType(mobj);
+    mobj->info_ = info;
+    LinkMobjType(mobj);
+}
+
+//
+// Rebuilds the type lists from the main list, for after a savegame has
+// filled in the info_ fields directly.
+//
+void RelinkMapObjectTypes(void)
+{
+    map_object_types.clear();
+
+    for (MapObject *mo = map_object_list_head; mo != nullptr; mo = mo->next_)
+    {
+        mo->type_next_     = nullptr;
+        mo->type_previous_ = nullptr;
+
+        LinkMobjType(mo);
+    }
+}
+
 static void AddMobjToList(MapObject *mo)
 {
     mo->previous_ = nullptr;
@@ -1773,6 +1994,8 @@ static void AddMobjToList(MapObject *mo)
     map_object_list_head = mo;
     seen_monsters.insert(mo->info_);
 
+    LinkMobjType(mo);
+
 #if (EDGE_DEBUG_MAP_OBJECTS > 0)
     LogDebug("tics=%05d  ADD %p [%s]\n", level_time_elapsed, mo, mo->info_ ? mo->info_->name_.c_str() : "???");
 #endif
@@ -1784,6 +2007,8 @@ static void RemoveMobjFromList(MapObject *mo)
     LogDebug("tics=%05d  REMOVE %p [%s]\n", level_time_elapsed, mo, mo->info_ ? mo->info_->name_.c_str() : "???");
 #endif
 
+    UnlinkMobjType(mo);
+
     if (mo->previous_ != nullptr)
     {
         EPI_ASSERT(mo->previous_->next_ == mo);
@@ -1861,31 +2086,8 @@ void RemoveMapObject(MapObject *mo)
 
     mo->fuse_ = kTicRate * 5;
     // mo->morphtimeout = kTicRate * 5; //maybe we need this?
-    if (mo->tag_)
-    {
-        auto mobjs = active_tagged_map_objects.equal_range(mo->tag_);
-        for (auto mobj = mobjs.first; mobj != mobjs.second;)
-        {
-            if (mobj->second == mo)
-                mobj = active_tagged_map_objects.erase(mobj);
-            else
-                ++mobj;
-        }
-    }
-    mo->tag_ = 0;
-
-    if (mo->tid_)
-    {
-        auto mobjs = active_tids.equal_range(mo->tid_);
-        for (auto mobj = mobjs.first; mobj != mobjs.second;)
-        {
-            if (mobj->second == mo)
-                mobj = active_tids.erase(mobj);
-            else
-                ++mobj;
-        }
-    }
-    mo->tid_ = 0;
+    MapObjectSetTag(mo, 0);
+    MapObjectSetTID(mo, 0);
 }
 
 void RemoveAllMapObjects(bool loading)
@@ -1904,6 +2106,7 @@ void RemoveAllMapObjects(bool loading)
         mo->reference_count_ = 0;
         DeleteMobj(mo);
     }
+    map_object_types.clear();
     active_tagged_map_objects.clear();
     active_tids.clear();
     next_available_tid = 1;
@@ -1920,6 +2123,97 @@ void ClearRespawnQueue(void)
     }
 }
 
+//
+// Thinker LOD.  Things are placed in rings by their blockmap distance
+// (in whole cells, using the larger of the two axes) to the nearest
+// player.  Things further out think less often, and when they do they
+// make one P_MobjThinker call covering every tic they missed.  Timers,
+// fuses, state changes and movement keep to the same tics as thinking
+// each tic would, but only a moving thing pays per tic for it.  The
+// cells are kept by SetThingPosition, so no distances are computed here.
+//
+struct ThinkerLODRing
+{
+    int cells;
+    int period; // in tics, a power of two
+};
+
+static constexpr ThinkerLODRing kThinkerLODRings[] = {
+    {12, 1}, // ~1500 units, the old first step
+    {24, 2},
+    {48, 4},
+};
+
+static constexpr int kThinkerLODFarPeriod = 8;
+
+// cells of every player in the game, which the thinker LOD rings
+// are measured from (all of them, so that net peers agree)
+static MapObject *lod_players[kMaximumPlayers];
+static int        lod_player_count = 0;
+
+static int ThinkerPeriod(const MapObject *mo)
+{
+    if (lod_player_count == 0)
+        return 1;
+
+    int nearest = INT_MAX;
+
+    for (int i = 0; i < lod_player_count; i++)
+    {
+        int dx = abs(mo->think_block_x_ - lod_players[i]->think_block_x_);
+        int dy = abs(mo->think_block_y_ - lod_players[i]->think_block_y_);
+
+        nearest = HMM_MIN(nearest, HMM_MAX(dx, dy));
+    }
+
+    for (const ThinkerLODRing &ring : kThinkerLODRings)
+    {
+        if (nearest < ring.cells)
+            return ring.period;
+    }
+
+    return kThinkerLODFarPeriod;
+}
+
+// the tics a (non-player) thing will be run for this tic, counting the
+// one it is about to sit out, or 0 when the thinker LOD holds it back
+static int ThinkerTicsDue(const MapObject *mo)
+{
+    int owed   = mo->think_debt_ + 1;
+    int period = ThinkerPeriod(mo);
+
+    if (period > 1 && owed < period &&
+        ((level_time_elapsed + mo->think_block_x_ + mo->think_block_y_) & (period - 1)) != 0)
+        return 0;
+
+    return owed;
+}
+
+//
+// True when the thing will think this tic and its current state runs
+// out while it does, so that the next state's action gets called.  It
+// follows the countdown at the end of P_MobjThinker, erring on the side
+// of true.  Only valid once RunMapObjectThinkers has begun the tic.
+//
+bool MapObjectActsThisTic(const MapObject *mo)
+{
+    if (mo->tics_ < 0 || time_stop_active)
+        return false;
+
+    int tics = ThinkerTicsDue(mo);
+
+    if (tics == 0)
+        return false;
+
+    // the countdown truncates, so a fractional speed takes whole tics
+    int step = 1;
+
+    if (level_flags.fast_monsters)
+        step = HMM_MAX(1, (int)ceilf((mo->state_->flags & kStateFrameFlagFast) ? 2.0f : mo->info_->fast_));
+
+    return mo->tics_ - (tics * step + mo->tic_skip_) < 1;
+}
+
 //
 // RunMobjThinkers
 //
@@ -1942,6 +2236,23 @@ void RunMapObjectThinkers()
         }
     }
 
+    lod_player_count = 0;
+
+    if (distance_cull_thinkers.d_)
+    {
+        for (int pnum = 0; pnum < kMaximumPlayers; pnum++)
+        {
+            if (players[pnum] && players[pnum]->map_object_)
+                lod_players[lod_player_count++] = players[pnum]->map_object_;
+        }
+    }
+
+    // read-only sight work for this tic, spread over the sight workers
+    BeginSightPrepass(time_stop_active);
+
+    thinkers_run      = 0;
+    thinkers_deferred = 0;
+
     for (mo = map_object_list_head; mo != nullptr; mo = next)
     {
         next = mo->next_;
@@ -1962,20 +2273,33 @@ void RunMapObjectThinkers()
         }
 
         if (mo->player_)
-            P_MobjThinker(mo);
+        {
+            P_MobjThinker(mo, 1);
+            thinkers_run++;
+        }
         else
         {
             if (time_stop_active)
                 continue;
-            if (!distance_cull_thinkers.d_ ||
-                (game_tic / 2 %
-                     RoundToInteger(1 + PointToDistance(players[console_player]->map_object_->x,
-                                                        players[console_player]->map_object_->y, mo->x, mo->y) /
-                                            1500) ==
-                 0))
-                P_MobjThinker(mo);
+
+            int owed = ThinkerTicsDue(mo);
+
+            if (owed == 0)
+            {
+                mo->think_debt_++;
+                thinkers_deferred++;
+                continue;
+            }
+
+            // catch up on every tic this thing sat out, in one go
+            mo->think_debt_ = 0;
+
+            P_MobjThinker(mo, owed);
+            thinkers_run++;
         }
     }
+
+    FinishSightPrepass();
 }
 
 //---------------------------------------------------------------------------
@@ -2356,17 +2680,10 @@ MapObject *CreateMapObject(float x, float y, float z, const MapObjectDefinition
 
     mobj->last_heard_ = -1; // For now, the last player we heard
 
-    if (tag)
-    {
-        mobj->tag_ = tag;
-        active_tagged_map_objects.emplace(tag, mobj);
-    }
+    MapObjectSetTag(mobj, tag);
 
     if (mobj->hyper_flags_ & kHyperFlagAssignTID)
-    {
-        mobj->tid_ = MapObjectGetTID();
-        active_tids.emplace(mobj->tid_, mobj);
-    }
+        MapObjectSetTID(mobj, MapObjectGetTID());
     //
     // -ACB- 1998/08/27 Mobj Linked-List Addition
     //
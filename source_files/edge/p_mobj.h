@@ -31,8 +31,9 @@
 
 #pragma once
 
-#include <map>
+#include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 #include "con_var.h"
 #include "ddf_types.h"
@@ -53,13 +54,18 @@ struct Subsector;
 struct TouchNode;
 struct Line;
 
-extern int                                             next_available_tid;
-extern std::multimap<int, MapObject *>                 active_tagged_map_objects;
-extern std::multimap<int, MapObject *>                 active_tids;
-extern std::unordered_set<const MapObjectDefinition *> seen_monsters;
+// things by tag / TID, each list in the order the things were added
+extern int                                               next_available_tid;
+extern std::unordered_map<int, std::vector<MapObject *>> active_tagged_map_objects;
+extern std::unordered_map<int, std::vector<MapObject *>> active_tids;
+extern std::unordered_set<const MapObjectDefinition *>   seen_monsters;
 
 extern bool time_stop_active;
 
+// thinker LOD counts for the last tic
+extern int thinkers_run;
+extern int thinkers_deferred;
+
 constexpr float kStopSpeed = 0.0625f;
 
 //
@@ -248,6 +254,13 @@ class MapObject : public Position
     int tics_     = 0;
     int tic_skip_ = 0;
 
+    // Thinker LOD: the blockmap cell from the last SetThingPosition, and
+    // the tics owed to a far-away thing which RunMapObjectThinkers has
+    // not let think yet.
+    int think_block_x_ = 0;
+    int think_block_y_ = 0;
+    int think_debt_    = 0;
+
     const struct State *state_      = nullptr;
     const struct State *next_state_ = nullptr;
 
@@ -362,6 +375,10 @@ class MapObject : public Position
     MapObject *next_     = nullptr;
     MapObject *previous_ = nullptr;
 
+    // list of objects with the same info_ (FirstMapObjectOfType)
+    MapObject *type_next_     = nullptr;
+    MapObject *type_previous_ = nullptr;
+
     // Interaction info, by BLOCKMAP.
     // Links in blocks (if needed).
     MapObject *blockmap_next_     = nullptr;
@@ -1650,6 +1650,8 @@ void RunActivePlanes(void)
                 pmov->sector->interpolated_floor_height = pmov->sector->floor_height;
             }
 
+            InvalidateSectorGeometry(pmov->sector);
+
             *PMI = nullptr;
             delete pmov;
 
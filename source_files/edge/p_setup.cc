@@ -39,11 +39,14 @@
 #include "epi_crc.h"
 #include "epi_doomdefs.h"
 #include "epi_endian.h"
+#include "epi_filesystem.h"
+#include "epi_md5.h"
 #include "epi_scanner.h"
 #include "epi_str_compare.h"
 #include "epi_str_hash.h"
 #include "epi_str_util.h"
 #include "g_game.h"
+#include "hu_draw.h"
 #include "i_system.h"
 #include "m_argv.h"
 #include "m_bbox.h"
@@ -60,6 +63,7 @@
 #include "s_music.h"
 #include "s_sound.h"
 #include "sv_main.h"
+#include "version.h"
 #include "w_files.h"
 #include "w_texture.h"
 #include "w_wad.h"
@@ -96,12 +100,15 @@ static int          total_level_vertical_gaps;
 static VerticalGap *level_vertical_gaps;
 
 VertexSectorList *level_vertex_sector_lists;
+static int        total_level_vertex_sector_lists;
 
 static Line **level_line_buffer = nullptr;
 
 // bbox used
 static float dummy_bounding_box[4];
 
+EDGE_DEFINE_CONSOLE_VARIABLE(map_cache, "1", kConsoleVariableFlagArchive)
+
 epi::CRC32 map_sectors_crc;
 epi::CRC32 map_lines_crc;
 epi::CRC32 map_things_crc;
@@ -358,34 +365,6 @@ static void SegCommonStuff(Seg *seg, int linedef_in)
     }
 }
 
-//
-// GroupSectorTags
-//
-// Called during P_LoadSectors to set the tag_next & tag_previous fields of
-// each sector_t, which keep all sectors with the same tag in a linked
-// list for faster handling.
-//
-// -AJA- 1999/07/29: written.
-//
-static void GroupSectorTags(Sector *dest, Sector *seclist, int numsecs)
-{
-    // NOTE: `numsecs' does not include the current sector.
-
-    dest->tag_next = dest->tag_previous = nullptr;
-
-    for (; numsecs > 0; numsecs--)
-    {
-        Sector *src = &seclist[numsecs - 1];
-
-        if (src->tag == dest->tag)
-        {
-            src->tag_next      = dest;
-            dest->tag_previous = src;
-            return;
-        }
-    }
-}
-
 static void LoadSectors(int lump)
 {
     const uint8_t   *data;
@@ -499,9 +478,6 @@ static void LoadSectors(int lump)
         ss->interpolated_floor_height   = ss->floor_height;
         ss->old_ceiling_height          = ss->ceiling_height;
         ss->interpolated_ceiling_height = ss->ceiling_height;
-
-        // -AJA- 1999/07/29: Keep sectors with same tag in a list.
-        GroupSectorTags(ss, level_sectors, i);
     }
 
     delete[] data;
@@ -1312,686 +1288,839 @@ static void LoadXGL3Nodes(int lumpnum)
     zgldata.clear();
 }
 
-static void LoadUDMFVertexes()
+//
+// UDMF loading: the TEXTMAP lump is tokenized once by ParseUDMF(), which
+// fills in the arrays below, then the LoadUDMFXXX functions build the
+// level from them.  Field keys are compared using the pre-computed
+// hashes in the udmf namespace.
+//
+
+struct UDMFVertex
 {
-    epi::Scanner lex(udmf_lump);
+    float x  = 0.0f;
+    float y  = 0.0f;
+    float zf = -40000.0f;
+    float zc = 40000.0f;
+};
 
-    LogDebug("LoadUDMFVertexes: parsing TEXTMAP\n");
-    int cur_vertex = 0;
-    int min_x      = 0;
-    int min_y      = 0;
-    int max_x      = 0;
-    int max_y      = 0;
+struct UDMFSector
+{
+    int                    cz = 0, fz = 0, liquid_z = 0;
+    float                  fx = 0.0f, fy = 0.0f, cx = 0.0f, cy = 0.0f;
+    float                  fx_sc = 1.0f, fy_sc = 1.0f, cx_sc = 1.0f, cy_sc = 1.0f;
+    float                  falph = 1.0f, calph = 1.0f;
+    float                  rf = 0.0f, rc = 0.0f;
+    float                  gravfactor = 1.0f;
+    int                    light = 160, liquid_light = 144, type = 0, tag = 0;
+    float                  liquid_trans = 0.5f;
+    RGBAColor              fog_color    = kRGBABlack;
+    RGBAColor              light_color  = kRGBAWhite;
+    RGBAColor              liquid_color = kRGBASteelBlue;
+    int                    fog_density  = 0;
+    char                   floor_tex[10]  = "-";
+    char                   ceil_tex[10]   = "-";
+    char                   liquid_tex[10] = "-";
+    ddf::ReverbDefinition *reverb         = nullptr;
+};
 
-    while (lex.TokensLeft())
-    {
-        std::string section;
+struct UDMFSide
+{
+    int   x = 0, y = 0;
+    float lowx = 0.0f, midx = 0.0f, highx = 0.0f;
+    float lowy = 0.0f, midy = 0.0f, highy = 0.0f;
+    float low_scx = 1.0f, mid_scx = 1.0f, high_scx = 1.0f;
+    float low_scy = 1.0f, mid_scy = 1.0f, high_scy = 1.0f;
+    int   sec_num        = 0;
+    char  top_tex[10]    = "-";
+    char  bottom_tex[10] = "-";
+    char  middle_tex[10] = "-";
+};
 
-        if (!lex.GetNextToken())
-            break;
+struct UDMFLine
+{
+    int   flags = 0, v1 = 0, v2 = 0;
+    int   side0 = -1, side1 = -1, tag = -1;
+    float alpha   = 1.0f;
+    int   special = 0;
+};
 
-        if (lex.state_.token != epi::Scanner::kIdentifier)
-            FatalError("Malformed TEXTMAP lump.\n");
+struct UDMFThing
+{
+    float    x = 0.0f, y = 0.0f, z = 0.0f;
+    BAMAngle angle     = kBAMAngle0;
+    int      options   = kThingNotSinglePlayer | kThingNotDeathmatch | kThingNotCooperative;
+    int      typenum   = -1;
+    int      tag       = 0;
+    float    healthfac = 1.0f;
+    float    alpha     = 1.0f;
+    float    scale = 0.0f, scalex = 0.0f, scaley = 0.0f;
+};
 
-        // check namespace
-        if (lex.CheckToken('='))
-        {
-            lex.GetNextToken();
-            if (!lex.CheckToken(';'))
-                FatalError("Malformed TEXTMAP lump: missing ';'\n");
-            continue;
-        }
+static std::vector<UDMFVertex> udmf_vertexes;
+static std::vector<UDMFSector> udmf_sectors;
+static std::vector<UDMFSide>   udmf_sides;
+static std::vector<UDMFLine>   udmf_lines;
+static std::vector<UDMFThing>  udmf_things;
 
-        section = lex.state_.string;
+// one "key = value;" pair of a block
+struct UDMFField
+{
+    uint32_t    key;
+    std::string value;
+    int         number;
+    double      decimal;
+    bool        boolean;
+};
 
-        if (!lex.CheckToken('{'))
-            FatalError("Malformed TEXTMAP lump: missing '{'\n");
+// reads the next field of a block, returns false at the closing '}'
+static bool UDMFNextField(epi::Scanner &lex, UDMFField &field)
+{
+    if (lex.CheckToken('}'))
+        return false;
 
-        if (section == "vertex")
-        {
-            float x = 0.0f, y = 0.0f;
-            float zf = -40000.0f, zc = 40000.0f;
-            for (;;)
-            {
-                if (lex.CheckToken('}'))
-                    break;
+    if (!lex.GetNextToken())
+        FatalError("Malformed TEXTMAP lump: unclosed block\n");
 
-                std::string key;
-                std::string value;
+    if (lex.state_.token != epi::Scanner::kIdentifier)
+        FatalError("Malformed TEXTMAP lump: missing key\n");
 
-                if (!lex.GetNextToken())
-                    FatalError("Malformed TEXTMAP lump: unclosed block\n");
+    field.key = epi::StringHash(lex.state_.string).Value();
 
-                if (lex.state_.token != epi::Scanner::kIdentifier)
-                    FatalError("Malformed TEXTMAP lump: missing key\n");
+    if (!lex.CheckToken('='))
+        FatalError("Malformed TEXTMAP lump: missing '='\n");
 
-                key = lex.state_.string;
+    if (!lex.GetNextToken() || lex.state_.token == '}')
+        FatalError("Malformed TEXTMAP lump: missing value\n");
 
-                if (!lex.CheckToken('='))
-                    FatalError("Malformed TEXTMAP lump: missing '='\n");
+    field.value   = lex.state_.string;
+    field.number  = lex.state_.number;
+    field.decimal = lex.state_.decimal;
+    field.boolean = lex.state_.boolean;
 
-                if (!lex.GetNextToken() || lex.state_.token == '}')
-                    FatalError("Malformed TEXTMAP lump: missing value\n");
+    if (!lex.CheckToken(';'))
+        FatalError("Malformed TEXTMAP lump: missing ';'\n");
 
-                value = lex.state_.string;
+    return true;
+}
+
+static void ParseUDMFVertex(epi::Scanner &lex, UDMFField &field)
+{
+    UDMFVertex &uv = udmf_vertexes.emplace_back();
 
-                if (!lex.CheckToken(';'))
-                    FatalError("Malformed TEXTMAP lump: missing ';'\n");
+    while (UDMFNextField(lex, field))
+    {
+        switch (field.key)
+        {
+        case udmf::kX:
+            uv.x = field.decimal;
+            break;
+        case udmf::kY:
+            uv.y = field.decimal;
+            break;
+        case udmf::kZFloor:
+            uv.zf = field.decimal;
+            break;
+        case udmf::kZCeiling:
+            uv.zc = field.decimal;
+            break;
+        default:
+            break;
+        }
+    }
+}
 
-                epi::StringHash key_hash(key);
+static void ParseUDMFSector(epi::Scanner &lex, UDMFField &field)
+{
+    UDMFSector &us = udmf_sectors.emplace_back();
 
-                switch (key_hash.Value())
-                {
-                case udmf::kX:
-                    x     = lex.state_.decimal;
-                    min_x = HMM_MIN((int)x, min_x);
-                    max_x = HMM_MAX((int)x, max_x);
-                    break;
-                case udmf::kY:
-                    y     = lex.state_.decimal;
-                    min_y = HMM_MIN((int)y, min_y);
-                    max_y = HMM_MAX((int)y, max_y);
-                    break;
-                case udmf::kZFloor:
-                    zf = lex.state_.decimal;
-                    break;
-                case udmf::kZCeiling:
-                    zc = lex.state_.decimal;
-                    break;
-                default:
-                    break;
-                }
-            }
-            level_vertexes[cur_vertex] = {{{{{x, y, zf}}}, zc}};
-            cur_vertex++;
+    while (UDMFNextField(lex, field))
+    {
+        switch (field.key)
+        {
+        case udmf::kHeightFloor:
+            us.fz = field.number;
+            break;
+        case udmf::kHeightCeiling:
+            us.cz = field.number;
+            break;
+        case udmf::kTextureFloor:
+            epi::CStringCopyMax(us.floor_tex, field.value.c_str(), 8);
+            break;
+        case udmf::kTextureCeiling:
+            epi::CStringCopyMax(us.ceil_tex, field.value.c_str(), 8);
+            break;
+        case udmf::kLightLevel:
+            us.light = field.number;
+            break;
+        case udmf::kSpecial:
+            us.type = field.number;
+            break;
+        case udmf::kID:
+            us.tag = field.number;
+            break;
+        case udmf::kLightColor:
+            us.light_color = ((uint32_t)field.number << 8 | 0xFF);
+            break;
+        case udmf::kFadeColor:
+            us.fog_color = ((uint32_t)field.number << 8 | 0xFF);
+            break;
+        case udmf::kFogDensity:
+            us.fog_density = HMM_Clamp(0, field.number, 1020);
+            break;
+        case udmf::kXPanningFloor:
+            us.fx = field.decimal;
+            break;
+        case udmf::kYPanningFloor:
+            us.fy = field.decimal;
+            break;
+        case udmf::kXPanningCeiling:
+            us.cx = field.decimal;
+            break;
+        case udmf::kYPanningCeiling:
+            us.cy = field.decimal;
+            break;
+        case udmf::kXScaleFloor:
+            us.fx_sc = field.decimal;
+            break;
+        case udmf::kYScaleFloor:
+            us.fy_sc = field.decimal;
+            break;
+        case udmf::kXScaleCeiling:
+            us.cx_sc = field.decimal;
+            break;
+        case udmf::kYScaleCeiling:
+            us.cy_sc = field.decimal;
+            break;
+        case udmf::kAlphaFloor:
+            us.falph = field.decimal;
+            break;
+        case udmf::kAlphaCeiling:
+            us.calph = field.decimal;
+            break;
+        case udmf::kRotationFloor:
+            us.rf = field.decimal;
+            break;
+        case udmf::kRotationCeiling:
+            us.rc = field.decimal;
+            break;
+        case udmf::kGravity:
+            us.gravfactor = field.decimal;
+            break;
+        case udmf::kReverbPreset:
+            us.reverb = ddf::ReverbDefinition::Lookup(field.value);
+            break;
+        case udmf::kLiquidHeight:
+            us.liquid_z = field.decimal;
+            break;
+        case udmf::kLiquidColor:
+            us.liquid_color = ((uint32_t)field.number << 8 | 0xFF);
+            break;
+        case udmf::kLiquidTexture:
+            epi::CStringCopyMax(us.liquid_tex, field.value.c_str(), 8);
+            break;
+        case udmf::kLiquidLight:
+            us.liquid_light = field.number;
+            break;
+        case udmf::kLiquidTrans:
+            us.liquid_trans = field.decimal;
+            break;
+        default:
+            break;
         }
-        else // consume other blocks
+    }
+}
+
+static void ParseUDMFSideDef(epi::Scanner &lex, UDMFField &field)
+{
+    UDMFSide &usd = udmf_sides.emplace_back();
+
+    while (UDMFNextField(lex, field))
+    {
+        switch (field.key)
         {
-            for (;;)
-            {
-                if (!lex.GetNextToken() || lex.state_.token == '}')
-                    break;
-            }
+        case udmf::kOffsetX:
+            usd.x = field.number;
+            break;
+        case udmf::kOffsetY:
+            usd.y = field.number;
+            break;
+        case udmf::kOffsetX_Bottom:
+            usd.lowx = field.decimal;
+            break;
+        case udmf::kOffsetX_Mid:
+            usd.midx = field.decimal;
+            break;
+        case udmf::kOffsetX_Top:
+            usd.highx = field.decimal;
+            break;
+        case udmf::kOffsetY_Bottom:
+            usd.lowy = field.decimal;
+            break;
+        case udmf::kOffsetY_Mid:
+            usd.midy = field.decimal;
+            break;
+        case udmf::kOffsetY_Top:
+            usd.highy = field.decimal;
+            break;
+        case udmf::kScaleX_Bottom:
+            usd.low_scx = field.decimal;
+            break;
+        case udmf::kScaleX_Mid:
+            usd.mid_scx = field.decimal;
+            break;
+        case udmf::kScaleX_Top:
+            usd.high_scx = field.decimal;
+            break;
+        case udmf::kScaleY_Bottom:
+            usd.low_scy = field.decimal;
+            break;
+        case udmf::kScaleY_Mid:
+            usd.mid_scy = field.decimal;
+            break;
+        case udmf::kScaleY_Top:
+            usd.high_scy = field.decimal;
+            break;
+        case udmf::kTextureTop:
+            epi::CStringCopyMax(usd.top_tex, field.value.c_str(), 8);
+            break;
+        case udmf::kTextureBottom:
+            epi::CStringCopyMax(usd.bottom_tex, field.value.c_str(), 8);
+            break;
+        case udmf::kTextureMiddle:
+            epi::CStringCopyMax(usd.middle_tex, field.value.c_str(), 8);
+            break;
+        case udmf::kSector:
+            usd.sec_num = field.number;
+            break;
+        default:
+            break;
         }
     }
-    EPI_ASSERT(cur_vertex == total_level_vertexes);
+}
 
-    GenerateBlockmap(min_x, min_y, max_x, max_y);
+static void ParseUDMFLineDef(epi::Scanner &lex, UDMFField &field)
+{
+    UDMFLine &ul = udmf_lines.emplace_back();
 
-    CreateThingBlockmap();
+    while (UDMFNextField(lex, field))
+    {
+        switch (field.key)
+        {
+        case udmf::kID:
+            ul.tag = field.number;
+            break;
+        case udmf::kV1:
+            ul.v1 = field.number;
+            break;
+        case udmf::kV2:
+            ul.v2 = field.number;
+            break;
+        case udmf::kSpecial:
+            ul.special = field.number;
+            break;
+        case udmf::kSideFront:
+            ul.side0 = field.number;
+            break;
+        case udmf::kSideBack:
+            ul.side1 = field.number;
+            break;
+        case udmf::kAlpha:
+            ul.alpha = field.decimal;
+            break;
+        case udmf::kBlocking:
+            ul.flags |= (field.boolean ? kLineFlagBlocking : 0);
+            break;
+        case udmf::kBlockMonsters:
+            ul.flags |= (field.boolean ? kLineFlagBlockMonsters : 0);
+            break;
+        case udmf::kTwoSided:
+            ul.flags |= (field.boolean ? kLineFlagTwoSided : 0);
+            break;
+        case udmf::kDontPegTop:
+            ul.flags |= (field.boolean ? kLineFlagUpperUnpegged : 0);
+            break;
+        case udmf::kDontPegBottom:
+            ul.flags |= (field.boolean ? kLineFlagLowerUnpegged : 0);
+            break;
+        case udmf::kSecret:
+            ul.flags |= (field.boolean ? kLineFlagSecret : 0);
+            break;
+        case udmf::kBlockSound:
+            ul.flags |= (field.boolean ? kLineFlagSoundBlock : 0);
+            break;
+        case udmf::kDontDraw:
+            ul.flags |= (field.boolean ? kLineFlagDontDraw : 0);
+            break;
+        case udmf::kMapped:
+            ul.flags |= (field.boolean ? kLineFlagMapped : 0);
+            break;
+        case udmf::kPassUse:
+            ul.flags |= (field.boolean ? kLineFlagBoomPassThrough : 0);
+            break;
+        case udmf::kBlockPlayers:
+            ul.flags |= (field.boolean ? kLineFlagBlockPlayers : 0);
+            break;
+        case udmf::kBlockSight:
+            ul.flags |= (field.boolean ? kLineFlagSightBlock : 0);
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+static void ParseUDMFThing(epi::Scanner &lex, UDMFField &field)
+{
+    UDMFThing &ut = udmf_things.emplace_back();
+
+    while (UDMFNextField(lex, field))
+    {
+        switch (field.key)
+        {
+        case udmf::kID:
+            ut.tag = field.number;
+            break;
+        case udmf::kX:
+            ut.x = field.decimal;
+            break;
+        case udmf::kY:
+            ut.y = field.decimal;
+            break;
+        case udmf::kHeight:
+            ut.z = field.decimal;
+            break;
+        case udmf::kAngle:
+            ut.angle = epi::BAMFromDegrees(field.number);
+            break;
+        case udmf::kType:
+            ut.typenum = field.number;
+            break;
+        case udmf::kSkill1:
+            ut.options |= (field.boolean ? kThingEasy : 0);
+            break;
+        case udmf::kSkill2:
+            ut.options |= (field.boolean ? kThingEasy : 0);
+            break;
+        case udmf::kSkill3:
+            ut.options |= (field.boolean ? kThingMedium : 0);
+            break;
+        case udmf::kSkill4:
+            ut.options |= (field.boolean ? kThingHard : 0);
+            break;
+        case udmf::kSkill5:
+            ut.options |= (field.boolean ? kThingHard : 0);
+            break;
+        case udmf::kAmbush:
+            ut.options |= (field.boolean ? kThingAmbush : 0);
+            break;
+        case udmf::kSingle:
+            ut.options &= (field.boolean ? ~kThingNotSinglePlayer : ut.options);
+            break;
+        case udmf::kDM:
+            ut.options &= (field.boolean ? ~kThingNotDeathmatch : ut.options);
+            break;
+        case udmf::kCoop:
+            ut.options &= (field.boolean ? ~kThingNotCooperative : ut.options);
+            break;
+        case udmf::kFriend:
+            ut.options |= (field.boolean ? kThingFriend : 0);
+            break;
+        case udmf::kHealth:
+            ut.healthfac = field.decimal;
+            break;
+        case udmf::kAlpha:
+            ut.alpha = field.decimal;
+            break;
+        case udmf::kScale:
+            ut.scale = field.decimal;
+            break;
+        case udmf::kScaleX:
+            ut.scalex = field.decimal;
+            break;
+        case udmf::kScaleY:
+            ut.scaley = field.decimal;
+            break;
+        default:
+            break;
+        }
+    }
+}
 
-    LogDebug("LoadUDMFVertexes: finished parsing TEXTMAP\n");
+static void FreeUDMFData()
+{
+    std::vector<UDMFVertex>().swap(udmf_vertexes);
+    std::vector<UDMFSector>().swap(udmf_sectors);
+    std::vector<UDMFSide>().swap(udmf_sides);
+    std::vector<UDMFLine>().swap(udmf_lines);
+    std::vector<UDMFThing>().swap(udmf_things);
 }
 
-static void LoadUDMFSectors()
+static void ParseUDMF()
 {
+    FreeUDMFData();
+
     epi::Scanner lex(udmf_lump);
 
-    LogDebug("LoadUDMFSectors: parsing TEXTMAP\n");
-    int cur_sector = 0;
+    LogDebug("ParseUDMF: parsing TEXTMAP\n");
+
+    UDMFField field;
 
     while (lex.TokensLeft())
     {
-        std::string section;
-
         if (!lex.GetNextToken())
             break;
 
         if (lex.state_.token != epi::Scanner::kIdentifier)
             FatalError("Malformed TEXTMAP lump.\n");
 
+        epi::StringHash section_hash(lex.state_.string);
+
         // check namespace
         if (lex.CheckToken('='))
         {
             lex.GetNextToken();
+
+            const std::string &name = lex.state_.string;
+
+            if (name != "doom" && name != "heretic" && name != "edge-classic" && name != "zdoomtranslated")
+            {
+                LogWarning("UDMF: %s uses unsupported namespace "
+                           "\"%s\"!\nSupported namespaces are \"doom\", "
+                           "\"heretic\", \"edge-classic\", or "
+                           "\"zdoomtranslated\"!\n",
+                           current_map->lump_.c_str(), name.c_str());
+            }
+
             if (!lex.CheckToken(';'))
                 FatalError("Malformed TEXTMAP lump: missing ';'\n");
             continue;
         }
 
-        section = lex.state_.string;
-
         if (!lex.CheckToken('{'))
             FatalError("Malformed TEXTMAP lump: missing '{'\n");
 
-        if (section == "sector")
-        {
-            int                    cz = 0, fz = 0, liquid_z = 0;
-            float                  fx = 0.0f, fy = 0.0f, cx = 0.0f, cy = 0.0f;
-            float                  fx_sc = 1.0f, fy_sc = 1.0f, cx_sc = 1.0f, cy_sc = 1.0f;
-            float                  falph = 1.0f, calph = 1.0f;
-            float                  rf = 0.0f, rc = 0.0f;
-            float                  gravfactor = 1.0f;
-            int                    light = 160, liquid_light = 144, type = 0, tag = 0;
-            float                  liquid_trans = 0.5f;
-            RGBAColor              fog_color    = kRGBABlack;
-            RGBAColor              light_color  = kRGBAWhite;
-            RGBAColor              liquid_color = kRGBASteelBlue;
-            int                    fog_density  = 0;
-            char                   floor_tex[10];
-            char                   ceil_tex[10];
-            char                   liquid_tex[10];
-            ddf::ReverbDefinition *reverb = nullptr;
-            strcpy(floor_tex, "-");
-            strcpy(ceil_tex, "-");
-            strcpy(liquid_tex, "-");
+        switch (section_hash.Value())
+        {
+        case udmf::kVertex:
+            ParseUDMFVertex(lex, field);
+            break;
+        case udmf::kSector:
+            ParseUDMFSector(lex, field);
+            break;
+        case udmf::kSidedef:
+            ParseUDMFSideDef(lex, field);
+            break;
+        case udmf::kLinedef:
+            ParseUDMFLineDef(lex, field);
+            break;
+        case udmf::kThing:
+            ParseUDMFThing(lex, field);
+            break;
+        default:
+            // ignore block contents
             for (;;)
             {
-                if (lex.CheckToken('}'))
+                if (!lex.GetNextToken() || lex.state_.token == '}')
                     break;
+            }
+            break;
+        }
+    }
 
-                std::string key;
-                std::string value;
+    // side counts are computed during linedef loading
+    total_map_things += (int)udmf_things.size();
+    total_level_vertexes = (int)udmf_vertexes.size();
+    total_level_sectors  = (int)udmf_sectors.size();
+    total_level_lines    = (int)udmf_lines.size();
 
-                if (!lex.GetNextToken())
-                    FatalError("Malformed TEXTMAP lump: unclosed block\n");
+    // initialize arrays
+    level_vertexes = new Vertex[total_level_vertexes];
+    level_sectors  = new Sector[total_level_sectors];
+    EPI_CLEAR_MEMORY(level_sectors, Sector, total_level_sectors);
+    level_lines = new Line[total_level_lines];
+    EPI_CLEAR_MEMORY(level_lines, Line, total_level_lines);
+    level_line_alphas = new float[total_level_lines];
+    temp_line_sides   = new int[total_level_lines * 2];
 
-                if (lex.state_.token != epi::Scanner::kIdentifier)
-                    FatalError("Malformed TEXTMAP lump: missing key\n");
+    LogDebug("ParseUDMF: finished parsing TEXTMAP\n");
+}
 
-                key = lex.state_.string;
+static void LoadUDMFVertexes()
+{
+    int min_x = 0;
+    int min_y = 0;
+    int max_x = 0;
+    int max_y = 0;
 
-                if (!lex.CheckToken('='))
-                    FatalError("Malformed TEXTMAP lump: missing '='\n");
+    for (int cur_vertex = 0; cur_vertex < total_level_vertexes; cur_vertex++)
+    {
+        const UDMFVertex &uv = udmf_vertexes[cur_vertex];
 
-                if (!lex.GetNextToken() || lex.state_.token == '}')
-                    FatalError("Malformed TEXTMAP lump: missing value\n");
+        min_x = HMM_MIN((int)uv.x, min_x);
+        max_x = HMM_MAX((int)uv.x, max_x);
+        min_y = HMM_MIN((int)uv.y, min_y);
+        max_y = HMM_MAX((int)uv.y, max_y);
 
-                value = lex.state_.string;
+        level_vertexes[cur_vertex] = {{{{{uv.x, uv.y, uv.zf}}}, uv.zc}};
+    }
 
-                if (!lex.CheckToken(';'))
-                    FatalError("Malformed TEXTMAP lump: missing ';'\n");
+    GenerateBlockmap(min_x, min_y, max_x, max_y);
 
-                epi::StringHash key_hash(key);
+    CreateThingBlockmap();
+}
 
-                switch (key_hash.Value())
-                {
-                case udmf::kHeightFloor:
-                    fz = lex.state_.number;
-                    break;
-                case udmf::kHeightCeiling:
-                    cz = lex.state_.number;
-                    break;
-                case udmf::kTextureFloor:
-                    epi::CStringCopyMax(floor_tex, value.c_str(), 8);
-                    break;
-                case udmf::kTextureCeiling:
-                    epi::CStringCopyMax(ceil_tex, value.c_str(), 8);
-                    break;
-                case udmf::kLightLevel:
-                    light = lex.state_.number;
-                    break;
-                case udmf::kSpecial:
-                    type = lex.state_.number;
-                    break;
-                case udmf::kID:
-                    tag = lex.state_.number;
-                    break;
-                case udmf::kLightColor:
-                    light_color = ((uint32_t)lex.state_.number << 8 | 0xFF);
-                    break;
-                case udmf::kFadeColor:
-                    fog_color = ((uint32_t)lex.state_.number << 8 | 0xFF);
-                    break;
-                case udmf::kFogDensity:
-                    fog_density = HMM_Clamp(0, lex.state_.number, 1020);
-                    break;
-                case udmf::kXPanningFloor:
-                    fx = lex.state_.decimal;
-                    break;
-                case udmf::kYPanningFloor:
-                    fy = lex.state_.decimal;
-                    break;
-                case udmf::kXPanningCeiling:
-                    cx = lex.state_.decimal;
-                    break;
-                case udmf::kYPanningCeiling:
-                    cy = lex.state_.decimal;
-                    break;
-                case udmf::kXScaleFloor:
-                    fx_sc = lex.state_.decimal;
-                    break;
-                case udmf::kYScaleFloor:
-                    fy_sc = lex.state_.decimal;
-                    break;
-                case udmf::kXScaleCeiling:
-                    cx_sc = lex.state_.decimal;
-                    break;
-                case udmf::kYScaleCeiling:
-                    cy_sc = lex.state_.decimal;
-                    break;
-                case udmf::kAlphaFloor:
-                    falph = lex.state_.decimal;
-                    break;
-                case udmf::kAlphaCeiling:
-                    calph = lex.state_.decimal;
-                    break;
-                case udmf::kRotationFloor:
-                    rf = lex.state_.decimal;
-                    break;
-                case udmf::kRotationCeiling:
-                    rc = lex.state_.decimal;
-                    break;
-                case udmf::kGravity:
-                    gravfactor = lex.state_.decimal;
-                    break;
-                case udmf::kReverbPreset:
-                    reverb = ddf::ReverbDefinition::Lookup(value);
-                    break;
-                case udmf::kLiquidHeight:
-                    liquid_z = lex.state_.decimal;
-                    break;
-                case udmf::kLiquidColor:
-                    liquid_color = ((uint32_t)lex.state_.number << 8 | 0xFF);
-                    break;
-                case udmf::kLiquidTexture:
-                    epi::CStringCopyMax(liquid_tex, value.c_str(), 8);
-                    break;
-                case udmf::kLiquidLight:
-                    liquid_light = lex.state_.number;
-                    break;
-                case udmf::kLiquidTrans:
-                    liquid_trans = lex.state_.decimal;
-                    break;
-                default:
-                    break;
-                }
-            }
-            Sector *ss         = level_sectors + cur_sector;
-            ss->floor_height   = fz;
-            ss->ceiling_height = cz;
+static void LoadUDMFSectors()
+{
+    for (int cur_sector = 0; cur_sector < total_level_sectors; cur_sector++)
+    {
+        const UDMFSector &us = udmf_sectors[cur_sector];
 
-            ss->original_height = (ss->floor_height + ss->ceiling_height);
+        RGBAColor fog_color    = us.fog_color;
+        RGBAColor light_color  = us.light_color;
+        RGBAColor liquid_color = us.liquid_color;
 
-            ss->floor.translucency = falph;
-            ss->floor.x_matrix.X   = 1;
-            ss->floor.x_matrix.Y   = 0;
-            ss->floor.y_matrix.X   = 0;
-            ss->floor.y_matrix.Y   = 1;
+        Sector *ss         = level_sectors + cur_sector;
+        ss->floor_height   = us.fz;
+        ss->ceiling_height = us.cz;
 
-            ss->ceiling = ss->deep_water_surface = ss->floor;
-            ss->ceiling.translucency             = calph;
+        ss->original_height = (ss->floor_height + ss->ceiling_height);
 
-            // rotations
-            if (!AlmostEquals(rf, 0.0f))
-                ss->floor.rotation = epi::BAMFromDegrees(rf);
+        ss->floor.translucency = us.falph;
+        ss->floor.x_matrix.X   = 1;
+        ss->floor.x_matrix.Y   = 0;
+        ss->floor.y_matrix.X   = 0;
+        ss->floor.y_matrix.Y   = 1;
 
-            if (!AlmostEquals(rc, 0.0f))
-                ss->ceiling.rotation = epi::BAMFromDegrees(rc);
+        ss->ceiling = ss->deep_water_surface = ss->floor;
+        ss->ceiling.translucency             = us.calph;
 
-            // granular scaling
-            ss->floor.x_matrix.X   = fx_sc;
-            ss->floor.y_matrix.Y   = fy_sc;
-            ss->ceiling.x_matrix.X = cx_sc;
-            ss->ceiling.y_matrix.Y = cy_sc;
+        // rotations
+        if (!AlmostEquals(us.rf, 0.0f))
+            ss->floor.rotation = epi::BAMFromDegrees(us.rf);
 
-            // granular offsets
-            ss->floor.offset.X += (fx / fx_sc);
-            ss->floor.offset.Y -= (fy / fy_sc);
-            ss->floor.old_offset = ss->floor.offset;
-            ss->ceiling.offset.X += (cx / cx_sc);
-            ss->ceiling.offset.Y -= (cy / cy_sc);
-            ss->ceiling.old_offset = ss->ceiling.offset;
+        if (!AlmostEquals(us.rc, 0.0f))
+            ss->ceiling.rotation = epi::BAMFromDegrees(us.rc);
 
-            ss->floor.image = ImageLookup(floor_tex, kImageNamespaceFlat);
+        // granular scaling
+        ss->floor.x_matrix.X   = us.fx_sc;
+        ss->floor.y_matrix.Y   = us.fy_sc;
+        ss->ceiling.x_matrix.X = us.cx_sc;
+        ss->ceiling.y_matrix.Y = us.cy_sc;
 
-            if (ss->floor.image)
-            {
-                FlatDefinition *current_flatdef = flatdefs.Find(ss->floor.image->name_.c_str());
-                if (current_flatdef)
-                {
-                    ss->bob_depth  = current_flatdef->bob_depth_;
-                    ss->sink_depth = current_flatdef->sink_depth_;
-                }
-            }
+        // granular offsets
+        ss->floor.offset.X += (us.fx / us.fx_sc);
+        ss->floor.offset.Y -= (us.fy / us.fy_sc);
+        ss->floor.old_offset = ss->floor.offset;
+        ss->ceiling.offset.X += (us.cx / us.cx_sc);
+        ss->ceiling.offset.Y -= (us.cy / us.cy_sc);
+        ss->ceiling.old_offset = ss->ceiling.offset;
 
-            ss->ceiling.image = ImageLookup(ceil_tex, kImageNamespaceFlat);
+        ss->floor.image = ImageLookup(us.floor_tex, kImageNamespaceFlat);
 
-            if (!ss->floor.image)
-            {
-                LogWarning("Bad Level: sector #%d has missing floor texture.\n", cur_sector);
-                ss->floor.image = ImageLookup("FLAT1", kImageNamespaceFlat);
-            }
-            if (!ss->ceiling.image)
+        if (ss->floor.image)
+        {
+            FlatDefinition *current_flatdef = flatdefs.Find(ss->floor.image->name_.c_str());
+            if (current_flatdef)
             {
-                LogWarning("Bad Level: sector #%d has missing ceiling texture.\n", cur_sector);
-                ss->ceiling.image = ss->floor.image;
+                ss->bob_depth  = current_flatdef->bob_depth_;
+                ss->sink_depth = current_flatdef->sink_depth_;
             }
+        }
 
-            // convert negative tags to zero
-            ss->tag = HMM_MAX(0, tag);
+        ss->ceiling.image = ImageLookup(us.ceil_tex, kImageNamespaceFlat);
 
-            ss->properties.light_level = light;
+        if (!ss->floor.image)
+        {
+            LogWarning("Bad Level: sector #%d has missing floor texture.\n", cur_sector);
+            ss->floor.image = ImageLookup("FLAT1", kImageNamespaceFlat);
+        }
+        if (!ss->ceiling.image)
+        {
+            LogWarning("Bad Level: sector #%d has missing ceiling texture.\n", cur_sector);
+            ss->ceiling.image = ss->floor.image;
+        }
 
-            // convert negative types to zero
-            ss->properties.type    = HMM_MAX(0, type);
-            ss->properties.special = LookupSectorType(ss->properties.type);
+        // convert negative tags to zero
+        ss->tag = HMM_MAX(0, us.tag);
 
-            ss->properties.colourmap = nullptr;
+        ss->properties.light_level = us.light;
 
-            ss->properties.gravity    = kGravityDefault * gravfactor;
-            ss->properties.friction   = kFrictionDefault;
-            ss->properties.movefactor = 1.0f;
-            ss->properties.viscosity  = kViscosityDefault;
-            ss->properties.drag       = kDragDefault;
+        // convert negative types to zero
+        ss->properties.type    = HMM_MAX(0, us.type);
+        ss->properties.special = LookupSectorType(ss->properties.type);
 
-            // Allow UDMF sector light/fog information to override DDFSECT types
-            if (fog_color != kRGBABlack) // All black is the established
-                                         // UDMF "no fog" color
-            {
-                // Prevent UDMF-specified fog color from having our internal 'no
-                // value'...uh...value
-                if (fog_color == kRGBANoValue)
-                    fog_color ^= 0x00010100;
-                ss->properties.fog_color = fog_color;
-                // Best-effort match for GZDoom's fogdensity values so that UDB,
-                // etc give predictable results
-                if (fog_density < 2)
-                    ss->properties.fog_density = 0.002f;
-                else
-                    ss->properties.fog_density = 0.01f * ((float)fog_density / 1020.0f);
-            }
-            else if (ss->properties.special && ss->properties.special->fog_color_ != kRGBANoValue)
-            {
-                ss->properties.fog_color   = ss->properties.special->fog_color_;
-                ss->properties.fog_density = 0.01f * ss->properties.special->fog_density_;
-            }
+        ss->properties.colourmap = nullptr;
+
+        ss->properties.gravity    = kGravityDefault * us.gravfactor;
+        ss->properties.friction   = kFrictionDefault;
+        ss->properties.movefactor = 1.0f;
+        ss->properties.viscosity  = kViscosityDefault;
+        ss->properties.drag       = kDragDefault;
+
+        // Allow UDMF sector light/fog information to override DDFSECT types
+        if (fog_color != kRGBABlack) // All black is the established
+                                     // UDMF "no fog" color
+        {
+            // Prevent UDMF-specified fog color from having our internal 'no
+            // value'...uh...value
+            if (fog_color == kRGBANoValue)
+                fog_color ^= 0x00010100;
+            ss->properties.fog_color = fog_color;
+            // Best-effort match for GZDoom's fogdensity values so that UDB,
+            // etc give predictable results
+            if (us.fog_density < 2)
+                ss->properties.fog_density = 0.002f;
             else
-            {
-                ss->properties.fog_color   = kRGBANoValue;
-                ss->properties.fog_density = 0;
-            }
+                ss->properties.fog_density = 0.01f * ((float)us.fog_density / 1020.0f);
+        }
+        else if (ss->properties.special && ss->properties.special->fog_color_ != kRGBANoValue)
+        {
+            ss->properties.fog_color   = ss->properties.special->fog_color_;
+            ss->properties.fog_density = 0.01f * ss->properties.special->fog_density_;
+        }
+        else
+        {
+            ss->properties.fog_color   = kRGBANoValue;
+            ss->properties.fog_density = 0;
+        }
 
-            // Allow UDMF sector reverb information to override DDFSECT types
-            if (reverb)
-                ss->sound_reverb = reverb;
-            else if (ss->properties.special && ss->properties.special->reverb_preset_)
-                ss->sound_reverb = ss->properties.special->reverb_preset_;
+        // Allow UDMF sector reverb information to override DDFSECT types
+        if (us.reverb)
+            ss->sound_reverb = us.reverb;
+        else if (ss->properties.special && ss->properties.special->reverb_preset_)
+            ss->sound_reverb = ss->properties.special->reverb_preset_;
 
-            if (light_color != kRGBAWhite)
+        if (light_color != kRGBAWhite)
+        {
+            if (light_color == kRGBANoValue)
+                light_color ^= 0x00010100;
+            // Make colormap if necessary
+            for (Colormap *cmap : colormaps)
             {
-                if (light_color == kRGBANoValue)
-                    light_color ^= 0x00010100;
-                // Make colormap if necessary
-                for (Colormap *cmap : colormaps)
+                if (cmap->gl_color_ != kRGBANoValue && cmap->gl_color_ == light_color)
                 {
-                    if (cmap->gl_color_ != kRGBANoValue && cmap->gl_color_ == light_color)
-                    {
-                        ss->properties.colourmap = cmap;
-                        break;
-                    }
-                }
-                if (!ss->properties.colourmap || ss->properties.colourmap->gl_color_ != light_color)
-                {
-                    Colormap *ad_hoc         = new Colormap;
-                    ad_hoc->name_            = epi::StringFormat("UDMF_%d", light_color); // Internal
-                    ad_hoc->gl_color_        = light_color;
-                    ss->properties.colourmap = ad_hoc;
-                    colormaps.push_back(ad_hoc);
+                    ss->properties.colourmap = cmap;
+                    break;
                 }
             }
-
-            ss->active_properties = &ss->properties;
-
-            // New to GD-DOOM: boom height replacement key/value pairs
-            ss->deep_water_surface.image = ImageLookup(liquid_tex, kImageNamespaceFlat, kImageLookupNull);
-
-            if (ss->deep_water_surface.image)
+            if (!ss->properties.colourmap || ss->properties.colourmap->gl_color_ != light_color)
             {
-                ss->has_deep_water    = true;
-                ss->deep_water_height = liquid_z;
-                if (liquid_color == kRGBANoValue) // ensure no accidental collision
-                    liquid_color ^= 0x00010100;
-                // Make colormap if necessary
-                for (Colormap *cmap : colormaps)
-                {
-                    if (cmap->gl_color_ != kRGBANoValue && cmap->gl_color_ == liquid_color)
-                    {
-                        ss->deep_water_properties.colourmap = cmap;
-                        break;
-                    }
-                }
-                if (!ss->deep_water_properties.colourmap || ss->properties.colourmap->gl_color_ != liquid_color)
-                {
-                    Colormap *ad_hoc                    = new Colormap;
-                    ad_hoc->name_                       = epi::StringFormat("UDMF_%d", liquid_color); // Internal
-                    ad_hoc->gl_color_                   = liquid_color;
-                    ss->deep_water_properties.colourmap = ad_hoc;
-                    colormaps.push_back(ad_hoc);
-                }
-                ss->deep_water_properties.light_level = liquid_light;
-                ss->deep_water_surface.translucency   = liquid_trans;
-                ss->deep_water_properties.friction    = 0.9f;
-                ss->deep_water_properties.viscosity   = 0.7f;
-                ss->deep_water_properties.gravity     = 0.1f;
-                ss->deep_water_properties.drag        = 0.95f;
-                ss->deep_water_properties.special     = new SectorType();
-                SectorType *water_special = (SectorType *)ss->deep_water_properties.special; // const override
-                water_special->special_flags_ =
-                    (SectorFlag)(kSectorFlagDeepWater | kSectorFlagSwimming | kSectorFlagAirLess);
+                Colormap *ad_hoc         = new Colormap;
+                ad_hoc->name_            = epi::StringFormat("UDMF_%d", light_color); // Internal
+                ad_hoc->gl_color_        = light_color;
+                ss->properties.colourmap = ad_hoc;
+                colormaps.push_back(ad_hoc);
             }
+        }
 
-            ss->sound_player = -1;
+        ss->active_properties = &ss->properties;
 
-            ss->old_floor_height            = ss->floor_height;
-            ss->interpolated_floor_height   = ss->floor_height;
-            ss->old_ceiling_height          = ss->ceiling_height;
-            ss->interpolated_ceiling_height = ss->ceiling_height;
+        // New to GD-DOOM: boom height replacement key/value pairs
+        ss->deep_water_surface.image = ImageLookup(us.liquid_tex, kImageNamespaceFlat, kImageLookupNull);
 
-            // -AJA- 1999/07/29: Keep sectors with same tag in a list.
-            GroupSectorTags(ss, level_sectors, cur_sector);
-            cur_sector++;
-        }
-        else // consume other blocks
+        if (ss->deep_water_surface.image)
         {
-            for (;;)
+            ss->has_deep_water    = true;
+            ss->deep_water_height = us.liquid_z;
+            if (liquid_color == kRGBANoValue) // ensure no accidental collision
+                liquid_color ^= 0x00010100;
+            // Make colormap if necessary
+            for (Colormap *cmap : colormaps)
             {
-                if (!lex.GetNextToken() || lex.state_.token == '}')
+                if (cmap->gl_color_ != kRGBANoValue && cmap->gl_color_ == liquid_color)
+                {
+                    ss->deep_water_properties.colourmap = cmap;
                     break;
+                }
+            }
+            if (!ss->deep_water_properties.colourmap || ss->properties.colourmap->gl_color_ != liquid_color)
+            {
+                Colormap *ad_hoc                    = new Colormap;
+                ad_hoc->name_                       = epi::StringFormat("UDMF_%d", liquid_color); // Internal
+                ad_hoc->gl_color_                   = liquid_color;
+                ss->deep_water_properties.colourmap = ad_hoc;
+                colormaps.push_back(ad_hoc);
             }
+            ss->deep_water_properties.light_level = us.liquid_light;
+            ss->deep_water_surface.translucency   = us.liquid_trans;
+            ss->deep_water_properties.friction    = 0.9f;
+            ss->deep_water_properties.viscosity   = 0.7f;
+            ss->deep_water_properties.gravity     = 0.1f;
+            ss->deep_water_properties.drag        = 0.95f;
+            ss->deep_water_properties.special     = new SectorType();
+            SectorType *water_special = (SectorType *)ss->deep_water_properties.special; // const override
+            water_special->special_flags_ =
+                (SectorFlag)(kSectorFlagDeepWater | kSectorFlagSwimming | kSectorFlagAirLess);
         }
-    }
-    EPI_ASSERT(cur_sector == total_level_sectors);
 
-    LogDebug("LoadUDMFSectors: finished parsing TEXTMAP\n");
+        ss->sound_player = -1;
+
+        ss->old_floor_height            = ss->floor_height;
+        ss->interpolated_floor_height   = ss->floor_height;
+        ss->old_ceiling_height          = ss->ceiling_height;
+        ss->interpolated_ceiling_height = ss->ceiling_height;
+    }
 }
 
 static void LoadUDMFSideDefs()
 {
-    epi::Scanner lex(udmf_lump);
-
-    LogDebug("LoadUDMFSectors: parsing TEXTMAP\n");
-
     level_sides = new Side[total_level_sides];
     EPI_CLEAR_MEMORY(level_sides, Side, total_level_sides);
 
-    int nummapsides = 0;
-
-    for (;;)
-    {
-        std::string section;
-
-        if (!lex.GetNextToken())
-            break;
-
-        if (lex.state_.token != epi::Scanner::kIdentifier)
-            FatalError("Malformed TEXTMAP lump.\n");
-
-        // check namespace
-        if (lex.CheckToken('='))
-        {
-            lex.GetNextToken();
-            if (!lex.CheckToken(';'))
-                FatalError("Malformed TEXTMAP lump: missing ';'\n");
-            continue;
-        }
-
-        section = lex.state_.string;
-
-        if (!lex.CheckToken('{'))
-            FatalError("Malformed TEXTMAP lump: missing '{'\n");
-
-        if (section == "sidedef")
-        {
-            nummapsides++;
-            int   x = 0, y = 0;
-            float lowx = 0.0f, midx = 0.0f, highx = 0.0f;
-            float lowy = 0.0f, midy = 0.0f, highy = 0.0f;
-            float low_scx = 1.0f, mid_scx = 1.0f, high_scx = 1.0f;
-            float low_scy = 1.0f, mid_scy = 1.0f, high_scy = 1.0f;
-            int   sec_num = 0;
-            char  top_tex[10];
-            char  bottom_tex[10];
-            char  middle_tex[10];
-            strcpy(top_tex, "-");
-            strcpy(bottom_tex, "-");
-            strcpy(middle_tex, "-");
-            for (;;)
-            {
-                if (lex.CheckToken('}'))
-                    break;
-
-                std::string key;
-                std::string value;
-
-                if (!lex.GetNextToken())
-                    FatalError("Malformed TEXTMAP lump: unclosed block\n");
-
-                if (lex.state_.token != epi::Scanner::kIdentifier)
-                    FatalError("Malformed TEXTMAP lump: missing key\n");
-
-                key = lex.state_.string;
-
-                if (!lex.CheckToken('='))
-                    FatalError("Malformed TEXTMAP lump: missing '='\n");
-
-                if (!lex.GetNextToken() || lex.state_.token == '}')
-                    FatalError("Malformed TEXTMAP lump: missing value\n");
-
-                value = lex.state_.string;
+    int nummapsides = (int)udmf_sides.size();
 
-                if (!lex.CheckToken(';'))
-                    FatalError("Malformed TEXTMAP lump: missing ';'\n");
+    EPI_ASSERT(nummapsides <= total_level_sides); // sanity check
 
-                epi::StringHash key_hash(key);
-
-                switch (key_hash.Value())
-                {
-                case udmf::kOffsetX:
-                    x = lex.state_.number;
-                    break;
-                case udmf::kOffsetY:
-                    y = lex.state_.number;
-                    break;
-                case udmf::kOffsetX_Bottom:
-                    lowx = lex.state_.decimal;
-                    break;
-                case udmf::kOffsetX_Mid:
-                    midx = lex.state_.decimal;
-                    break;
-                case udmf::kOffsetX_Top:
-                    highx = lex.state_.decimal;
-                    break;
-                case udmf::kOffsetY_Bottom:
-                    lowy = lex.state_.decimal;
-                    break;
-                case udmf::kOffsetY_Mid:
-                    midy = lex.state_.decimal;
-                    break;
-                case udmf::kOffsetY_Top:
-                    highy = lex.state_.decimal;
-                    break;
-                case udmf::kScaleX_Bottom:
-                    low_scx = lex.state_.decimal;
-                    break;
-                case udmf::kScaleX_Mid:
-                    mid_scx = lex.state_.decimal;
-                    break;
-                case udmf::kScaleX_Top:
-                    high_scx = lex.state_.decimal;
-                    break;
-                case udmf::kScaleY_Bottom:
-                    low_scy = lex.state_.decimal;
-                    break;
-                case udmf::kScaleY_Mid:
-                    mid_scy = lex.state_.decimal;
-                    break;
-                case udmf::kScaleY_Top:
-                    high_scy = lex.state_.decimal;
-                    break;
-                case udmf::kTextureTop:
-                    epi::CStringCopyMax(top_tex, value.c_str(), 8);
-                    break;
-                case udmf::kTextureBottom:
-                    epi::CStringCopyMax(bottom_tex, value.c_str(), 8);
-                    break;
-                case udmf::kTextureMiddle:
-                    epi::CStringCopyMax(middle_tex, value.c_str(), 8);
-                    break;
-                case udmf::kSector:
-                    sec_num = lex.state_.number;
-                    break;
-                default:
-                    break;
-                }
-            }
-            EPI_ASSERT(nummapsides <= total_level_sides); // sanity check
+    for (int i = 0; i < nummapsides; i++)
+    {
+        const UDMFSide &usd = udmf_sides[i];
 
-            Side *sd = level_sides + nummapsides - 1;
+        Side *sd = level_sides + i;
 
-            sd->top.translucency = 1.0f;
-            sd->top.offset.X     = x;
-            sd->top.offset.Y     = y;
-            sd->top.x_matrix.X   = 1;
-            sd->top.x_matrix.Y   = 0;
-            sd->top.y_matrix.X   = 0;
-            sd->top.y_matrix.Y   = 1;
+        sd->top.translucency = 1.0f;
+        sd->top.offset.X     = usd.x;
+        sd->top.offset.Y     = usd.y;
+        sd->top.x_matrix.X   = 1;
+        sd->top.x_matrix.Y   = 0;
+        sd->top.y_matrix.X   = 0;
+        sd->top.y_matrix.Y   = 1;
 
-            sd->middle = sd->top;
-            sd->bottom = sd->top;
+        sd->middle = sd->top;
+        sd->bottom = sd->top;
 
-            sd->sector = &level_sectors[sec_num];
+        sd->sector = &level_sectors[usd.sec_num];
 
-            sd->top.image = ImageLookup(top_tex, kImageNamespaceTexture, kImageLookupNull);
+        sd->top.image = ImageLookup(usd.top_tex, kImageNamespaceTexture, kImageLookupNull);
 
-            if (sd->top.image == nullptr)
-                sd->top.image = ImageLookup(top_tex, kImageNamespaceTexture);
+        if (sd->top.image == nullptr)
+            sd->top.image = ImageLookup(usd.top_tex, kImageNamespaceTexture);
 
-            sd->middle.image = ImageLookup(middle_tex, kImageNamespaceTexture);
-            sd->bottom.image = ImageLookup(bottom_tex, kImageNamespaceTexture);
+        sd->middle.image = ImageLookup(usd.middle_tex, kImageNamespaceTexture);
+        sd->bottom.image = ImageLookup(usd.bottom_tex, kImageNamespaceTexture);
 
-            // granular scaling
-            sd->bottom.x_matrix.X = low_scx;
-            sd->middle.x_matrix.X = mid_scx;
-            sd->top.x_matrix.X    = high_scx;
-            sd->bottom.y_matrix.Y = low_scy;
-            sd->middle.y_matrix.Y = mid_scy;
-            sd->top.y_matrix.Y    = high_scy;
+        // granular scaling
+        sd->bottom.x_matrix.X = usd.low_scx;
+        sd->middle.x_matrix.X = usd.mid_scx;
+        sd->top.x_matrix.X    = usd.high_scx;
+        sd->bottom.y_matrix.Y = usd.low_scy;
+        sd->middle.y_matrix.Y = usd.mid_scy;
+        sd->top.y_matrix.Y    = usd.high_scy;
 
-            // granular offsets
-            sd->bottom.offset.X += lowx / low_scx;
-            sd->middle.offset.X += midx / mid_scx;
-            sd->top.offset.X += highx / high_scx;
-            sd->bottom.offset.Y += lowy / low_scy;
-            sd->middle.offset.Y += midy / mid_scy;
-            sd->top.offset.Y += highy / high_scy;
-            sd->top.old_offset    = sd->top.offset;
-            sd->middle.old_offset = sd->middle.offset;
-            sd->bottom.old_offset = sd->bottom.offset;
+        // granular offsets
+        sd->bottom.offset.X += usd.lowx / usd.low_scx;
+        sd->middle.offset.X += usd.midx / usd.mid_scx;
+        sd->top.offset.X += usd.highx / usd.high_scx;
+        sd->bottom.offset.Y += usd.lowy / usd.low_scy;
+        sd->middle.offset.Y += usd.midy / usd.mid_scy;
+        sd->top.offset.Y += usd.highy / usd.high_scy;
+        sd->top.old_offset    = sd->top.offset;
+        sd->middle.old_offset = sd->middle.offset;
+        sd->bottom.old_offset = sd->bottom.offset;
 
-            // handle BOOM colormaps with [242] linetype
-            sd->top.boom_colormap    = colormaps.Lookup(top_tex);
-            sd->middle.boom_colormap = colormaps.Lookup(middle_tex);
-            sd->bottom.boom_colormap = colormaps.Lookup(bottom_tex);
-        }
-        else // consume other blocks
-        {
-            for (;;)
-            {
-                if (!lex.GetNextToken() || lex.state_.token == '}')
-                    break;
-            }
-        }
+        // handle BOOM colormaps with [242] linetype
+        sd->top.boom_colormap    = colormaps.Lookup(usd.top_tex);
+        sd->middle.boom_colormap = colormaps.Lookup(usd.middle_tex);
+        sd->bottom.boom_colormap = colormaps.Lookup(usd.bottom_tex);
     }
 
     LogDebug("LoadUDMFSideDefs: post-processing linedefs & sidedefs\n");
@@ -2059,511 +2188,152 @@ static void LoadUDMFSideDefs()
 
     delete[] level_line_alphas;
     level_line_alphas = nullptr;
-
-    LogDebug("LoadUDMFSideDefs: finished parsing TEXTMAP\n");
 }
 
 static void LoadUDMFLineDefs()
 {
-    epi::Scanner lex(udmf_lump);
-
-    LogDebug("LoadUDMFLineDefs: parsing TEXTMAP\n");
-
-    int cur_line = 0;
-
-    for (;;)
+    for (int cur_line = 0; cur_line < total_level_lines; cur_line++)
     {
-        std::string section;
-
-        if (!lex.GetNextToken())
-            break;
-
-        if (lex.state_.token != epi::Scanner::kIdentifier)
-            FatalError("Malformed TEXTMAP lump.\n");
-
-        // check namespace
-        if (lex.CheckToken('='))
-        {
-            lex.GetNextToken();
-            if (!lex.CheckToken(';'))
-                FatalError("Malformed TEXTMAP lump: missing ';'\n");
-            continue;
-        }
-
-        section = lex.state_.string;
-
-        if (!lex.CheckToken('{'))
-            FatalError("Malformed TEXTMAP lump: missing '{'\n");
-
-        if (section == "linedef")
-        {
-            int   flags = 0, v1 = 0, v2 = 0;
-            int   side0 = -1, side1 = -1, tag = -1;
-            float alpha   = 1.0f;
-            int   special = 0;
-            for (;;)
-            {
-                if (lex.CheckToken('}'))
-                    break;
-
-                std::string key;
-                std::string value;
-
-                if (!lex.GetNextToken())
-                    FatalError("Malformed TEXTMAP lump: unclosed block\n");
-
-                if (lex.state_.token != epi::Scanner::kIdentifier)
-                    FatalError("Malformed TEXTMAP lump: missing key\n");
-
-                key = lex.state_.string;
-
-                if (!lex.CheckToken('='))
-                    FatalError("Malformed TEXTMAP lump: missing '='\n");
-
-                if (!lex.GetNextToken() || lex.state_.token == '}')
-                    FatalError("Malformed TEXTMAP lump: missing value\n");
-
-                value = lex.state_.string;
-
-                if (!lex.CheckToken(';'))
-                    FatalError("Malformed TEXTMAP lump: missing ';'\n");
-
-                epi::StringHash key_hash(key);
-
-                switch (key_hash.Value())
-                {
-                case udmf::kID:
-                    tag = lex.state_.number;
-                    break;
-                case udmf::kV1:
-                    v1 = lex.state_.number;
-                    break;
-                case udmf::kV2:
-                    v2 = lex.state_.number;
-                    break;
-                case udmf::kSpecial:
-                    special = lex.state_.number;
-                    break;
-                case udmf::kSideFront:
-                    side0 = lex.state_.number;
-                    break;
-                case udmf::kSideBack:
-                    side1 = lex.state_.number;
-                    break;
-                case udmf::kAlpha:
-                    alpha = lex.state_.decimal;
-                    break;
-                case udmf::kBlocking:
-                    flags |= (lex.state_.boolean ? kLineFlagBlocking : 0);
-                    break;
-                case udmf::kBlockMonsters:
-                    flags |= (lex.state_.boolean ? kLineFlagBlockMonsters : 0);
-                    break;
-                case udmf::kTwoSided:
-                    flags |= (lex.state_.boolean ? kLineFlagTwoSided : 0);
-                    break;
-                case udmf::kDontPegTop:
-                    flags |= (lex.state_.boolean ? kLineFlagUpperUnpegged : 0);
-                    break;
-                case udmf::kDontPegBottom:
-                    flags |= (lex.state_.boolean ? kLineFlagLowerUnpegged : 0);
-                    break;
-                case udmf::kSecret:
-                    flags |= (lex.state_.boolean ? kLineFlagSecret : 0);
-                    break;
-                case udmf::kBlockSound:
-                    flags |= (lex.state_.boolean ? kLineFlagSoundBlock : 0);
-                    break;
-                case udmf::kDontDraw:
-                    flags |= (lex.state_.boolean ? kLineFlagDontDraw : 0);
-                    break;
-                case udmf::kMapped:
-                    flags |= (lex.state_.boolean ? kLineFlagMapped : 0);
-                    break;
-                case udmf::kPassUse:
-                    flags |= (lex.state_.boolean ? kLineFlagBoomPassThrough : 0);
-                    break;
-                case udmf::kBlockPlayers:
-                    flags |= (lex.state_.boolean ? kLineFlagBlockPlayers : 0);
-                    break;
-                case udmf::kBlockSight:
-                    flags |= (lex.state_.boolean ? kLineFlagSightBlock : 0);
-                    break;
-                default:
-                    break;
-                }
-            }
-            Line *ld = level_lines + cur_line;
+        const UDMFLine &ul = udmf_lines[cur_line];
 
-            ld->flags    = flags;
-            ld->tag      = HMM_MAX(0, tag);
-            ld->vertex_1 = &level_vertexes[v1];
-            ld->vertex_2 = &level_vertexes[v2];
+        Line *ld = level_lines + cur_line;
 
-            ld->special = LookupLineType(HMM_MAX(0, special));
+        ld->flags    = ul.flags;
+        ld->tag      = HMM_MAX(0, ul.tag);
+        ld->vertex_1 = &level_vertexes[ul.v1];
+        ld->vertex_2 = &level_vertexes[ul.v2];
 
-            if (ld->special && ld->special->type_ == kLineTriggerWalkable)
-                ld->flags |= kLineFlagBoomPassThrough;
+        ld->special = LookupLineType(HMM_MAX(0, ul.special));
 
-            if (ld->special && ld->special->type_ == kLineTriggerNone &&
-                (ld->special->s_xspeed_ || ld->special->s_yspeed_ || ld->special->scroll_type_ > BoomScrollerTypeNone ||
-                 ld->special->line_effect_ == kLineEffectTypeVectorScroll ||
-                 ld->special->line_effect_ == kLineEffectTypeOffsetScroll ||
-                 ld->special->line_effect_ == kLineEffectTypeTaggedOffsetScroll))
-                ld->flags |= kLineFlagBoomPassThrough;
+        if (ld->special && ld->special->type_ == kLineTriggerWalkable)
+            ld->flags |= kLineFlagBoomPassThrough;
 
-            if (ld->special && ld->special->slope_type_ & kSlopeTypeDetailFloor)
-                ld->flags |= kLineFlagBoomPassThrough;
+        if (ld->special && ld->special->type_ == kLineTriggerNone &&
+            (ld->special->s_xspeed_ || ld->special->s_yspeed_ || ld->special->scroll_type_ > BoomScrollerTypeNone ||
+             ld->special->line_effect_ == kLineEffectTypeVectorScroll ||
+             ld->special->line_effect_ == kLineEffectTypeOffsetScroll ||
+             ld->special->line_effect_ == kLineEffectTypeTaggedOffsetScroll))
+            ld->flags |= kLineFlagBoomPassThrough;
 
-            if (ld->special && ld->special->slope_type_ & kSlopeTypeDetailCeiling)
-                ld->flags |= kLineFlagBoomPassThrough;
+        if (ld->special && ld->special->slope_type_ & kSlopeTypeDetailFloor)
+            ld->flags |= kLineFlagBoomPassThrough;
 
-            if (ld->special && ld->special == linetypes.Lookup(0)) // Add passthru to unknown/templated
-                ld->flags |= kLineFlagBoomPassThrough;
+        if (ld->special && ld->special->slope_type_ & kSlopeTypeDetailCeiling)
+            ld->flags |= kLineFlagBoomPassThrough;
 
-            ComputeLinedefData(ld, side0, side1);
+        if (ld->special && ld->special == linetypes.Lookup(0)) // Add passthru to unknown/templated
+            ld->flags |= kLineFlagBoomPassThrough;
 
-            BlockmapAddLine(ld);
+        ComputeLinedefData(ld, ul.side0, ul.side1);
 
-            level_line_alphas[ld - level_lines] = alpha;
+        BlockmapAddLine(ld);
 
-            cur_line++;
-        }
-        else // consume other blocks
-        {
-            for (;;)
-            {
-                if (!lex.GetNextToken() || lex.state_.token == '}')
-                    break;
-            }
-        }
+        level_line_alphas[ld - level_lines] = ul.alpha;
     }
-    EPI_ASSERT(cur_line == total_level_lines);
-
-    LogDebug("LoadUDMFLineDefs: finished parsing TEXTMAP\n");
 }
 
 static void LoadUDMFThings()
 {
-    epi::Scanner lex(udmf_lump);
-
-    LogDebug("LoadUDMFThings: parsing TEXTMAP\n");
-    while (lex.TokensLeft())
+    for (const UDMFThing &ut : udmf_things)
     {
-        std::string section;
+        float z = ut.z;
 
-        if (!lex.GetNextToken())
-            break;
+        const MapObjectDefinition *objtype = mobjtypes.Lookup(ut.typenum);
 
-        if (lex.state_.token != epi::Scanner::kIdentifier)
-            FatalError("Malformed TEXTMAP lump.\n");
-
-        // check namespace
-        if (lex.CheckToken('='))
+        // MOBJTYPE not found, don't crash out: JDS Compliance.
+        // -ACB- 1998/07/21
+        if (objtype == nullptr)
         {
-            lex.GetNextToken();
-            if (!lex.CheckToken(';'))
-                FatalError("Malformed TEXTMAP lump: missing ';'\n");
+            UnknownThingWarning(ut.typenum, ut.x, ut.y);
             continue;
         }
 
-        section = lex.state_.string;
-
-        if (!lex.CheckToken('{'))
-            FatalError("Malformed TEXTMAP lump: missing '{'\n");
-
-        if (section == "thing")
-        {
-            float                      x = 0.0f, y = 0.0f, z = 0.0f;
-            BAMAngle                   angle     = kBAMAngle0;
-            int                        options   = kThingNotSinglePlayer | kThingNotDeathmatch | kThingNotCooperative;
-            int                        typenum   = -1;
-            int                        tag       = 0;
-            float                      healthfac = 1.0f;
-            float                      alpha     = 1.0f;
-            float                      scale = 0.0f, scalex = 0.0f, scaley = 0.0f;
-            const MapObjectDefinition *objtype;
-            for (;;)
-            {
-                if (lex.CheckToken('}'))
-                    break;
-
-                std::string key;
-                std::string value;
-
-                if (!lex.GetNextToken())
-                    FatalError("Malformed TEXTMAP lump: unclosed block\n");
-
-                if (lex.state_.token != epi::Scanner::kIdentifier)
-                    FatalError("Malformed TEXTMAP lump: missing key\n");
+        Sector *sec = PointInSubsector(ut.x, ut.y)->sector;
 
-                key = lex.state_.string;
-
-                if (!lex.CheckToken('='))
-                    FatalError("Malformed TEXTMAP lump: missing '='\n");
-
-                if (!lex.GetNextToken() || lex.state_.token == '}')
-                    FatalError("Malformed TEXTMAP lump: missing value\n");
-
-                value = lex.state_.string;
-
-                if (!lex.CheckToken(';'))
-                    FatalError("Malformed TEXTMAP lump: missing ';'\n");
-
-                epi::StringHash key_hash(key);
-
-                switch (key_hash.Value())
-                {
-                case udmf::kID:
-                    tag = lex.state_.number;
-                    break;
-                case udmf::kX:
-                    x = lex.state_.decimal;
-                    break;
-                case udmf::kY:
-                    y = lex.state_.decimal;
-                    break;
-                case udmf::kHeight:
-                    z = lex.state_.decimal;
-                    break;
-                case udmf::kAngle:
-                    angle = epi::BAMFromDegrees(lex.state_.number);
-                    break;
-                case udmf::kType:
-                    typenum = lex.state_.number;
-                    break;
-                case udmf::kSkill1:
-                    options |= (lex.state_.boolean ? kThingEasy : 0);
-                    break;
-                case udmf::kSkill2:
-                    options |= (lex.state_.boolean ? kThingEasy : 0);
-                    break;
-                case udmf::kSkill3:
-                    options |= (lex.state_.boolean ? kThingMedium : 0);
-                    break;
-                case udmf::kSkill4:
-                    options |= (lex.state_.boolean ? kThingHard : 0);
-                    break;
-                case udmf::kSkill5:
-                    options |= (lex.state_.boolean ? kThingHard : 0);
-                    break;
-                case udmf::kAmbush:
-                    options |= (lex.state_.boolean ? kThingAmbush : 0);
-                    break;
-                case udmf::kSingle:
-                    options &= (lex.state_.boolean ? ~kThingNotSinglePlayer : options);
-                    break;
-                case udmf::kDM:
-                    options &= (lex.state_.boolean ? ~kThingNotDeathmatch : options);
-                    break;
-                case udmf::kCoop:
-                    options &= (lex.state_.boolean ? ~kThingNotCooperative : options);
-                    break;
-                case udmf::kFriend:
-                    options |= (lex.state_.boolean ? kThingFriend : 0);
-                    break;
-                case udmf::kHealth:
-                    healthfac = lex.state_.decimal;
-                    break;
-                case udmf::kAlpha:
-                    alpha = lex.state_.decimal;
-                    break;
-                case udmf::kScale:
-                    scale = lex.state_.decimal;
-                    break;
-                case udmf::kScaleX:
-                    scalex = lex.state_.decimal;
-                    break;
-                case udmf::kScaleY:
-                    scaley = lex.state_.decimal;
-                    break;
-                default:
-                    break;
-                }
-            }
-            objtype = mobjtypes.Lookup(typenum);
-
-            // MOBJTYPE not found, don't crash out: JDS Compliance.
-            // -ACB- 1998/07/21
-            if (objtype == nullptr)
-            {
-                UnknownThingWarning(typenum, x, y);
-                continue;
-            }
-
-            Sector *sec = PointInSubsector(x, y)->sector;
-
-            if ((objtype->hyper_flags_ & kHyperFlagMusicChanger) && !musinfo_tracks[current_map->name_].processed)
+        if ((objtype->hyper_flags_ & kHyperFlagMusicChanger) && !musinfo_tracks[current_map->name_].processed)
+        {
+            // This really should only be used with the original DoomEd
+            // number range
+            if (objtype->number_ >= 14100 && objtype->number_ < 14165)
             {
-                // This really should only be used with the original DoomEd
-                // number range
-                if (objtype->number_ >= 14100 && objtype->number_ < 14165)
-                {
-                    int mus_number = -1;
-
-                    if (objtype->number_ == 14100) // Default for level
-                        mus_number = current_map->music_;
-                    else if (musinfo_tracks[current_map->name_].mappings.count(objtype->number_ - 14100))
-                    {
-                        mus_number = musinfo_tracks[current_map->name_].mappings[objtype->number_ - 14100];
-                    }
-                    // Track found; make ad-hoc RTS script for music changing
-                    if (mus_number != -1)
-                    {
-                        std::string mus_rts = "// MUSINFO SCRIPTS\n\n";
-                        mus_rts.append(epi::StringFormat("START_MAP %s\n", current_map->name_.c_str()));
-                        mus_rts.append(epi::StringFormat("  SECTOR_TRIGGER_INDEX %td\n", sec - level_sectors));
-                        mus_rts.append("    TAGGED_INDEPENDENT\n");
-                        mus_rts.append("    TAGGED_REPEATABLE\n");
-                        mus_rts.append("    WAIT 30T\n");
-                        mus_rts.append(epi::StringFormat("    CHANGE_MUSIC %d\n", mus_number));
-                        mus_rts.append("    RETRIGGER\n");
-                        mus_rts.append("  END_SECTOR_TRIGGER\n");
-                        mus_rts.append("END_MAP\n\n");
-                        ReadRADScript(mus_rts, "MUSINFO");
-                    }
-                }
-            }
-
-            if (objtype->flags_ & kMapObjectFlagSpawnCeiling)
-                z += sec->ceiling_height - objtype->height_;
-            else
-                z += sec->floor_height;
-
-            MapObject *udmf_thing = SpawnMapThing(objtype, x, y, z, sec, angle, options, tag);
+                int mus_number = -1;
 
-            // check for UDMF-specific thing stuff
-            if (udmf_thing)
-            {
-                udmf_thing->target_visibility_ = alpha;
-                udmf_thing->alpha_             = alpha;
-                if (!AlmostEquals(healthfac, 1.0f))
-                {
-                    if (healthfac < 0)
-                    {
-                        udmf_thing->spawn_health_ = fabs(healthfac);
-                        udmf_thing->health_       = fabs(healthfac);
-                    }
-                    else
-                    {
-                        udmf_thing->spawn_health_ *= healthfac;
-                        udmf_thing->health_ *= healthfac;
-                    }
-                }
-                // Treat 'scale' and 'scalex/scaley' as one or the other; don't
-                // try to juggle both
-                if (!AlmostEquals(scale, 0.0f))
+                if (objtype->number_ == 14100) // Default for level
+                    mus_number = current_map->music_;
+                else if (musinfo_tracks[current_map->name_].mappings.count(objtype->number_ - 14100))
                 {
-                    udmf_thing->scale_ = scale;
-                    udmf_thing->height_ *= scale;
-                    udmf_thing->radius_ *= scale;
+                    mus_number = musinfo_tracks[current_map->name_].mappings[objtype->number_ - 14100];
                 }
-                else if (!AlmostEquals(scalex, 0.0f) || !AlmostEquals(scaley, 0.0f))
+                // Track found; make ad-hoc RTS script for music changing
+                if (mus_number != -1)
                 {
-                    float sx            = AlmostEquals(scalex, 0.0f) ? 1.0f : scalex;
-                    float sy            = AlmostEquals(scaley, 0.0f) ? 1.0f : scaley;
-                    udmf_thing->scale_  = sy;
-                    udmf_thing->aspect_ = (sx / sy);
-                    udmf_thing->height_ *= sy;
-                    udmf_thing->radius_ *= sx;
-                }
-            }
-
-            total_map_things++;
-        }
-        else // consume other blocks
-        {
-            for (;;)
-            {
-                if (!lex.GetNextToken() || lex.state_.token == '}')
-                    break;
-            }
-        }
-    }
-    // Mark MUSINFO for this level as done processing, even if it was empty,
-    // so we can avoid re-checks
-    musinfo_tracks[current_map->name_].processed = true;
-
-    LogDebug("LoadUDMFThings: finished parsing TEXTMAP\n");
-}
-
-static void LoadUDMFCounts()
-{
-    epi::Scanner lex(udmf_lump);
-
-    while (lex.TokensLeft())
-    {
-        std::string section;
-
-        if (!lex.GetNextToken())
-            break;
-
-        if (lex.state_.token != epi::Scanner::kIdentifier)
-            FatalError("Malformed TEXTMAP lump.\n");
-
-        section = lex.state_.string;
-
-        // check namespace
-        if (lex.CheckToken('='))
-        {
-            lex.GetNextToken();
-
-            section = lex.state_.string;
-
-            if (section != "doom" && section != "heretic" && section != "edge-classic" && section != "zdoomtranslated")
-            {
-                LogWarning("UDMF: %s uses unsupported namespace "
-                           "\"%s\"!\nSupported namespaces are \"doom\", "
-                           "\"heretic\", \"edge-classic\", or "
-                           "\"zdoomtranslated\"!\n",
-                           current_map->lump_.c_str(), section.c_str());
-            }
-
-            if (!lex.CheckToken(';'))
-                FatalError("Malformed TEXTMAP lump: missing ';'\n");
-            continue;
+                    std::string mus_rts = "// MUSINFO SCRIPTS\n\n";
+                    mus_rts.append(epi::StringFormat("START_MAP %s\n", current_map->name_.c_str()));
+                    mus_rts.append(epi::StringFormat("  SECTOR_TRIGGER_INDEX %td\n", sec - level_sectors));
+                    mus_rts.append("    TAGGED_INDEPENDENT\n");
+                    mus_rts.append("    TAGGED_REPEATABLE\n");
+                    mus_rts.append("    WAIT 30T\n");
+                    mus_rts.append(epi::StringFormat("    CHANGE_MUSIC %d\n", mus_number));
+                    mus_rts.append("    RETRIGGER\n");
+                    mus_rts.append("  END_SECTOR_TRIGGER\n");
+                    mus_rts.append("END_MAP\n\n");
+                    ReadRADScript(mus_rts, "MUSINFO");
+                }
+            }
         }
 
-        if (!lex.CheckToken('{'))
-            FatalError("Malformed TEXTMAP lump: missing '{'\n");
+        if (objtype->flags_ & kMapObjectFlagSpawnCeiling)
+            z += sec->ceiling_height - objtype->height_;
+        else
+            z += sec->floor_height;
 
-        epi::StringHash section_hash(section);
+        MapObject *udmf_thing = SpawnMapThing(objtype, ut.x, ut.y, z, sec, ut.angle, ut.options, ut.tag);
 
-        // side counts are computed during linedef loading
-        switch (section_hash.Value())
+        // check for UDMF-specific thing stuff
+        if (udmf_thing)
         {
-        case udmf::kThing:
-            total_map_things++;
-            break;
-        case udmf::kVertex:
-            total_level_vertexes++;
-            break;
-        case udmf::kSector:
-            total_level_sectors++;
-            break;
-        case udmf::kLinedef:
-            total_level_lines++;
-            break;
-        default:
-            break;
+            udmf_thing->target_visibility_ = ut.alpha;
+            udmf_thing->alpha_             = ut.alpha;
+            if (!AlmostEquals(ut.healthfac, 1.0f))
+            {
+                if (ut.healthfac < 0)
+                {
+                    udmf_thing->spawn_health_ = fabs(ut.healthfac);
+                    udmf_thing->health_       = fabs(ut.healthfac);
+                }
+                else
+                {
+                    udmf_thing->spawn_health_ *= ut.healthfac;
+                    udmf_thing->health_ *= ut.healthfac;
+                }
+            }
+            // Treat 'scale' and 'scalex/scaley' as one or the other; don't
+            // try to juggle both
+            if (!AlmostEquals(ut.scale, 0.0f))
+            {
+                udmf_thing->scale_ = ut.scale;
+                udmf_thing->height_ *= ut.scale;
+                udmf_thing->radius_ *= ut.scale;
+            }
+            else if (!AlmostEquals(ut.scalex, 0.0f) || !AlmostEquals(ut.scaley, 0.0f))
+            {
+                float sx            = AlmostEquals(ut.scalex, 0.0f) ? 1.0f : ut.scalex;
+                float sy            = AlmostEquals(ut.scaley, 0.0f) ? 1.0f : ut.scaley;
+                udmf_thing->scale_  = sy;
+                udmf_thing->aspect_ = (sx / sy);
+                udmf_thing->height_ *= sy;
+                udmf_thing->radius_ *= sx;
+            }
         }
 
-        // ignore block contents
-        for (;;)
-        {
-            if (!lex.GetNextToken() || lex.state_.token == '}')
-                break;
-        }
+        total_map_things++;
     }
 
-    // initialize arrays
-    level_vertexes = new Vertex[total_level_vertexes];
-    level_sectors  = new Sector[total_level_sectors];
-    EPI_CLEAR_MEMORY(level_sectors, Sector, total_level_sectors);
-    level_lines = new Line[total_level_lines];
-    EPI_CLEAR_MEMORY(level_lines, Line, total_level_lines);
-    level_line_alphas = new float[total_level_lines];
-    temp_line_sides   = new int[total_level_lines * 2];
+    // Mark MUSINFO for this level as done processing, even if it was empty,
+    // so we can avoid re-checks
+    musinfo_tracks[current_map->name_].processed = true;
+
+    FreeUDMFData();
 }
 
 static void TransferMapSideDef(const RawSidedef *msd, Side *sd, bool two_sided)
@@ -2701,14 +2471,10 @@ static void SetupSlidingDoors(void)
             ld->slide_door = ld->special;
         else
         {
-            for (int k = 0; k < total_level_lines; k++)
+            for (Line *other : FindLinesFromTag(ld->tag))
             {
-                Line *other = level_lines + k;
-
-                if (other->tag != ld->tag || other == ld)
-                    continue;
-
-                other->slide_door = ld->special;
+                if (other != ld)
+                    other->slide_door = ld->special;
             }
         }
     }
@@ -2856,6 +2622,25 @@ static void DetectDeepWaterTrick(void)
     delete[] self_subs;
 }
 
+// Fills in each seg's back subsector and front/back sectors.
+static void LinkSegSectors(void)
+{
+    // setup remaining seg information
+    Seg *seg = level_segs;
+
+    for (int i = 0; i < total_level_segs; i++, seg++)
+    {
+        if (seg->partner)
+            seg->back_subsector = seg->partner->front_subsector;
+
+        if (!seg->front_sector)
+            seg->front_sector = seg->front_subsector->sector;
+
+        if (!seg->back_sector && seg->back_subsector)
+            seg->back_sector = seg->back_subsector->sector;
+    }
+}
+
 //
 // GroupLines
 //
@@ -2869,22 +2654,10 @@ void GroupLines(void)
     int     total;
     Line   *li;
     Sector *sector;
-    Seg    *seg;
     float   bbox[4];
     Line  **line_p;
 
-    // setup remaining seg information
-    for (i = 0, seg = level_segs; i < total_level_segs; i++, seg++)
-    {
-        if (seg->partner)
-            seg->back_subsector = seg->partner->front_subsector;
-
-        if (!seg->front_sector)
-            seg->front_sector = seg->front_subsector->sector;
-
-        if (!seg->back_sector && seg->back_subsector)
-            seg->back_sector = seg->back_subsector->sector;
-    }
+    LinkSegSectors();
 
     // count number of lines in each sector
     li    = level_lines;
@@ -3190,6 +2963,8 @@ static void CreateVertexSeclists(void)
     //         and simultaneously give them index numbers.
     int num_triples = 0;
 
+    total_level_vertex_sector_lists = 0;
+
     for (i = 0; i < total_level_vertexes; i++)
     {
         if (branches[i] < 3)
@@ -3207,6 +2982,8 @@ static void CreateVertexSeclists(void)
     }
 
     // step 3: create a vertex_seclist for those multi-branches
+    total_level_vertex_sector_lists = num_triples;
+
     level_vertex_sector_lists = new VertexSectorList[num_triples];
 
     EPI_CLEAR_MEMORY(level_vertex_sector_lists, VertexSectorList, num_triples);
@@ -3249,6 +3026,411 @@ static void CreateVertexSeclists(void)
     delete[] branches;
 }
 
+//
+// COMPILED MAP CACHE
+//
+// The sector line lists, vertex slopes, deep water references and vertex
+// sector lists only depend on the map geometry and its nodes, but working
+// them out is the slow part of entering a big map (GroupLines compares
+// every sector against every line).  Once computed they are written to
+// the cache directory as flat arrays of indices, keyed by the MD5 of the
+// map lumps, the XGL nodes and the engine version, and simply read back
+// on later visits.
+//
+// Anything derived from DDF (specials, images, colormaps) is not stored,
+// so changing mods never picks up stale data.
+//
+
+static constexpr char     kCompiledMapMagic[8]   = {'E', 'D', 'G', 'E', 'C', 'M', 'A', 'P'};
+static constexpr uint32_t kCompiledMapVersion    = 1;
+static constexpr uint32_t kCompiledMapByteOrder  = 0x01020304;
+
+// All sections are stored as offsets from the start of the file, so the
+// whole thing can be read (or mapped) in one go and used in place.
+struct CompiledMapHeader
+{
+    char     magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+
+    int32_t total_vertexes;
+    int32_t total_sectors;
+    int32_t total_lines;
+    int32_t total_subsectors;
+    int32_t total_segs;
+    int32_t total_line_refs;
+    int32_t total_seclists;
+
+    uint32_t sectors_offset;
+    uint32_t line_refs_offset;
+    uint32_t subsectors_offset;
+    uint32_t seclists_offset;
+    uint32_t seg_seclists_offset;
+    uint32_t file_size;
+};
+
+struct CompiledMapSector
+{
+    int32_t  first_line;
+    int32_t  line_count;
+    Position sound_effects_origin;
+    uint8_t  floor_vertex_slope;
+    uint8_t  ceiling_vertex_slope;
+    uint8_t  padding[2];
+    HMM_Vec3 floor_z_vertices[3];
+    HMM_Vec3 ceiling_z_vertices[3];
+    HMM_Vec3 floor_vertex_slope_normal;
+    HMM_Vec3 ceiling_vertex_slope_normal;
+    HMM_Vec2 floor_vertex_slope_high_low;
+    HMM_Vec2 ceiling_vertex_slope_high_low;
+};
+
+static std::string compiled_map_filename;
+static uint8_t    *compiled_map_data = nullptr;
+
+static void ComputeCompiledMapFilename(int lumpnum, int xgl_lump)
+{
+    compiled_map_filename.clear();
+
+    if (map_cache.d_ == 0)
+        return;
+
+    std::string key = epi::StringFormat("%.8s %u %s %d\n", kCompiledMapMagic, kCompiledMapVersion,
+                                        edge_version.c_str(), udmf_level ? 1 : 0);
+
+    if (udmf_level)
+        key.append(udmf_lump);
+    else
+    {
+        const int geometry_lumps[4] = {kLumpVertexes, kLumpSectors, kLumpLinedefs, kLumpSidedefs};
+
+        for (int offset : geometry_lumps)
+        {
+            int      length = 0;
+            uint8_t *data   = LoadLumpIntoMemory(lumpnum + offset, &length);
+            key.append((const char *)data, length);
+            delete[] data;
+        }
+    }
+
+    int      xgl_length = 0;
+    uint8_t *xgl_data   = LoadLumpIntoMemory(xgl_lump, &xgl_length);
+    key.append((const char *)xgl_data, xgl_length);
+    delete[] xgl_data;
+
+    epi::MD5Hash key_md5((const uint8_t *)key.data(), (unsigned int)key.size());
+
+    std::string cache_name = current_map->lump_;
+    cache_name += "-";
+    cache_name += key_md5.ToString();
+    cache_name += ".ecm";
+
+    compiled_map_filename = epi::PathAppend(cache_directory, cache_name);
+}
+
+static const CompiledMapHeader *OpenCompiledMap(void)
+{
+    if (compiled_map_filename.empty())
+        return nullptr;
+
+    epi::File *fp = epi::FileOpen(compiled_map_filename, epi::kFileAccessRead | epi::kFileAccessBinary);
+
+    if (!fp)
+        return nullptr;
+
+    int length        = fp->GetLength();
+    compiled_map_data = fp->LoadIntoMemory();
+
+    delete fp;
+
+    if (!compiled_map_data)
+        return nullptr;
+
+    const CompiledMapHeader *header = (const CompiledMapHeader *)compiled_map_data;
+
+    bool valid = length >= (int)sizeof(CompiledMapHeader) && memcmp(header->magic, kCompiledMapMagic, 8) == 0 &&
+                 header->version == kCompiledMapVersion && header->byte_order == kCompiledMapByteOrder &&
+                 header->file_size == (uint32_t)length && header->total_vertexes == total_level_vertexes &&
+                 header->total_sectors == total_level_sectors && header->total_lines == total_level_lines &&
+                 header->total_subsectors == total_level_subsectors && header->total_segs == total_level_segs;
+
+    if (valid)
+    {
+        // every section must lie inside the file
+        uint64_t end = (uint64_t)length;
+
+        valid = header->sectors_offset + (uint64_t)header->total_sectors * sizeof(CompiledMapSector) <= end &&
+                header->line_refs_offset + (uint64_t)header->total_line_refs * sizeof(int32_t) <= end &&
+                header->subsectors_offset + (uint64_t)header->total_subsectors * sizeof(int32_t) <= end &&
+                header->seclists_offset + (uint64_t)header->total_seclists * sizeof(VertexSectorList) <= end &&
+                header->seg_seclists_offset + (uint64_t)header->total_segs * 2 * sizeof(int32_t) <= end;
+    }
+
+    if (!valid)
+    {
+        LogWarning("Ignoring bad compiled map cache: %s\n", compiled_map_filename.c_str());
+
+        delete[] compiled_map_data;
+        compiled_map_data = nullptr;
+        return nullptr;
+    }
+
+    return header;
+}
+
+static void CloseCompiledMap(void)
+{
+    delete[] compiled_map_data;
+    compiled_map_data = nullptr;
+}
+
+// Restores the line lists, slopes and deep water references.  Returns
+// false (having changed nothing) when there is no usable cache file.
+// The vertex sector lists are restored later by LoadCompiledSeclists().
+static bool LoadCompiledMap(void)
+{
+    const CompiledMapHeader *header = OpenCompiledMap();
+
+    if (!header)
+        return false;
+
+    const CompiledMapSector *sectors   = (const CompiledMapSector *)(compiled_map_data + header->sectors_offset);
+    const int32_t           *line_refs = (const int32_t *)(compiled_map_data + header->line_refs_offset);
+    const int32_t           *deep_refs = (const int32_t *)(compiled_map_data + header->subsectors_offset);
+
+    // validate the indices before touching the level
+    for (int i = 0; i < header->total_line_refs; i++)
+    {
+        if (line_refs[i] < 0 || line_refs[i] >= total_level_lines)
+        {
+            CloseCompiledMap();
+            return false;
+        }
+    }
+
+    for (int i = 0; i < total_level_sectors; i++)
+    {
+        const CompiledMapSector &cs = sectors[i];
+
+        if (cs.first_line < 0 || cs.line_count < 0 || cs.first_line + cs.line_count > header->total_line_refs)
+        {
+            CloseCompiledMap();
+            return false;
+        }
+    }
+
+    for (int i = 0; i < total_level_subsectors; i++)
+    {
+        if (deep_refs[i] < -1 || deep_refs[i] >= total_level_sectors)
+        {
+            CloseCompiledMap();
+            return false;
+        }
+    }
+
+    // the vertex sector lists are only restored later, but a bad one
+    // must still mean a full rebuild
+    const VertexSectorList *seclists     = (const VertexSectorList *)(compiled_map_data + header->seclists_offset);
+    const int32_t          *seg_seclists = (const int32_t *)(compiled_map_data + header->seg_seclists_offset);
+
+    for (int i = 0; i < header->total_seclists; i++)
+    {
+        const VertexSectorList &L = seclists[i];
+
+        if (L.total > kVertexSectorListMaximum)
+        {
+            CloseCompiledMap();
+            return false;
+        }
+
+        for (int k = 0; k < L.total; k++)
+        {
+            if (L.sectors[k] >= total_level_sectors)
+            {
+                CloseCompiledMap();
+                return false;
+            }
+        }
+    }
+
+    for (int i = 0; i < total_level_segs * 2; i++)
+    {
+        if (seg_seclists[i] < -1 || seg_seclists[i] >= header->total_seclists)
+        {
+            CloseCompiledMap();
+            return false;
+        }
+    }
+
+    LinkSegSectors();
+
+    level_line_buffer = new Line *[header->total_line_refs];
+
+    for (int i = 0; i < header->total_line_refs; i++)
+        level_line_buffer[i] = level_lines + line_refs[i];
+
+    for (int i = 0; i < total_level_sectors; i++)
+    {
+        const CompiledMapSector &cs  = sectors[i];
+        Sector                  *sec = level_sectors + i;
+
+        sec->lines                = level_line_buffer + cs.first_line;
+        sec->line_count           = cs.line_count;
+        sec->sound_effects_origin = cs.sound_effects_origin;
+        sec->floor_vertex_slope   = cs.floor_vertex_slope != 0;
+        sec->ceiling_vertex_slope = cs.ceiling_vertex_slope != 0;
+
+        memcpy(sec->floor_z_vertices, cs.floor_z_vertices, sizeof(sec->floor_z_vertices));
+        memcpy(sec->ceiling_z_vertices, cs.ceiling_z_vertices, sizeof(sec->ceiling_z_vertices));
+
+        sec->floor_vertex_slope_normal     = cs.floor_vertex_slope_normal;
+        sec->ceiling_vertex_slope_normal   = cs.ceiling_vertex_slope_normal;
+        sec->floor_vertex_slope_high_low   = cs.floor_vertex_slope_high_low;
+        sec->ceiling_vertex_slope_high_low = cs.ceiling_vertex_slope_high_low;
+    }
+
+    for (int i = 0; i < total_level_subsectors; i++)
+        level_subsectors[i].deep_water_reference = (deep_refs[i] < 0) ? nullptr : level_sectors + deep_refs[i];
+
+    return true;
+}
+
+static void LoadCompiledSeclists(void)
+{
+    EPI_ASSERT(compiled_map_data);
+
+    const CompiledMapHeader *header = (const CompiledMapHeader *)compiled_map_data;
+
+    const VertexSectorList *seclists     = (const VertexSectorList *)(compiled_map_data + header->seclists_offset);
+    const int32_t          *seg_seclists = (const int32_t *)(compiled_map_data + header->seg_seclists_offset);
+
+    level_vertex_sector_lists       = nullptr;
+    total_level_vertex_sector_lists = header->total_seclists;
+
+    if (header->total_seclists > 0)
+    {
+        level_vertex_sector_lists = new VertexSectorList[header->total_seclists];
+        memcpy(level_vertex_sector_lists, seclists, header->total_seclists * sizeof(VertexSectorList));
+    }
+
+    for (int i = 0; i < total_level_segs; i++)
+    {
+        for (int vert = 0; vert < 2; vert++)
+        {
+            int index = seg_seclists[i * 2 + vert];
+
+            // checked by LoadCompiledMap()
+            if (index >= 0)
+                level_segs[i].vertex_sectors[vert] = level_vertex_sector_lists + index;
+        }
+    }
+
+    CloseCompiledMap();
+}
+
+static void SaveCompiledMap(void)
+{
+    if (compiled_map_filename.empty())
+        return;
+
+    int total_line_refs = 0;
+    for (int i = 0; i < total_level_sectors; i++)
+        total_line_refs += level_sectors[i].line_count;
+
+    int total_seclists = total_level_vertex_sector_lists;
+
+    CompiledMapHeader header;
+    EPI_CLEAR_MEMORY(&header, CompiledMapHeader, 1);
+
+    memcpy(header.magic, kCompiledMapMagic, 8);
+    header.version          = kCompiledMapVersion;
+    header.byte_order       = kCompiledMapByteOrder;
+    header.total_vertexes   = total_level_vertexes;
+    header.total_sectors    = total_level_sectors;
+    header.total_lines      = total_level_lines;
+    header.total_subsectors = total_level_subsectors;
+    header.total_segs       = total_level_segs;
+    header.total_line_refs  = total_line_refs;
+    header.total_seclists   = total_seclists;
+
+    header.sectors_offset      = sizeof(CompiledMapHeader);
+    header.line_refs_offset    = header.sectors_offset + total_level_sectors * sizeof(CompiledMapSector);
+    header.subsectors_offset   = header.line_refs_offset + total_line_refs * sizeof(int32_t);
+    header.seclists_offset     = header.subsectors_offset + total_level_subsectors * sizeof(int32_t);
+    // the seclists are shorts, keep the following section aligned
+    header.seg_seclists_offset = (header.seclists_offset + total_seclists * sizeof(VertexSectorList) + 3) & ~3u;
+    header.file_size           = header.seg_seclists_offset + total_level_segs * 2 * sizeof(int32_t);
+
+    std::vector<uint8_t> data(header.file_size, 0);
+
+    memcpy(data.data(), &header, sizeof(header));
+
+    CompiledMapSector *sectors      = (CompiledMapSector *)(data.data() + header.sectors_offset);
+    int32_t           *line_refs    = (int32_t *)(data.data() + header.line_refs_offset);
+    int32_t           *deep_refs    = (int32_t *)(data.data() + header.subsectors_offset);
+    int32_t           *seg_seclists = (int32_t *)(data.data() + header.seg_seclists_offset);
+
+    for (int i = 0; i < total_line_refs; i++)
+        line_refs[i] = (int32_t)(level_line_buffer[i] - level_lines);
+
+    for (int i = 0; i < total_level_sectors; i++)
+    {
+        const Sector      *sec = level_sectors + i;
+        CompiledMapSector &cs  = sectors[i];
+
+        cs.first_line           = (int32_t)(sec->lines - level_line_buffer);
+        cs.line_count           = sec->line_count;
+        cs.sound_effects_origin = sec->sound_effects_origin;
+        cs.floor_vertex_slope   = sec->floor_vertex_slope ? 1 : 0;
+        cs.ceiling_vertex_slope = sec->ceiling_vertex_slope ? 1 : 0;
+
+        memcpy(cs.floor_z_vertices, sec->floor_z_vertices, sizeof(cs.floor_z_vertices));
+        memcpy(cs.ceiling_z_vertices, sec->ceiling_z_vertices, sizeof(cs.ceiling_z_vertices));
+
+        cs.floor_vertex_slope_normal     = sec->floor_vertex_slope_normal;
+        cs.ceiling_vertex_slope_normal   = sec->ceiling_vertex_slope_normal;
+        cs.floor_vertex_slope_high_low   = sec->floor_vertex_slope_high_low;
+        cs.ceiling_vertex_slope_high_low = sec->ceiling_vertex_slope_high_low;
+    }
+
+    for (int i = 0; i < total_level_subsectors; i++)
+    {
+        const Sector *ref = level_subsectors[i].deep_water_reference;
+        deep_refs[i]      = ref ? (int32_t)(ref - level_sectors) : -1;
+    }
+
+    if (total_seclists > 0)
+    {
+        memcpy(data.data() + header.seclists_offset, level_vertex_sector_lists,
+               total_seclists * sizeof(VertexSectorList));
+    }
+
+    for (int i = 0; i < total_level_segs; i++)
+    {
+        for (int vert = 0; vert < 2; vert++)
+        {
+            const VertexSectorList *L = level_segs[i].vertex_sectors[vert];
+            seg_seclists[i * 2 + vert] = L ? (int32_t)(L - level_vertex_sector_lists) : -1;
+        }
+    }
+
+    epi::File *fp = epi::FileOpen(compiled_map_filename, epi::kFileAccessWrite | epi::kFileAccessBinary);
+
+    if (!fp)
+    {
+        LogWarning("Unable to write compiled map cache: %s\n", compiled_map_filename.c_str());
+        return;
+    }
+
+    fp->Write(data.data(), header.file_size);
+
+    delete fp;
+
+    epi::SyncFilesystem();
+
+    LogDebug("Wrote compiled map cache: %s (%u bytes)\n", compiled_map_filename.c_str(), header.file_size);
+}
+
 static void P_RemoveSectorStuff(void)
 {
     int i;
@@ -3274,6 +3456,7 @@ void ShutdownLevel(void)
     level_active = false;
 
     RendererShutdownLevel();
+    HUDClearWorldViews();
 
     ClearRespawnQueue();
 
@@ -3289,6 +3472,9 @@ void ShutdownLevel(void)
 
     DDFBoomClearGeneralizedTypes();
 
+    DestroyTagIndex();
+    ShutdownSightPrepass();
+
     delete[] level_segs;
     level_segs = nullptr;
     delete[] level_nodes;
@@ -3415,13 +3601,15 @@ void LevelSetup(void)
     }
     else
     {
-        LoadUDMFCounts();
+        ParseUDMF();
         LoadUDMFVertexes();
         LoadUDMFSectors();
         LoadUDMFLineDefs();
         LoadUDMFSideDefs();
     }
 
+    CreateTagIndex();
+
     SetupSlidingDoors();
     SetupVertGaps();
 
@@ -3429,9 +3617,16 @@ void LevelSetup(void)
 
     LoadXGL3Nodes(xgl_lump);
 
-    GroupLines();
+    ComputeCompiledMapFilename(lumpnum, xgl_lump);
+
+    bool compiled = LoadCompiledMap();
+
+    if (!compiled)
+    {
+        GroupLines();
 
-    DetectDeepWaterTrick();
+        DetectDeepWaterTrick();
+    }
 
     ComputeSkyHeights();
 
@@ -3464,7 +3659,13 @@ void LevelSetup(void)
     LogDebug("MAP CRCS: S=%08x L=%08x T=%08x\n", map_sectors_crc.crc, map_lines_crc.crc, map_things_crc.crc);
 #endif
 
-    CreateVertexSeclists();
+    if (compiled)
+        LoadCompiledSeclists();
+    else
+    {
+        CreateVertexSeclists();
+        SaveCompiledMap();
+    }
 
     SpawnMapSpecials2(current_map->autotag_);
 
@@ -35,18 +35,22 @@
 //  slopes that block the view.
 //
 
+#include <limits.h>
 #include <math.h>
 
+#include <unordered_map>
 #include <vector>
 
 #include "AlmostEquals.h"
 #include "dm_defs.h"
 #include "epi.h"
+#include "edge_profiling.h"
 #include "epi_doomdefs.h"
 #include "m_bbox.h"
 #include "p_local.h"
 #include "r_misc.h"
 #include "r_state.h"
+#include "thread.h"
 
 #define EDGE_DEBUG_SIGHT 0
 
@@ -84,8 +88,6 @@ struct LineOfSight
     bool saw_vertex_slopes;
 };
 
-static LineOfSight sight_check;
-
 // intercepts found during first pass
 
 struct WallIntercept
@@ -97,17 +99,44 @@ struct WallIntercept
     Sector *sector;
 };
 
-// intercept array
-static std::vector<WallIntercept> wall_intercepts;
+//
+// Everything one line-of-sight test writes to.  The game thread has its
+// own, and each sight worker has one, so tests can run side by side
+// while nothing moves.
+//
+struct SightQuery
+{
+    LineOfSight sight_check;
+
+    std::vector<WallIntercept> wall_intercepts;
+
+    // lines already visited by this query; Line::valid_count can't be
+    // used since every traversal on the game thread shares it.
+    std::vector<int> line_checked;
+    int              line_check_count = 0;
+};
+
+static SightQuery game_sight_query;
+
+static void BeginLineChecks(SightQuery &query)
+{
+    if ((int)query.line_checked.size() != total_level_lines || query.line_check_count == INT_MAX)
+    {
+        query.line_checked.assign(total_level_lines, 0);
+        query.line_check_count = 0;
+    }
+
+    query.line_check_count++;
+}
 
-static inline void AddSightIntercept(float frac, Sector *sec)
+static inline void AddSightIntercept(SightQuery &query, float frac, Sector *sec)
 {
     WallIntercept WI;
 
     WI.along  = frac;
     WI.sector = sec;
 
-    wall_intercepts.push_back(WI);
+    query.wall_intercepts.push_back(WI);
 }
 
 //
@@ -116,8 +145,10 @@ static inline void AddSightIntercept(float frac, Sector *sec)
 // Returns false if LOS is blocked by the given subsector, otherwise
 // true.
 //
-static bool CrossSubsector(Subsector *sub)
+static bool CrossSubsector(SightQuery &query, Subsector *sub)
 {
+    LineOfSight &sight_check = query.sight_check;
+
     Seg  *seg;
     Line *ld;
 
@@ -145,10 +176,12 @@ static bool CrossSubsector(Subsector *sub)
         ld = seg->linedef;
 
         // line already checked ? (e.g. multiple segs on it)
-        if (ld->valid_count == valid_count)
+        int &checked = query.line_checked[ld - level_lines];
+
+        if (checked == query.line_check_count)
             continue;
 
-        ld->valid_count = valid_count;
+        checked = query.line_check_count;
 
         // line outside of bbox ?
         if (ld->bounding_box[kBoundingBoxLeft] > sight_check.bounding_box[kBoundingBoxRight] ||
@@ -240,7 +273,7 @@ static bool CrossSubsector(Subsector *sub)
             return false;
 
         // shouldn't be any more matching linedefs
-        AddSightIntercept(frac, front);
+        AddSightIntercept(query, frac, front);
         return true;
     }
 
@@ -253,8 +286,10 @@ static bool CrossSubsector(Subsector *sub)
 //
 // Returns false if LOS is blocked by the given node, otherwise true.
 //
-static bool CheckSightBSP(unsigned int bspnum)
+static bool CheckSightBSP(SightQuery &query, unsigned int bspnum)
 {
+    LineOfSight &sight_check = query.sight_check;
+
     while (!(bspnum & kLeafSubsector))
     {
         BSPNode *node = level_nodes + bspnum;
@@ -279,7 +314,7 @@ static bool CheckSightBSP(unsigned int bspnum)
 
         if (s1 != s2)
         {
-            if (!CheckSightBSP(node->children[s1]))
+            if (!CheckSightBSP(query, node->children[s1]))
                 return false;
         }
 
@@ -305,9 +340,9 @@ static bool CheckSightBSP(unsigned int bspnum)
         // subsector and the target object is inside its subsector.
 
         if (sub != sight_check.destination_subsector)
-            return CrossSubsector(sub);
+            return CrossSubsector(query, sub);
 
-        AddSightIntercept(1.0f, sub->sector);
+        AddSightIntercept(query, 1.0f, sub->sector);
     }
 
     return true;
@@ -371,9 +406,10 @@ static bool CheckSightBSP(unsigned int bspnum)
 // CheckSightSameSubsector
 //
 //
-static bool CheckSightSameSubsector(MapObject *src, MapObject *dest)
+static bool CheckSightSameSubsector(SightQuery &query, MapObject *src, MapObject *dest)
 {
-    Sector *sec;
+    LineOfSight &sight_check = query.sight_check;
+    Sector      *sec;
 
     float lower_z;
     float upper_z;
@@ -408,14 +444,23 @@ static bool CheckSightSameSubsector(MapObject *src, MapObject *dest)
     return false;
 }
 
-bool CheckSight(MapObject *src, MapObject *dest)
+enum SightResult
 {
-    if (!dest)
-        return false;
+    kSightBlocked = 0,
+    kSightClear,
+    // vertex slopes were crossed, which needs the hitscan code; that
+    // spawns nothing but does touch shared state, so the game thread
+    // has to finish the test.
+    kSightNeedsHitscan
+};
 
-    // -ACB- 1998/07/20 t2 is Invisible, t1 cannot possibly see it.
-    if (AlmostEquals(dest->visibility_, 0.0f))
-        return false;
+//
+// The part of CheckSight which only reads the level.  Safe to run on a
+// sight worker as long as nothing is moving.
+//
+static SightResult TraceSight(SightQuery &query, MapObject *src, MapObject *dest)
+{
+    LineOfSight &sight_check = query.sight_check;
 
     float dist_a;
 
@@ -427,7 +472,7 @@ bool CheckSight(MapObject *src, MapObject *dest)
     // An unobstructed LOS is possible.
     // Now look from eyes of t1 to any part of t2.
 
-    valid_count++;
+    BeginLineChecks(query);
 
     // The "eyes" of a thing is 75% of its height.
     EPI_ASSERT(src->info_);
@@ -454,7 +499,7 @@ bool CheckSight(MapObject *src, MapObject *dest)
         if (src->info_->sight_distance_ < dist_a)
         {
             // src->SetTarget(nullptr); //forget we even saw the guy?
-            return false; // too far away for this thing to see
+            return kSightBlocked; // too far away for this thing to see
         }
     }
 
@@ -471,15 +516,15 @@ bool CheckSight(MapObject *src, MapObject *dest)
 #endif
 
     if (sight_check.top_slope < dist_a * -src->info_->sight_slope_)
-        return false;
+        return kSightBlocked;
 
     if (sight_check.bottom_slope > dist_a * src->info_->sight_slope_)
-        return false;
+        return kSightBlocked;
 
     // -AJA- handle the case where no linedefs are crossed
     if (src->subsector_ == dest->subsector_)
     {
-        return CheckSightSameSubsector(src, dest);
+        return CheckSightSameSubsector(query, src, dest) ? kSightClear : kSightBlocked;
     }
 
     sight_check.angle =
@@ -490,45 +535,364 @@ bool CheckSight(MapObject *src, MapObject *dest)
     sight_check.bounding_box[kBoundingBoxBottom] = HMM_MIN(sight_check.source.y, sight_check.destination.Y);
     sight_check.bounding_box[kBoundingBoxTop]    = HMM_MAX(sight_check.source.y, sight_check.destination.Y);
 
-    wall_intercepts.clear(); // FIXME
+    query.wall_intercepts.clear(); // FIXME
 
     sight_check.saw_vertex_slopes = false;
 
     // initial pass -- check for basic blockage & create intercepts
-    if (!CheckSightBSP(root_node))
-        return false;
+    if (!CheckSightBSP(query, root_node))
+        return kSightBlocked;
 
     // no vertslopes encountered ?  Then the checks made by
     // CheckSightBSP are sufficient.  (-AJA- double check this)
     //
     if (!sight_check.saw_vertex_slopes)
+        return kSightClear;
+
+    return kSightNeedsHitscan;
+}
+
+//----------------------------------------------------------------------------
+//
+//  SIGHT PRE-PASS
+//
+//  When enabled, RunMapObjectThinkers first works out, across several
+//  threads, the sight checks its monsters are likely to make: only
+//  monsters whose state (and so action) changes this tic, towards
+//  their target, or the players in view when they have none.  The
+//  think loop then runs serially as always and CheckSight answers from
+//  these results.
+//
+//  An entry only answers a query if every input of the test matches:
+//  both things' positions and heights, the looker's type and no sector
+//  or line having changed since.  Anything that moved during the tic
+//  is simply traced again, so the outcome never depends on the pre-pass
+//  or on the number of threads.
+//
+
+EDGE_DEFINE_CONSOLE_VARIABLE(thinker_sight_threads, "0", kConsoleVariableFlagArchive)
+
+static constexpr int kMaximumSightWorkers = 8;
+
+struct SightPrepassEntry
+{
+    MapObject                 *source;
+    MapObject                 *destination;
+    const MapObjectDefinition *source_info;
+
+    float source_x, source_y, source_z, source_height;
+    float destination_x, destination_y, destination_z, destination_height;
+
+    int generation;
+
+    SightResult result;
+};
+
+static std::vector<SightPrepassEntry> sight_prepass;
+
+// first entry for each looker; a looker's entries are contiguous
+static std::unordered_map<MapObject *, int> sight_prepass_lookers;
+
+static bool sight_prepass_active      = false;
+static int  sight_geometry_generation = 0;
+
+struct SightWorker
+{
+    thread_ptr_t    thread;
+    thread_signal_t start;
+    SightQuery      query;
+};
+
+static SightWorker        *sight_workers[kMaximumSightWorkers];
+static int                 sight_worker_count = 0;
+static thread_atomic_int_t sight_next_job;
+static thread_atomic_int_t sight_busy_workers;
+static thread_atomic_int_t sight_workers_exit;
+
+void SightGeometryChanged(void)
+{
+    sight_geometry_generation++;
+}
+
+static void RunSightJobs(SightQuery &query)
+{
+    const int total = (int)sight_prepass.size();
+
+    for (;;)
+    {
+        int job = thread_atomic_int_inc(&sight_next_job);
+        if (job >= total)
+            break;
+
+        SightPrepassEntry &entry = sight_prepass[job];
+        entry.result             = TraceSight(query, entry.source, entry.destination);
+    }
+}
+
+static int32_t SightWorkerProc(void *thread_data)
+{
+    SightWorker *worker = (SightWorker *)thread_data;
+
+    for (;;)
+    {
+        thread_signal_wait(&worker->start, THREAD_SIGNAL_WAIT_INFINITE);
+
+        if (thread_atomic_int_load(&sight_workers_exit))
+            break;
+
+        RunSightJobs(worker->query);
+
+        thread_atomic_int_dec(&sight_busy_workers);
+    }
+
+    return 0;
+}
+
+static void StopSightWorkers(void)
+{
+    if (sight_worker_count == 0)
+        return;
+
+    thread_atomic_int_store(&sight_workers_exit, 1);
+
+    for (int i = 0; i < sight_worker_count; i++)
+    {
+        thread_signal_raise(&sight_workers[i]->start);
+        thread_join(sight_workers[i]->thread);
+        thread_destroy(sight_workers[i]->thread);
+        thread_signal_term(&sight_workers[i]->start);
+        delete sight_workers[i];
+        sight_workers[i] = nullptr;
+    }
+
+    sight_worker_count = 0;
+}
+
+static void StartSightWorkers(int count)
+{
+    count = HMM_Clamp(0, count, kMaximumSightWorkers);
+
+    if (count == sight_worker_count)
+        return;
+
+    StopSightWorkers();
+
+    thread_atomic_int_store(&sight_workers_exit, 0);
+
+    for (int i = 0; i < count; i++)
+    {
+        SightWorker *worker = new SightWorker;
+        thread_signal_init(&worker->start);
+        worker->thread   = thread_create(SightWorkerProc, worker, THREAD_STACK_SIZE_DEFAULT);
+        sight_workers[i] = worker;
+    }
+
+    sight_worker_count = count;
+}
+
+static void AddSightJob(MapObject *src, MapObject *dest)
+{
+    if (!dest || dest == src || dest->IsRemoved() || AlmostEquals(dest->visibility_, 0.0f))
+        return;
+
+    SightPrepassEntry entry;
+
+    entry.source             = src;
+    entry.destination        = dest;
+    entry.source_info        = src->info_;
+    entry.source_x           = src->x;
+    entry.source_y           = src->y;
+    entry.source_z           = src->z;
+    entry.source_height      = src->height_;
+    entry.destination_x      = dest->x;
+    entry.destination_y      = dest->y;
+    entry.destination_z      = dest->z;
+    entry.destination_height = dest->height_;
+    entry.generation         = sight_geometry_generation;
+    entry.result             = kSightNeedsHitscan;
+
+    sight_prepass.push_back(entry);
+}
+
+// the field of view test LookForPlayers makes before tracing
+static bool InSightAngle(const MapObject *src, const MapObject *dest)
+{
+    BAMAngle range = src->info_->sight_angle_;
+
+    if (range >= kBAMAngle180)
         return true;
-    else
+
+    BAMAngle an = PointToAngle(src->x, src->y, dest->x, dest->y) - src->angle_;
+
+    if (range <= an && an <= (range * -1))
+    {
+        // behind its back, but real close
+        return ApproximateDistance(dest->x - src->x, dest->y - src->y) <= kMeleeRange;
+    }
+
+    return true;
+}
+
+void BeginSightPrepass(bool time_stop)
+{
+    sight_prepass_active = false;
+
+    if (thinker_sight_threads.d_ <= 0)
+    {
+        StopSightWorkers();
+        return;
+    }
+
+    EDGE_ZoneScoped;
+
+    StartSightWorkers(thinker_sight_threads.d_);
+
+    sight_prepass.clear();
+    sight_prepass_lookers.clear();
+
+    // only players think while time is stopped
+    if (time_stop)
+        return;
+
+    // gather: the same candidates LookForPlayers and the chase code use,
+    // from monsters whose state changes this tic (so an action runs)
+    for (MapObject *mo = map_object_list_head; mo != nullptr; mo = mo->next_)
     {
-        // Leveraging the existing hitscan attack code is easier than trying to
-        // wrangle this stuff
-        float objslope;
-        AimLineAttack(src, sight_check.angle, 64000, &objslope);
-        LineAttack(src, sight_check.angle, 64000, objslope, 0, nullptr, nullptr, nullptr);
-        bool slope_sight_good = dest->slope_sight_hit_;
-        if (slope_sight_good)
+        if (mo->IsRemoved() || mo->player_ || !mo->subsector_)
+            continue;
+
+        if (!(mo->extended_flags_ & kExtendedFlagMonster) && !(mo->flags_ & kMapObjectFlagCountKill))
+            continue;
+
+        if (!MapObjectActsThisTic(mo))
+            continue;
+
+        int first = (int)sight_prepass.size();
+
+        if (mo->target_)
+            AddSightJob(mo, mo->target_);
+        else
         {
-            dest->slope_sight_hit_ = false; // reset for future sight checks
-            return true;
+            for (int pnum = 0; pnum < kMaximumPlayers; pnum++)
+            {
+                if (players[pnum] && players[pnum]->map_object_ && players[pnum]->health_ > 0 &&
+                    InSightAngle(mo, players[pnum]->map_object_))
+                    AddSightJob(mo, players[pnum]->map_object_);
+            }
         }
-        else
-            return false;
+
+        if (mo->support_object_ && mo->support_object_ != mo->target_)
+            AddSightJob(mo, mo->support_object_);
+
+        if ((int)sight_prepass.size() > first)
+            sight_prepass_lookers[mo] = first;
+    }
+
+    if (sight_prepass.empty())
+        return;
+
+    // trace: the workers and this thread take jobs until none are left
+    thread_atomic_int_store(&sight_next_job, 0);
+    thread_atomic_int_store(&sight_busy_workers, sight_worker_count);
+
+    for (int i = 0; i < sight_worker_count; i++)
+        thread_signal_raise(&sight_workers[i]->start);
+
+    RunSightJobs(game_sight_query);
+
+    while (thread_atomic_int_load(&sight_busy_workers) > 0)
+        thread_yield();
+
+    sight_prepass_active = true;
+}
+
+void FinishSightPrepass(void)
+{
+    sight_prepass_active = false;
+}
+
+void ShutdownSightPrepass(void)
+{
+    FinishSightPrepass();
+    StopSightWorkers();
+
+    sight_prepass.clear();
+    sight_prepass_lookers.clear();
+}
+
+static SightResult LookupSightPrepass(MapObject *src, MapObject *dest)
+{
+    auto find = sight_prepass_lookers.find(src);
+    if (find == sight_prepass_lookers.end())
+        return kSightNeedsHitscan;
+
+    for (int i = find->second; i < (int)sight_prepass.size() && sight_prepass[i].source == src; i++)
+    {
+        const SightPrepassEntry &entry = sight_prepass[i];
+
+        if (entry.destination != dest)
+            continue;
+
+        // exact compares: a near miss could trace differently
+        if (entry.generation != sight_geometry_generation || entry.source_info != src->info_ ||
+            entry.source_x != src->x || entry.source_y != src->y || entry.source_z != src->z ||
+            entry.source_height != src->height_ || entry.destination_x != dest->x || entry.destination_y != dest->y ||
+            entry.destination_z != dest->z || entry.destination_height != dest->height_)
+            return kSightNeedsHitscan;
+
+        return entry.result;
     }
+
+    return kSightNeedsHitscan;
+}
+
+bool CheckSight(MapObject *src, MapObject *dest)
+{
+    if (!dest)
+        return false;
+
+    // -ACB- 1998/07/20 t2 is Invisible, t1 cannot possibly see it.
+    if (AlmostEquals(dest->visibility_, 0.0f))
+        return false;
+
+    SightResult result = kSightNeedsHitscan;
+
+    if (sight_prepass_active)
+        result = LookupSightPrepass(src, dest);
+
+    if (result == kSightNeedsHitscan)
+        result = TraceSight(game_sight_query, src, dest);
+
+    if (result != kSightNeedsHitscan)
+        return result == kSightClear;
+
+    // Leveraging the existing hitscan attack code is easier than trying to
+    // wrangle this stuff
+    BAMAngle angle = PointToAngle(src->x, src->y, dest->x, dest->y);
+    float    objslope;
+    AimLineAttack(src, angle, 64000, &objslope);
+    LineAttack(src, angle, 64000, objslope, 0, nullptr, nullptr, nullptr);
+    bool slope_sight_good = dest->slope_sight_hit_;
+    if (slope_sight_good)
+    {
+        dest->slope_sight_hit_ = false; // reset for future sight checks
+        return true;
+    }
+    else
+        return false;
 }
 
 bool CheckSightToPoint(MapObject *src, float x, float y, float z)
 {
+    SightQuery  &query       = game_sight_query;
+    LineOfSight &sight_check = query.sight_check;
+
     Subsector *dest_sub = PointInSubsector(x, y);
 
     if (dest_sub == src->subsector_)
         return true;
 
-    valid_count++;
+    BeginLineChecks(query);
 
     sight_check.source.x         = src->x;
     sight_check.source.y         = src->y;
@@ -553,9 +917,9 @@ bool CheckSightToPoint(MapObject *src, float x, float y, float z)
     sight_check.bounding_box[kBoundingBoxBottom] = HMM_MIN(sight_check.source.y, sight_check.destination.Y);
     sight_check.bounding_box[kBoundingBoxTop]    = HMM_MAX(sight_check.source.y, sight_check.destination.Y);
 
-    wall_intercepts.clear();
+    query.wall_intercepts.clear();
 
-    if (!CheckSightBSP(root_node))
+    if (!CheckSightBSP(query, root_node))
         return false;
 
     // #if 1
@@ -31,6 +31,8 @@
 
 #include <limits.h>
 
+#include <unordered_map>
+
 #include "AlmostEquals.h"
 #include "con_main.h"
 #include "dm_defs.h"
@@ -240,6 +242,78 @@ float FindRaiseToTexture(Sector *sec)
     return sec->floor_height + minsize;
 }
 
+//
+// Tag index: every sector and line of the level grouped by tag into one
+// contiguous run per tag (in level order), with a hash from the tag to
+// its run.  Tags are fixed once the level is loaded, so it is built once
+// by CreateTagIndex() and the sector tag_next/tag_previous chains are
+// linked from it.
+//
+struct TagSpan
+{
+    int first = 0;
+    int count = 0;
+};
+
+static std::vector<Sector *>            sector_tag_list;
+static std::vector<Line *>              line_tag_list;
+static std::unordered_map<int, TagSpan> sector_tag_spans;
+static std::unordered_map<int, TagSpan> line_tag_spans;
+
+template <typename T>
+static void BuildTagSpans(T *items, int total, std::vector<T *> &list, std::unordered_map<int, TagSpan> &spans)
+{
+    spans.clear();
+
+    for (int i = 0; i < total; i++)
+        spans[items[i].tag].count++;
+
+    int pos = 0;
+
+    for (auto &iter : spans)
+    {
+        iter.second.first = pos;
+        pos += iter.second.count;
+        iter.second.count = 0;
+    }
+
+    list.resize(total);
+
+    for (int i = 0; i < total; i++)
+    {
+        TagSpan &span = spans[items[i].tag];
+
+        list[span.first + span.count] = items + i;
+        span.count++;
+    }
+}
+
+void CreateTagIndex(void)
+{
+    BuildTagSpans(level_sectors, total_level_sectors, sector_tag_list, sector_tag_spans);
+    BuildTagSpans(level_lines, total_level_lines, line_tag_list, line_tag_spans);
+
+    // -AJA- 1999/07/29: Keep sectors with same tag in a list.
+    for (auto &iter : sector_tag_spans)
+    {
+        Sector **run = &sector_tag_list[iter.second.first];
+
+        for (int i = 0; i < iter.second.count; i++)
+        {
+            run[i]->tag_previous = (i > 0) ? run[i - 1] : nullptr;
+            run[i]->tag_next     = (i + 1 < iter.second.count) ? run[i + 1] : nullptr;
+        }
+    }
+}
+
+void DestroyTagIndex(void)
+{
+    sector_tag_list.clear();
+    line_tag_list.clear();
+    sector_tag_spans.clear();
+    line_tag_spans.clear();
+}
+
 //
 // Returns the FIRST sector that tag refers to.
 //
@@ -248,15 +322,27 @@ float FindRaiseToTexture(Sector *sec)
 //
 Sector *FindSectorFromTag(int tag)
 {
-    int i;
+    auto iter = sector_tag_spans.find(tag);
+
+    if (iter == sector_tag_spans.end())
+        return nullptr;
+
+    return sector_tag_list[iter->second.first];
+}
+
+TaggedLines FindLinesFromTag(int tag)
+{
+    TaggedLines lines = {nullptr, 0};
+
+    auto iter = line_tag_spans.find(tag);
 
-    for (i = 0; i < total_level_sectors; i++)
+    if (iter != line_tag_spans.end())
     {
-        if (level_sectors[i].tag == tag)
-            return level_sectors + i;
+        lines.first = &line_tag_list[iter->second.first];
+        lines.count = iter->second.count;
     }
 
-    return nullptr;
+    return lines;
 }
 
 //
@@ -603,13 +689,10 @@ static void P_LineEffect(Line *target, Line *source, const LineType *special)
                 anim.scroll_line_reference    = source;
                 anim.side_0_x_offset_speed    = -source->side[0]->middle.offset.X / 8.0;
                 anim.side_0_y_offset_speed    = source->side[0]->middle.offset.Y / 8.0;
-                for (int i = 0; i < total_level_lines; i++)
+                for (Line *ld : FindLinesFromTag(source->side[0]->sector->tag))
                 {
-                    if (level_lines[i].tag == source->side[0]->sector->tag)
-                    {
-                        if (!level_lines[i].special || level_lines[i].special->count_ == 1)
-                            anim.permanent = true;
-                    }
+                    if (!ld->special || ld->special->count_ == 1)
+                        anim.permanent = true;
                 }
                 anim.last_height = anim.scroll_sector_reference->original_height;
             }
@@ -670,13 +753,10 @@ static void P_LineEffect(Line *target, Line *source, const LineType *special)
                     anim.scroll_line_reference    = source;
                     anim.dynamic_delta_x += x;
                     anim.dynamic_delta_y += y;
-                    for (int i = 0; i < total_level_lines; i++)
+                    for (Line *ld : FindLinesFromTag(source->side[0]->sector->tag))
                     {
-                        if (level_lines[i].tag == source->side[0]->sector->tag)
-                        {
-                            if (!level_lines[i].special || level_lines[i].special->count_ == 1)
-                                anim.permanent = true;
-                        }
+                        if (!ld->special || ld->special->count_ == 1)
+                            anim.permanent = true;
                     }
                     anim.last_height = anim.scroll_sector_reference->original_height;
                 }
@@ -815,13 +895,10 @@ static void SectorEffect(Sector *target, Line *source, const LineType *special)
                 anim.scroll_sector_reference  = source->side[0]->sector;
                 anim.scroll_special_reference = special;
                 anim.scroll_line_reference    = source;
-                for (int i = 0; i < total_level_lines; i++)
+                for (Line *ld : FindLinesFromTag(source->side[0]->sector->tag))
                 {
-                    if (level_lines[i].tag == source->side[0]->sector->tag)
-                    {
-                        if (!level_lines[i].special || level_lines[i].special->count_ == 1)
-                            anim.permanent = true;
-                    }
+                    if (!ld->special || ld->special->count_ == 1)
+                        anim.permanent = true;
                 }
                 anim.last_height = anim.scroll_sector_reference->original_height;
             }
@@ -1111,7 +1188,8 @@ static bool P_ActivateSpecialLine(Line *line, const LineType *special, int tag,
     SoundEffect *sfx[4];
     Sector      *tsec;
 
-    int i;
+    // line effects can change what blocks sight
+    SightGeometryChanged();
 
 #ifdef DEVELOPERS
     if (!special)
@@ -1280,13 +1358,8 @@ static bool P_ActivateSpecialLine(Line *line, const LineType *special, int tag,
         }
         else
         {
-            for (i = 0; i < total_level_lines; i++)
-            {
-                if (level_lines[i].tag == tag)
-                {
-                    P_SpawnLineEffectDebris(level_lines + i, special);
-                }
-            }
+            for (Line *ld : FindLinesFromTag(tag))
+                P_SpawnLineEffectDebris(ld, special);
         }
     }
 
@@ -1392,11 +1465,9 @@ static bool P_ActivateSpecialLine(Line *line, const LineType *special, int tag,
         }
         else if (tag)
         {
-            for (i = 0; i < total_level_lines; i++)
+            for (Line *other : FindLinesFromTag(tag))
             {
-                Line *other = level_lines + i;
-
-                if (other->tag == tag && other != line)
+                if (other != line)
                     if (RunSlidingDoor(other, line, thing, special))
                         texSwitch = true;
             }
@@ -1466,11 +1537,11 @@ static bool P_ActivateSpecialLine(Line *line, const LineType *special, int tag,
         }
         else
         {
-            for (i = 0; i < total_level_lines; i++)
+            for (Line *ld : FindLinesFromTag(tag))
             {
-                if (level_lines[i].tag == tag && &level_lines[i] != line)
+                if (ld != line)
                 {
-                    P_LineEffect(level_lines + i, line, special);
+                    P_LineEffect(ld, line, special);
                     texSwitch = true;
                 }
             }
@@ -154,6 +154,22 @@ struct Force
     Sector *sector;     // the affected sector
 };
 
+// All the lines sharing one tag, in level order.
+struct TaggedLines
+{
+    Line *const *first;
+    int          count;
+
+    Line *const *begin() const
+    {
+        return first;
+    }
+    Line *const *end() const
+    {
+        return first + count;
+    }
+};
+
 // End-level timer (-TIMER option)
 extern bool level_timer;
 extern int  level_time_count;
@@ -161,6 +177,8 @@ extern int  level_time_count;
 extern LineType donut[2];
 
 // at map load
+void CreateTagIndex(void);
+void DestroyTagIndex(void);
 void SpawnMapSpecials1(void);
 void SpawnMapSpecials2(int autotag);
 
@@ -181,10 +199,11 @@ Sector *GetLineSector(int currentSector, int line, int side);
 Sector *GetLineSectorAdjacent(const Line *line, const Sector *sec, bool ignore_selfref = false);
 
 // Info Needs....
-float   FindSurroundingHeight(const TriggerHeightReference ref, const Sector *sec);
-float   FindRaiseToTexture(Sector *sec); // -KM- 1998/09/01 New func, old inline
-Sector *FindSectorFromTag(int tag);
-int     FindMinimumSurroundingLight(Sector *sector, int max);
+float       FindSurroundingHeight(const TriggerHeightReference ref, const Sector *sec);
+float       FindRaiseToTexture(Sector *sec); // -KM- 1998/09/01 New func, old inline
+Sector     *FindSectorFromTag(int tag);
+TaggedLines FindLinesFromTag(int tag);
+int         FindMinimumSurroundingLight(Sector *sector, int max);
 
 // start an action...
 bool RunSectorLight(Sector *sec, const LightSpecialDefinition *type);
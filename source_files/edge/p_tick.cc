@@ -33,6 +33,7 @@
 
 #include "AlmostEquals.h"
 #include "dm_state.h"
+#include "edge_profiling.h"
 #include "g_game.h"
 #include "n_network.h"
 #include "p_local.h"
@@ -52,6 +53,8 @@ extern ConsoleVariable erraticism;
 //
 void MapObjectTicker()
 {
+    EDGE_ProfileZone("MapObjectTicker");
+
     if (paused || console_active)
         return;
 
@@ -1,14 +1,31 @@
 #include "example_class.h"
 #include <con_main.h>
+#include <i_sound.h>
+
+#include <vector>
 
 void GDD_Init(int argc, char *argv[]);
 void GDD_Tick();
+void GDD_StartSimulationThread();
+void GDD_StopSimulationThread();
+void GDD_QueueKey(int sym, bool down);
+void GDD_QueueMouseMotion(int dx, int dy);
+int GDD_GetAudioMixRate();
+uint32_t GDD_ReadAudio(float *interleaved, uint32_t frames);
+void GDD_GetAudioStats(SoundOutputStats &stats);
 
 void ExampleClass::_bind_methods()
 {
     godot::ClassDB::bind_method(D_METHOD("print_type", "variant"), &ExampleClass::print_type);
     godot::ClassDB::bind_method(D_METHOD("init"), &ExampleClass::init);
     godot::ClassDB::bind_method(D_METHOD("tick"), &ExampleClass::tick);
+    godot::ClassDB::bind_method(D_METHOD("start_simulation_thread"), &ExampleClass::start_simulation_thread);
+    godot::ClassDB::bind_method(D_METHOD("stop_simulation_thread"), &ExampleClass::stop_simulation_thread);
+    godot::ClassDB::bind_method(D_METHOD("queue_key", "sym", "down"), &ExampleClass::queue_key);
+    godot::ClassDB::bind_method(D_METHOD("queue_mouse_motion", "dx", "dy"), &ExampleClass::queue_mouse_motion);
+    godot::ClassDB::bind_method(D_METHOD("get_audio_mix_rate"), &ExampleClass::get_audio_mix_rate);
+    godot::ClassDB::bind_method(D_METHOD("read_audio", "frames"), &ExampleClass::read_audio);
+    godot::ClassDB::bind_method(D_METHOD("get_audio_stats"), &ExampleClass::get_audio_stats);
 }
 
 void ExampleClass::print_type(const Variant &p_variant) const
@@ -27,3 +44,60 @@ void ExampleClass::tick() const
 {
     GDD_Tick();
 }
+
+void ExampleClass::start_simulation_thread() const
+{
+    GDD_StartSimulationThread();
+}
+
+void ExampleClass::stop_simulation_thread() const
+{
+    GDD_StopSimulationThread();
+}
+
+void ExampleClass::queue_key(int sym, bool down) const
+{
+    GDD_QueueKey(sym, down);
+}
+
+void ExampleClass::queue_mouse_motion(int dx, int dy) const
+{
+    GDD_QueueMouseMotion(dx, dy);
+}
+
+int ExampleClass::get_audio_mix_rate() const
+{
+    return GDD_GetAudioMixRate();
+}
+
+// frames for AudioStreamGeneratorPlayback.push_buffer()
+PackedVector2Array ExampleClass::read_audio(int frames) const
+{
+    PackedVector2Array result;
+
+    if (frames <= 0)
+        return result;
+
+    std::vector<float> samples(frames * 2);
+    GDD_ReadAudio(samples.data(), frames);
+
+    result.resize(frames);
+    for (int i = 0; i < frames; i++)
+        result.set(i, Vector2(samples[i * 2], samples[i * 2 + 1]));
+
+    return result;
+}
+
+Dictionary ExampleClass::get_audio_stats() const
+{
+    SoundOutputStats stats;
+    GDD_GetAudioStats(stats);
+
+    Dictionary result;
+    result["buffer_frames"]   = stats.buffer_frames;
+    result["queued_frames"]   = stats.queued_frames;
+    result["underruns"]       = stats.underruns;
+    result["underrun_frames"] = stats.underrun_frames;
+    result["dropped_frames"]  = stats.dropped_frames;
+    return result;
+}
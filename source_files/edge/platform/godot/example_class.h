@@ -2,6 +2,8 @@
 
 #include "godot_cpp/classes/ref_counted.hpp"
 #include "godot_cpp/classes/wrapped.hpp"
+#include "godot_cpp/variant/dictionary.hpp"
+#include "godot_cpp/variant/packed_vector2_array.hpp"
 #include "godot_cpp/variant/variant.hpp"
 
 using namespace godot;
@@ -20,4 +22,11 @@ public:
 
 	void init() const;
 	void tick() const;
+	void start_simulation_thread() const;
+	void stop_simulation_thread() const;
+	void queue_key(int sym, bool down) const;
+	void queue_mouse_motion(int dx, int dy) const;
+	int get_audio_mix_rate() const;
+	PackedVector2Array read_audio(int frames) const;
+	Dictionary get_audio_stats() const;
 };
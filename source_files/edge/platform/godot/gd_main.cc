@@ -1,13 +1,19 @@
+#include "HandmadeMath.h"
+#include "ddf_main.h"
 #include "dm_defs.h"
+#include "e_input.h"
 #include "e_main.h"
 #include "epi_filesystem.h"
 #include "epi_str_util.h"
+#include "i_sound.h"
 #include "i_system.h"
 #include "i_video.h"
 #include "m_argv.h"
 #include "m_menu.h"
+#include "n_network.h"
 #include "platform/gd_platform.h"
 #include "r_modes.h"
+#include "thread.h"
 #include "version.h"
 
 #ifdef WIN32
@@ -24,11 +30,221 @@
 using namespace godot;
 
 extern std::string executable_path;
+extern int         sound_device_frequency;
+
+//
+// Optional simulation thread: the game runs its tics at kTicRate on its
+// own thread, while the Godot frame (GDD_Tick) only presents.  The two
+// take turns owning the level via simulation_owner: the renderer walks
+// the live thing lists and sectors, which a tic rewrites, so a frame
+// cannot be drawn while a tic is running.
+//
+// A tic which falls due while a frame is being drawn sleeps on
+// simulation_presented until it is done.  A present which finds a tic
+// running sleeps on simulation_ticked for a few milliseconds, which
+// covers an ordinary tic, and only skips drawing (leaving the last frame
+// on screen) when the tic takes longer than that.
+//
+// The renderer interpolates from the tic clock the last tic ran for,
+// as the SDL loop does, not from when the thread got round to running
+// it, so a tic held up by a present does not make the motion jitter.
+//
+enum SimulationOwner
+{
+    kSimulationOwnerNone = 0,
+    kSimulationOwnerTicker,
+    kSimulationOwnerPresent
+};
+
+// longest a present waits for a tic to finish (ms)
+static constexpr int kSimulationPresentWait = 4;
+
+static thread_ptr_t        simulation_thread = nullptr;
+static thread_atomic_int_t simulation_owner;
+static thread_atomic_int_t simulation_quit;
+static thread_atomic_int_t simulation_last_tic; // GetTime() the last tic ran for
+static thread_atomic_int_t simulation_skipped_frames;
+static thread_signal_t     simulation_presented;
+static thread_signal_t     simulation_ticked;
+
+static int SimulationThreadProc(void *data)
+{
+    EPI_UNUSED(data);
+
+    int last_time = GetTime();
+
+    while (!thread_atomic_int_load(&simulation_quit))
+    {
+        // wait for the next tic outside the lock, so presenting is never
+        // held up by the pacing
+        int now_time = GetTime();
+
+        if (now_time == last_time)
+        {
+            SleepForMilliseconds(1);
+            continue;
+        }
+
+        last_time = now_time;
+
+        while (thread_atomic_int_compare_and_swap(&simulation_owner, kSimulationOwnerNone, kSimulationOwnerTicker) !=
+               kSimulationOwnerNone)
+        {
+            if (thread_atomic_int_load(&simulation_quit))
+                return 0;
+
+            // woken when the frame is done, the timeout only rechecks quit
+            thread_signal_wait(&simulation_presented, 1000 / kTicRate);
+        }
+
+        if (app_state & kApplicationActive)
+            EdgeSimulate();
+
+        thread_atomic_int_store(&simulation_last_tic, now_time);
+        thread_atomic_int_store(&simulation_owner, kSimulationOwnerNone);
+
+        thread_signal_raise(&simulation_ticked);
+    }
+
+    return 0;
+}
+
+void GDD_StartSimulationThread()
+{
+    if (simulation_thread)
+        return;
+
+    thread_atomic_int_store(&simulation_owner, kSimulationOwnerNone);
+    thread_atomic_int_store(&simulation_quit, 0);
+    thread_atomic_int_store(&simulation_last_tic, GetTime());
+    thread_atomic_int_store(&simulation_skipped_frames, 0);
+
+    thread_signal_init(&simulation_presented);
+    thread_signal_init(&simulation_ticked);
+
+    simulation_thread = thread_create(SimulationThreadProc, nullptr, THREAD_STACK_SIZE_DEFAULT);
+
+    if (!simulation_thread)
+    {
+        LogWarning("GDD: unable to start the simulation thread\n");
+
+        thread_signal_term(&simulation_presented);
+        thread_signal_term(&simulation_ticked);
+    }
+}
+
+void GDD_StopSimulationThread()
+{
+    if (!simulation_thread)
+        return;
+
+    thread_atomic_int_store(&simulation_quit, 1);
+    thread_signal_raise(&simulation_presented);
+    thread_join(simulation_thread);
+    thread_destroy(simulation_thread);
+
+    thread_signal_term(&simulation_presented);
+    thread_signal_term(&simulation_ticked);
+
+    simulation_thread = nullptr;
+
+    LogDebug("GDD: %d frames skipped while a tic was running\n", thread_atomic_int_load(&simulation_skipped_frames));
+}
+
+static bool TakeLevelForPresent(void)
+{
+    if (thread_atomic_int_compare_and_swap(&simulation_owner, kSimulationOwnerNone, kSimulationOwnerPresent) ==
+        kSimulationOwnerNone)
+        return true;
+
+    // a tic is running, give it a moment to finish
+    int give_up = GetMilliseconds() + kSimulationPresentWait;
+
+    for (int left = kSimulationPresentWait; left > 0; left = give_up - GetMilliseconds())
+    {
+        thread_signal_wait(&simulation_ticked, left);
+
+        if (thread_atomic_int_compare_and_swap(&simulation_owner, kSimulationOwnerNone, kSimulationOwnerPresent) ==
+            kSimulationOwnerNone)
+            return true;
+    }
+
+    return false;
+}
 
 void GDD_Tick()
 {
-    if (app_state & kApplicationActive)
-        EdgeTicker();
+    if (!simulation_thread)
+    {
+        if (app_state & kApplicationActive)
+            EdgeTicker();
+    }
+    else if (TakeLevelForPresent())
+    {
+        // how far into the tic after the last one run we are, as the
+        // SDL loop works it out, clamped while a tic is still to run
+        int64_t last_tic = thread_atomic_int_load(&simulation_last_tic);
+        int64_t ahead    = (int64_t)GetMilliseconds() * kTicRate - last_tic * 1000;
+
+        fractional_tic = HMM_Clamp(0.0f, (float)ahead / 1000.0f, 1.0f);
+
+        if (app_state & kApplicationActive)
+            EdgePresent();
+
+        thread_atomic_int_store(&simulation_owner, kSimulationOwnerNone);
+
+        thread_signal_raise(&simulation_presented);
+    }
+    else
+    {
+        // the tic outlasted the wait, keep showing the last frame
+        thread_atomic_int_inc(&simulation_skipped_frames);
+    }
+
+    // top up the audio ring (EdgeTicker does it otherwise); miniaudio lets
+    // this mix while the simulation thread starts and stops sounds
+    if (simulation_thread)
+        PumpSoundOutput();
+}
+
+// audio for the host's stream; the reader may be Godot's audio thread
+int GDD_GetAudioMixRate()
+{
+    return sound_device_frequency;
+}
+
+uint32_t GDD_ReadAudio(float *interleaved, uint32_t frames)
+{
+    return ReadSoundOutput(interleaved, frames);
+}
+
+void GDD_GetAudioStats(SoundOutputStats &stats)
+{
+    GetSoundOutputStats(stats);
+}
+
+// input from the host; may be called from any one thread
+void GDD_QueueKey(int sym, bool down)
+{
+    InputEvent ev;
+
+    ev.type          = down ? kInputEventKeyDown : kInputEventKeyUp;
+    ev.modstate      = kInputEventModNone;
+    ev.value.key.sym = sym;
+
+    QueueInputEvent(&ev, GetMilliseconds());
+}
+
+void GDD_QueueMouseMotion(int dx, int dy)
+{
+    InputEvent ev;
+
+    ev.type           = kInputEventKeyMouse;
+    ev.modstate       = kInputEventModNone;
+    ev.value.mouse.dx = dx;
+    ev.value.mouse.dy = dy;
+
+    QueueInputEvent(&ev, GetMilliseconds());
 }
 
 static std::string u32_to_string(const std::u32string &u32str)
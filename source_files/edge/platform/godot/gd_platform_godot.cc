@@ -3,7 +3,9 @@
 #include <epi_str_compare.h>
 #include <epi_str_util.h>
 
+#include <chrono>
 #include <godot_cpp/core/print_string.hpp>
+#include <thread>
 
 #include "../../con_main.h"
 #include "../../dm_state.h"
@@ -36,12 +38,14 @@ namespace gd
 {
 class GodotPlatform : public Platform
 {
-    uint32_t ticks_ = 0;
+    std::chrono::steady_clock::time_point start_time_ = std::chrono::steady_clock::now();
 
   protected:
     uint32_t GetTicksInternal() override
     {
-        return ticks_++;
+        return (uint32_t)std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() -
+                                                                               start_time_)
+            .count();
     }
 
     std::string GetBasePathInternal(void) override
@@ -70,8 +74,7 @@ class GodotPlatform : public Platform
 
     void DelayInternal(uint32_t milliseconds) override
     {
-        EPI_UNUSED(milliseconds);
-        // SDL_Delay(milliseconds);
+        std::this_thread::sleep_for(std::chrono::milliseconds(milliseconds));
     }
 
     // Input
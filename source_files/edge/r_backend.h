@@ -12,6 +12,9 @@ struct PassInfo
 };
 constexpr int32_t kRenderWorldMax = 8;
 
+// offscreen targets for extra world views, see HUDRenderWorld
+constexpr int32_t kRenderWorldTargetMax = 8;
+
 enum RenderLayer
 {
     kRenderLayerHUD = 0,
@@ -76,6 +79,17 @@ class RenderBackend
 
     virtual void FinishWorldRender() = 0;
 
+    // Redirects the world render between BeginWorldRender/FinishWorldRender
+    // into an offscreen target of the given size.  Returns false if the
+    // backend can't do that right now; the view is then drawn to screen.
+    virtual bool BeginWorldTarget(int32_t target, int32_t width, int32_t height) = 0;
+
+    virtual void FinishWorldTarget() = 0;
+
+    // Texture holding the last render to the target, or 0.  Sets upside_down
+    // when its rows run top to bottom.
+    virtual uint32_t GetWorldTargetTexture(int32_t target, bool &upside_down) = 0;
+
     virtual void SetRenderLayer(RenderLayer layer, bool clear_depth = false) = 0;
 
     virtual RenderLayer GetRenderLayer() = 0;
@@ -0,0 +1,404 @@
+//----------------------------------------------------------------------------
+//  EDGE Headless Render Benchmark
+//----------------------------------------------------------------------------
+//
+//  Copyright (c) 2024 The EDGE Team.
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//----------------------------------------------------------------------------
+//
+//  Measures the CPU side of the renderer (BSP walk, subsector and unit
+//  generation) by rendering a fixed set of views.  Meant to be run on the
+//  null platform, whose backend draws nothing but counts what it is given:
+//
+//    edge-classic -windowed -width 1280 -height 720 -warp MAP01 -benchmark
+//                 [-benchmark_step 8] [-benchmark_path views.txt]
+//                 [-benchmark_out out.json]
+//
+//  The null platform has no display modes to pick from, so the screen
+//  size has to be given or every view comes out zero pixels wide.
+//
+//  Without a path file the camera visits the centroid of every Nth
+//  subsector and looks along the four axes from each.  A path file has
+//  one view per line: "x y z angle [pitch]" with z the eye height and the
+//  angles in degrees; '#' starts a comment.
+//
+//  Every view is rendered once to warm the image caches and then once
+//  more for the numbers, which are written as JSON.
+//
+//----------------------------------------------------------------------------
+
+#include "r_benchmark.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include <vector>
+
+#include "dm_state.h"
+#include "e_main.h"
+#include "e_player.h"
+#include "e_profile.h"
+#include "edge_profiling.h"
+#include "epi.h"
+#include "epi_file.h"
+#include "epi_filesystem.h"
+#include "epi_str_util.h"
+#include "g_game.h"
+#include "hu_draw.h"
+#include "i_system.h"
+#include "m_argv.h"
+#include "p_local.h"
+#include "r_backend.h"
+#include "r_modes.h"
+#include "r_state.h"
+#include "r_units.h"
+#include "version.h"
+
+RenderUnitShapeStats render_unit_shape_stats;
+
+static constexpr int kDefaultBenchmarkStep = 8;
+
+static const char *render_unit_shape_names[kTotalRenderUnitShapes] = {"quads", "triangles", "polygon", "quad_strip",
+                                                                      "lines"};
+
+struct BenchmarkView
+{
+    float x, y, z;
+    float angle;
+    float pitch;
+};
+
+struct BenchmarkSample
+{
+    float milliseconds;
+
+    ECFrameStats         frame;
+    FrameStats           backend;
+    RenderUnitShapeStats shapes;
+};
+
+// -1 until the command line has been checked
+static int benchmark_pending = -1;
+
+static std::string benchmark_path;
+static std::string benchmark_output;
+static int         benchmark_step = kDefaultBenchmarkStep;
+
+static bool ReadBenchmarkPath(const std::string &filename, std::vector<BenchmarkView> &views)
+{
+    epi::File *file = epi::FileOpen(filename, epi::kFileAccessRead);
+
+    if (file == nullptr)
+    {
+        LogWarning("Benchmark: unable to open camera path %s\n", filename.c_str());
+        return false;
+    }
+
+    std::string text = file->ReadText();
+    delete file;
+
+    std::vector<std::string> lines = epi::SeparatedStringVector(text, '\n');
+
+    for (const std::string &line : lines)
+    {
+        BenchmarkView view;
+
+        view.pitch = 0;
+
+        if (line.empty() || line[0] == '#')
+            continue;
+
+        if (sscanf(line.c_str(), " %f %f %f %f %f", &view.x, &view.y, &view.z, &view.angle, &view.pitch) < 4)
+            continue;
+
+        views.push_back(view);
+    }
+
+    return true;
+}
+
+static void BenchmarkSubsectorViews(float eye_height, std::vector<BenchmarkView> &views)
+{
+    for (int i = 0; i < total_level_subsectors; i += benchmark_step)
+    {
+        const Subsector *sub = level_subsectors + i;
+
+        float x     = 0;
+        float y     = 0;
+        int   total = 0;
+
+        for (const Seg *seg = sub->segs; seg; seg = seg->subsector_next)
+        {
+            x += seg->vertex_1->X;
+            y += seg->vertex_1->Y;
+            total++;
+        }
+
+        if (total == 0)
+            continue;
+
+        for (int dir = 0; dir < 4; dir++)
+        {
+            BenchmarkView view;
+
+            view.x     = x / total;
+            view.y     = y / total;
+            view.z     = sub->sector->floor_height + eye_height;
+            view.angle = dir * 90.0f;
+            view.pitch = 0;
+
+            views.push_back(view);
+        }
+    }
+}
+
+static void BenchmarkRender(MapObject *camera, const BenchmarkView &view, BenchmarkSample *sample,
+                            std::vector<ProfileZoneSummary> *zones)
+{
+    ChangeThingPosition(camera, view.x, view.y, view.z - camera->player_->view_z_);
+
+    camera->angle_          = epi::BAMFromDegrees(view.angle);
+    camera->vertical_angle_ = epi::BAMFromDegrees(view.pitch);
+
+    // no interpolation from wherever the last view was
+    camera->old_x_               = camera->x;
+    camera->old_y_               = camera->y;
+    camera->old_z_               = camera->z;
+    camera->old_angle_           = camera->angle_;
+    camera->old_vertical_angle_  = camera->vertical_angle_;
+    camera->player_->old_view_z_ = camera->player_->view_z_;
+
+    StartFrame();
+
+    ec_frame_stats.Clear();
+    EPI_CLEAR_MEMORY(&render_unit_shape_stats, RenderUnitShapeStats, 1);
+
+    int64_t start = ProfileTime();
+
+    HUDFrameSetup();
+    HUDRenderWorld(0, 0, 320, 200, camera, 0);
+
+    int64_t end = ProfileTime();
+
+    if (sample)
+    {
+        sample->milliseconds = (float)(end - start) / 1000000.0f;
+        sample->frame        = ec_frame_stats;
+        sample->shapes       = render_unit_shape_stats;
+
+        render_backend->GetFrameStats(sample->backend);
+
+        ProfileGatherZones(start, end, *zones);
+    }
+
+    FinishFrame();
+}
+
+static void WriteBenchmarkResults(const std::vector<BenchmarkView> &views, const std::vector<BenchmarkSample> &samples,
+                                  const std::vector<ProfileZoneSummary> &zones)
+{
+    FILE *fp = epi::FileOpenRaw(benchmark_output, epi::kFileAccessWrite);
+
+    if (fp == nullptr)
+    {
+        LogWarning("Benchmark: unable to write %s\n", benchmark_output.c_str());
+        return;
+    }
+
+    double               total_ms = 0;
+    double               units = 0, walls = 0, planes = 0, things = 0, draws = 0, vertex_bytes = 0;
+    RenderUnitShapeStats shapes;
+
+    EPI_CLEAR_MEMORY(&shapes, RenderUnitShapeStats, 1);
+
+    for (const BenchmarkSample &sample : samples)
+    {
+        total_ms += sample.milliseconds;
+        units += sample.frame.draw_render_units;
+        walls += sample.frame.draw_wall_parts;
+        planes += sample.frame.draw_planes;
+        things += sample.frame.draw_things;
+        draws += sample.backend.num_draw_;
+        vertex_bytes += sample.backend.size_update_buffer_;
+
+        for (int s = 0; s < kTotalRenderUnitShapes; s++)
+        {
+            shapes.units[s] += sample.shapes.units[s];
+            shapes.vertices[s] += sample.shapes.vertices[s];
+        }
+    }
+
+    double count = HMM_MAX(1.0, (double)samples.size());
+
+    fprintf(fp, "{\n");
+    fprintf(fp, "  \"version\": \"%s\",\n", edge_version.s_.c_str());
+    fprintf(fp, "  \"map\": \"%s\",\n", current_map->name_.c_str());
+    fprintf(fp, "  \"views\": %d,\n", (int)samples.size());
+    fprintf(fp, "  \"total_ms\": %.3f,\n", total_ms);
+    fprintf(fp, "  \"average_ms\": %.4f,\n", total_ms / count);
+    fprintf(fp,
+            "  \"average\": {\"render_units\": %.2f, \"wall_parts\": %.2f, \"planes\": %.2f, \"things\": %.2f, "
+            "\"draw_commands\": %.2f, \"vertex_bytes\": %.1f},\n",
+            units / count, walls / count, planes / count, things / count, draws / count, vertex_bytes / count);
+
+    fprintf(fp, "  \"shapes\": {");
+    for (int s = 0; s < kTotalRenderUnitShapes; s++)
+    {
+        fprintf(fp, "%s\n    \"%s\": {\"units\": %u, \"vertices\": %u, \"vertices_per_unit\": %.2f}", s ? "," : "",
+                render_unit_shape_names[s], shapes.units[s], shapes.vertices[s],
+                shapes.units[s] ? (double)shapes.vertices[s] / shapes.units[s] : 0.0);
+    }
+    fprintf(fp, "\n  },\n");
+
+    // per view averages of every profile zone seen, whatever its depth
+    fprintf(fp, "  \"stages_ms\": {");
+    for (size_t i = 0; i < zones.size(); i++)
+    {
+        fprintf(fp, "%s\n    \"%s\": {\"ms\": %.4f, \"calls\": %.2f}", i ? "," : "", zones[i].name,
+                zones[i].milliseconds / count, zones[i].calls / count);
+    }
+    fprintf(fp, "\n  },\n");
+
+    fprintf(fp, "  \"samples\": [");
+    for (size_t i = 0; i < samples.size(); i++)
+    {
+        const BenchmarkView   &view   = views[i];
+        const BenchmarkSample &sample = samples[i];
+
+        fprintf(fp,
+                "%s\n    {\"x\": %.1f, \"y\": %.1f, \"z\": %.1f, \"angle\": %.1f, \"ms\": %.4f, \"render_units\": %d, "
+                "\"wall_parts\": %d, \"planes\": %d, \"things\": %d}",
+                i ? "," : "", view.x, view.y, view.z, view.angle, sample.milliseconds, sample.frame.draw_render_units,
+                sample.frame.draw_wall_parts, sample.frame.draw_planes, sample.frame.draw_things);
+    }
+    fprintf(fp, "\n  ]\n}\n");
+
+    fclose(fp);
+
+    LogPrint("Benchmark: %d views, %.3f ms average, %.1f units, %.1f walls, %.1f planes, %.1f things\n",
+             (int)samples.size(), total_ms / count, units / count, walls / count, planes / count, things / count);
+    LogPrint("Benchmark: results written to %s\n", benchmark_output.c_str());
+}
+
+static void RunRenderBenchmark(void)
+{
+    Player *player = players[console_player];
+
+    if (player == nullptr || player->map_object_ == nullptr)
+    {
+        LogWarning("Benchmark: no player to use as the camera\n");
+        return;
+    }
+
+    if (current_screen_width <= 0 || current_screen_height <= 0)
+    {
+        LogWarning("Benchmark: no screen size, use -windowed -width and -height\n");
+        return;
+    }
+
+    MapObject *camera = player->map_object_;
+
+    std::vector<BenchmarkView> views;
+
+    if (!benchmark_path.empty())
+        ReadBenchmarkPath(benchmark_path, views);
+    else
+        BenchmarkSubsectorViews(player->view_z_, views);
+
+    if (views.empty())
+    {
+        LogWarning("Benchmark: nothing to render\n");
+        return;
+    }
+
+    LogPrint("Benchmark: rendering %d views of %s\n", (int)views.size(), current_map->name_.c_str());
+
+    // zone timings come from the profiler, so make sure it is listening
+    bool was_recording = ec_profile_recording.load(std::memory_order_relaxed);
+    ec_profile_recording.store(true, std::memory_order_relaxed);
+
+    for (const BenchmarkView &view : views)
+        BenchmarkRender(camera, view, nullptr, nullptr);
+
+    std::vector<BenchmarkSample>    samples(views.size());
+    std::vector<ProfileZoneSummary> zones;
+
+    for (size_t i = 0; i < views.size(); i++)
+        BenchmarkRender(camera, views[i], &samples[i], &zones);
+
+    ec_profile_recording.store(was_recording, std::memory_order_relaxed);
+
+    // fold the zones of all threads and depths together by name
+    std::vector<ProfileZoneSummary> stages;
+
+    for (const ProfileZoneSummary &zone : zones)
+    {
+        bool found = false;
+
+        for (ProfileZoneSummary &stage : stages)
+        {
+            if (strcmp(stage.name, zone.name) == 0)
+            {
+                stage.milliseconds += zone.milliseconds;
+                stage.calls += zone.calls;
+                found = true;
+                break;
+            }
+        }
+
+        if (!found)
+            stages.push_back(zone);
+    }
+
+    WriteBenchmarkResults(views, samples, stages);
+}
+
+void RenderBenchmarkTicker(void)
+{
+    if (benchmark_pending < 0)
+    {
+        benchmark_pending = (FindArgument("benchmark") > 0) ? 1 : 0;
+
+        if (benchmark_pending == 0)
+            return;
+
+        if (FindArgument("warp") <= 0)
+        {
+            LogWarning("Benchmark: -benchmark needs a map given with -warp\n");
+            benchmark_pending = 0;
+            return;
+        }
+
+        benchmark_path = ArgumentValue("benchmark_path");
+
+        std::string s = ArgumentValue("benchmark_step");
+        if (!s.empty())
+            benchmark_step = HMM_MAX(1, atoi(s.c_str()));
+
+        benchmark_output = ArgumentValue("benchmark_out");
+        if (benchmark_output.empty())
+            benchmark_output = epi::PathAppend(home_directory, "benchmark.json");
+    }
+
+    if (benchmark_pending == 0 || game_state != kGameStateLevel)
+        return;
+
+    benchmark_pending = 0;
+
+    RunRenderBenchmark();
+
+    app_state |= kApplicationPendingQuit;
+}
+
+//--- editor settings ---
+// vi:ts=4:sw=4:noexpandtab
@@ -23,10 +23,12 @@
 //
 //----------------------------------------------------------------------------
 
+#include <float.h>
 #include <math.h>
 
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 #include "AlmostEquals.h"
 #include "dm_defs.h"
@@ -90,6 +92,7 @@ std::list<DrawSubsector *> draw_subsector_list;
 #endif
 
 EDGE_DEFINE_CONSOLE_VARIABLE(debug_hall_of_mirrors, "0", kConsoleVariableFlagCheat)
+EDGE_DEFINE_CONSOLE_VARIABLE(renderer_occlusion_spans, "1", kConsoleVariableFlagArchive)
 
 extern ConsoleVariable draw_culling;
 
@@ -119,11 +122,94 @@ ViewHeightZone view_height_zone;
 
 static Subsector *bsp_current_subsector;
 
+// Lowest and highest point anything below each side of every node can be
+// drawn at, for the vertical occlusion test.  Two per node, rebuilt on
+// the main thread whenever a sector height changes.
+struct NodeHeightRange
+{
+    float low;
+    float high;
+};
+
+static std::vector<NodeHeightRange> node_heights;
+static uint32_t                     node_heights_generation = 0;
+
+static inline bool SectorIsSloped(const Sector *sec)
+{
+    return sec->floor_slope || sec->ceiling_slope || sec->floor_vertex_slope || sec->ceiling_vertex_slope;
+}
+
+// An upper or lower wall part which nothing can be seen through.
+static inline bool SolidWallPart(const MapSurface &surf)
+{
+    return surf.image && surf.image->opacity_ == kOpacitySolid && surf.translucency >= 0.99f;
+}
+
+static void SubsectorHeightRange(const Subsector *sub, NodeHeightRange &range)
+{
+    const Sector *sec = sub->sector;
+
+    if (SectorIsSloped(sec))
+    {
+        range.low  = -FLT_MAX;
+        range.high = FLT_MAX;
+        return;
+    }
+
+    range.low  = sec->interpolated_floor_height;
+    range.high = sec->interpolated_ceiling_height;
+
+    const Sector *other = sec->height_sector ? sec->height_sector : sub->deep_water_reference;
+
+    if (other)
+    {
+        range.low  = HMM_MIN(range.low, other->interpolated_floor_height);
+        range.high = HMM_MAX(range.high, other->interpolated_ceiling_height);
+    }
+
+    // sky walls and planes reach up to the sky height
+    if (EDGE_IMAGE_IS_SKY(sec->ceiling) || (other && EDGE_IMAGE_IS_SKY(other->ceiling)))
+        range.high = HMM_MAX(range.high, sec->sky_height);
+}
+
+static void BuildNodeHeights(unsigned int bspnum, NodeHeightRange &range)
+{
+    if (bspnum & kLeafSubsector)
+    {
+        SubsectorHeightRange(&level_subsectors[bspnum & (~kLeafSubsector)], range);
+        return;
+    }
+
+    const BSPNode *node = &level_nodes[bspnum];
+
+    NodeHeightRange *sides = &node_heights[bspnum * 2];
+
+    BuildNodeHeights(node->children[0], sides[0]);
+    BuildNodeHeights(node->children[1], sides[1]);
+
+    range.low  = HMM_MIN(sides[0].low, sides[1].low);
+    range.high = HMM_MAX(sides[0].high, sides[1].high);
+}
+
+static void BSPUpdateNodeHeights(void)
+{
+    if (node_heights.size() == (size_t)total_level_nodes * 2 &&
+        node_heights_generation == SectorGeometryGeneration())
+        return;
+
+    node_heights.resize(total_level_nodes * 2);
+    node_heights_generation = SectorGeometryGeneration();
+
+    NodeHeightRange whole;
+    BuildNodeHeights(root_node, whole);
+}
+
 //
 // BSPWalkSeg
 //
 // Visit a single seg of the subsector, and for one-sided lines update
-// the 1D occlusion buffer.
+// the 1D occlusion buffer.  Two-sided lines narrow the vertical window
+// behind them instead.
 //
 static void BSPWalkSeg(DrawSubsector *dsub, Seg *seg)
 {
@@ -284,6 +370,30 @@ static void BSPWalkSeg(DrawSubsector *dsub, Seg *seg)
         }
     }
 
+    // Only opaque lower and upper parts count, and sky or missing textures
+    // leave that side open, since the flood tricks show what's behind.
+    if (bsector && bsector != fsector && !seg->linedef->blocked && renderer_occlusion_spans.d_ &&
+        !fsector->height_sector && !bsector->height_sector && !seg->front_subsector->deep_water_reference &&
+        !seg->back_subsector->deep_water_reference && !SectorIsSloped(fsector) && !SectorIsSloped(bsector))
+    {
+        float floor_h   = -FLT_MAX;
+        float ceiling_h = FLT_MAX;
+
+        if (!EDGE_IMAGE_IS_SKY(*f_floor) && !EDGE_IMAGE_IS_SKY(*b_floor) &&
+            (b_fh <= f_fh || SolidWallPart(seg->sidedef->bottom)))
+            floor_h = HMM_MAX(f_fh, b_fh);
+
+        if (!EDGE_IMAGE_IS_SKY(*f_ceil) && !EDGE_IMAGE_IS_SKY(*b_ceil) &&
+            (b_ch >= f_ch || SolidWallPart(seg->sidedef->top)))
+            ceiling_h = HMM_MIN(f_ch, b_ch);
+
+        // closed doors, lifts and the like
+        if (floor_h >= ceiling_h)
+            OcclusionSet(angle_R, angle_L);
+        else
+            OcclusionNarrow(angle_R, angle_L, sx1, sy1, sx2, sy2, floor_h, ceiling_h);
+    }
+
     if (bsector && EDGE_IMAGE_IS_SKY(*f_floor) && EDGE_IMAGE_IS_SKY(*b_floor) && seg->sidedef->bottom.image == nullptr)
     {
         if (f_fh < b_fh)
@@ -325,7 +435,7 @@ static void BSPWalkSeg(DrawSubsector *dsub, Seg *seg)
 // Placed here to be close to BSPWalkSeg(), which has similiar angle
 // clipping stuff in it.
 //
-static bool BSPCheckBBox(const float *bspcoord)
+static bool BSPCheckBBox(const float *bspcoord, const NodeHeightRange &heights)
 {
     EDGE_ZoneScoped;
 
@@ -417,7 +527,29 @@ static bool BSPCheckBBox(const float *bspcoord)
         }
     }
 
-    return !OcclusionTest(angle_R, angle_L);
+    if (OcclusionTest(angle_R, angle_L))
+        return false;
+
+    if (renderer_occlusion_spans.d_)
+    {
+        float left   = bspcoord[kBoundingBoxLeft] - view_x;
+        float right  = bspcoord[kBoundingBoxRight] - view_x;
+        float bottom = bspcoord[kBoundingBoxBottom] - view_y;
+        float top    = bspcoord[kBoundingBoxTop] - view_y;
+
+        float near_x = HMM_MAX(HMM_MAX(left, -right), 0.0f);
+        float near_y = HMM_MAX(HMM_MAX(bottom, -top), 0.0f);
+        float far_x  = HMM_MAX(fabs(left), fabs(right));
+        float far_y  = HMM_MAX(fabs(bottom), fabs(top));
+
+        float near_dist = sqrtf(near_x * near_x + near_y * near_y);
+        float far_dist  = sqrtf(far_x * far_x + far_y * far_y);
+
+        if (OcclusionTestSpans(angle_R, angle_L, near_dist, far_dist, heights.low, heights.high))
+            return false;
+    }
+
+    return true;
 }
 
 static inline void AddNewDrawFloor(DrawSubsector *dsub, float floor_height, float ceiling_height, float top_h,
@@ -675,12 +807,14 @@ void BSPWalkNode(unsigned int bspnum)
 
     side = PointOnDividingLineSide(view_x, view_y, &nd_div);
 
+    const NodeHeightRange *heights = &node_heights[bspnum * 2];
+
     // Recursively divide front space.
-    if (BSPCheckBBox(node->bounding_boxes[side]))
+    if (BSPCheckBBox(node->bounding_boxes[side], heights[side]))
         BSPWalkNode(node->children[side]);
 
     // Recursively divide back space.
-    if (BSPCheckBBox(node->bounding_boxes[side ^ 1]))
+    if (BSPCheckBBox(node->bounding_boxes[side ^ 1], heights[side ^ 1]))
         BSPWalkNode(node->children[side ^ 1]);
 }
 
@@ -699,6 +833,8 @@ static int32_t BSPTraverseProc(void *thread_data)
                 break;
             }
 
+            EDGE_ProfileZone("BSPTraverse");
+
             current_batch = nullptr;
 
             // walk the bsp tree
@@ -785,6 +921,10 @@ static bool traverse_stop_signalled;
 
 void BSPTraverse()
 {
+    EDGE_ProfileZone("BSPTraverse");
+
+    BSPUpdateNodeHeights();
+
     traverse_stop_signalled = false;
     thread_atomic_int_store(&bsp_thread.traverse_finished_, 0);
     thread_signal_raise(&bsp_thread.signal_start_);
@@ -895,6 +1035,8 @@ void BSPStopThread()
 
 void BSPTraverse()
 {
+    BSPUpdateNodeHeights();
+
     current_batch        = nullptr;
     render_batch_counter = 0;
     render_batch_travese = 0;
@@ -78,6 +78,8 @@ static constexpr uint8_t dummy_graphic[kDummyImageSize * kDummyImageSize] = {
     0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 0, 0, 0, 0, 0,
     0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
 
+static ImageData *ReadEncodedAsEpiBlock(Image *rim);
+
 //
 //  UTILITY
 //
@@ -297,28 +299,7 @@ static ImageData *ReadPatchAsEpiBlock(Image *rim)
 
     // handle PNG/JPEG/TGA images
     if (!rim->source_.graphic.is_patch)
-    {
-        epi::File *f;
-
-        if (packfile_name)
-            f = OpenFileFromPack(packfile_name);
-        else
-            f = LoadLumpAsFile(lump);
-
-        ImageData *img = LoadImageData(f);
-
-        // close it
-        delete f;
-
-        if (!img)
-            FatalError("Error loading image in lump: %s\n", packfile_name ? packfile_name : GetLumpNameFromIndex(lump));
-
-        // Try and manually tile, or at least fill in the black gaps ]
-        img->FillMarginX(rim->actual_width_);
-        img->FillMarginY(rim->actual_height_);
-
-        return img;
-    }
+        return ReadEncodedAsEpiBlock(rim);
 
     int tw = rim->total_width_;
     int th = rim->total_height_;
@@ -479,38 +460,152 @@ epi::File *OpenUserFileOrLump(ImageDefinition *def)
     }
 }
 
-static ImageData *CreateUserFileImage(Image *rim, ImageDefinition *def)
+//
+// ReadAsEncodedBlock
+//
+// PNG/JPEG/TGA images are the slow ones to read, nearly all the time goes
+// into decoding them.  For those this only reads the file into `enc' and
+// returns true, and DecodeEncodedBlock() does the rest.  Returns false for
+// every other kind of image (use ReadAsEpiBlock for those).
+//
+bool ReadAsEncodedBlock(Image *rim, EncodedImage *enc)
 {
-    epi::File *f = OpenUserFileOrLump(def);
+    epi::File *f = nullptr;
+
+    switch (rim->source_type_)
+    {
+    case kImageSourceGraphic:
+    case kImageSourceSprite:
+    case kImageSourceTXHI: {
+        if (rim->source_.graphic.is_patch)
+            return false;
+
+        const char *packfile_name = rim->source_.graphic.packfile_name;
 
-    if (!f)
-        FatalError("Missing image file: %s\n", def->info_.c_str());
+        if (packfile_name)
+        {
+            f         = OpenFileFromPack(packfile_name);
+            enc->name = packfile_name;
+        }
+        else
+        {
+            f         = LoadLumpAsFile(rim->source_.graphic.lump);
+            enc->name = GetLumpNameFromIndex(rim->source_.graphic.lump);
+        }
 
-    ImageData *img = LoadImageData(f);
+        if (!f)
+            FatalError("Error loading image in lump: %s\n", enc->name.c_str());
+
+        enc->user_file = false;
+        break;
+    }
+
+    case kImageSourceUser: {
+        ImageDefinition *def = rim->source_.user.def;
+
+        if (def->type_ != kImageDataFile && def->type_ != kImageDataLump && def->type_ != kImageDataPackage)
+            return false;
+
+        f = OpenUserFileOrLump(def);
+
+        if (!f)
+            FatalError("Missing image file: %s\n", def->info_.c_str());
+
+        enc->name      = def->info_;
+        enc->user_file = true;
+        enc->is_font   = def->is_font_;
+        enc->blacken   = (def->fix_trans_ == kTransparencyFixBlacken);
+        break;
+    }
+
+    default:
+        return false;
+    }
+
+    enc->data.resize(f->GetLength());
+
+    if (!enc->data.empty())
+        f->Read(enc->data.data(), enc->data.size());
 
     // close it
     delete f;
 
+    enc->actual_width  = rim->actual_width_;
+    enc->actual_height = rim->actual_height_;
+
+    return true;
+}
+
+//
+// DecodeEncodedBlock
+//
+// Decodes what ReadAsEncodedBlock() read.  Does not touch the Image, so
+// this can run on an image worker.  For user images the opacity is
+// determined here and stored in `opacity' and `is_empty'.  Returns nullptr
+// if the image could not be decoded.
+//
+ImageData *DecodeEncodedBlock(const EncodedImage &enc, int *opacity, bool *is_empty)
+{
+    epi::MemFile f(enc.data.data(), (int)enc.data.size(), false);
+
+    ImageData *img = LoadImageData(&f);
+
     if (!img)
-        FatalError("Error occurred loading image file: %s\n", def->info_.c_str());
+        return nullptr;
 
-    rim->opacity_ = DetermineOpacity(img, &rim->is_empty_);
+    if (enc.user_file)
+    {
+        *opacity = DetermineOpacity(img, is_empty);
 
-    if (def->is_font_)
-        return img;
+        if (enc.is_font)
+            return img;
 
-    if (def->fix_trans_ == kTransparencyFixBlacken)
-        BlackenClearAreas(img);
+        if (enc.blacken)
+            BlackenClearAreas(img);
 
-    EPI_ASSERT(rim->total_width_ == img->width_);
-    EPI_ASSERT(rim->total_height_ == img->height_);
+        // CW: Textures MUST tile! If actual size not total size, manually tile
+        // [ AJA: this does not make them tile, just fills in the black gaps ]
+        if (*opacity == kOpacitySolid)
+        {
+            img->FillMarginX(enc.actual_width);
+            img->FillMarginY(enc.actual_height);
+        }
+    }
+    else
+    {
+        // Try and manually tile, or at least fill in the black gaps ]
+        img->FillMarginX(enc.actual_width);
+        img->FillMarginY(enc.actual_height);
+    }
 
-    // CW: Textures MUST tile! If actual size not total size, manually tile
-    // [ AJA: this does not make them tile, just fills in the black gaps ]
-    if (rim->opacity_ == kOpacitySolid)
+    return img;
+}
+
+static ImageData *ReadEncodedAsEpiBlock(Image *rim)
+{
+    EncodedImage enc;
+
+    if (!ReadAsEncodedBlock(rim, &enc))
+        FatalError("ReadEncodedAsEpiBlock: Coding error, [%s] is not encoded\n", rim->name_.c_str());
+
+    int  opacity  = rim->opacity_;
+    bool is_empty = rim->is_empty_;
+
+    ImageData *img = DecodeEncodedBlock(enc, &opacity, &is_empty);
+
+    if (!img)
+        FatalError("Error loading image: %s\n", enc.name.c_str());
+
+    if (enc.user_file)
     {
-        img->FillMarginX(rim->actual_width_);
-        img->FillMarginY(rim->actual_height_);
+        rim->opacity_  = opacity;
+        rim->is_empty_ = is_empty;
+
+        if (!enc.is_font)
+        {
+            EPI_ASSERT(rim->total_width_ == img->width_);
+            EPI_ASSERT(rim->total_height_ == img->height_);
+        }
     }
 
     return img;
@@ -536,7 +631,7 @@ static ImageData *ReadUserAsEpiBlock(Image *rim)
     case kImageDataFile:
     case kImageDataLump:
     case kImageDataPackage:
-        return CreateUserFileImage(rim, def);
+        return ReadEncodedAsEpiBlock(rim);
 
     default:
         FatalError("ReadUserAsEpiBlock: Coding error, unknown type %d\n", def->type_);
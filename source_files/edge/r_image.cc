@@ -35,6 +35,7 @@
 
 #include <limits.h>
 
+#include <deque>
 #include <list>
 #include <map>
 
@@ -61,6 +62,7 @@
 #include "m_menu.h"
 #include "m_misc.h"
 #include "p_local.h"
+#include "r_backend.h"
 #include "r_colormap.h"
 #include "r_defs.h"
 #include "r_gldefs.h"
@@ -69,12 +71,15 @@
 #include "r_sky.h"
 #include "r_texgl.h"
 #include "r_wipe.h"
+#include "stb_rect_pack.h"
 #include "w_epk.h"
 #include "w_files.h"
 #include "w_texture.h"
 #include "w_wad.h"
 
 extern ImageData *ReadAsEpiBlock(Image *rim);
+extern bool       ReadAsEncodedBlock(Image *rim, EncodedImage *enc);
+extern ImageData *DecodeEncodedBlock(const EncodedImage &enc, int *opacity, bool *is_empty);
 
 extern epi::File *OpenUserFileOrLump(ImageDefinition *def);
 
@@ -107,6 +112,21 @@ struct CachedImage
     GLuint texture_id;
 
     bool is_whitened;
+
+    // texture is being prepared by an image worker (texture_id is 0)
+    bool is_pending;
+
+    // location within an atlas page (see ImageCacheAtlas), page is -1
+    // when not in one.  The image keeps its own texture as well.
+    int   atlas_page;
+    bool  atlas_tried;
+    float atlas_x, atlas_y;
+    float atlas_scale_x, atlas_scale_y;
+
+    // the finished pixels of an atlas candidate, kept from its normal
+    // upload until AddToAtlas() takes them (so they aren't decoded twice)
+    ImageData *atlas_pixels;
+    bool       atlas_smooth;
 };
 
 // total set of images
@@ -1121,7 +1141,76 @@ static int IM_PixelLimit()
         return (1 << 22);
 }
 
-static GLuint LoadImageOGL(Image *rim, const Colormap *trans, bool do_whiten)
+enum ImageLoadMode
+{
+    kImageLoadNow = 0,
+    kImageLoadDeferred, // may be handed to the image workers
+    kImageLoadPrecache  // always queued, see ImageFinishPrecache()
+};
+
+//
+// Everything needed to turn the raw image block into texture data.  The
+// main thread fills in the inputs (this is where all the file access
+// happens), ProcessImageJob() does the pixel work without touching the
+// parent Image, then the results are copied back in FinishImageJob().
+// PNG/JPEG/TGA images are only read by the main thread, the decoding
+// is part of the pixel work.
+//
+struct ImageUploadJob
+{
+    // destination cache entry; only touched by the main thread
+    CachedImage *cache = nullptr;
+
+    ImageData *image = nullptr;
+
+    // used instead of `image' for PNG/JPEG/TGA images
+    EncodedImage encoded;
+    bool         is_encoded    = false;
+    bool         decode_failed = false;
+
+    uint8_t palette[256 * 3];
+    bool    remap_palette = false;
+
+    bool is_font  = false;
+    int  opacity  = kOpacityUnknown;
+    bool is_empty = false;
+
+    int  hsv_rotation   = 0;
+    int  hsv_saturation = -1;
+    int  hsv_value      = 0;
+    bool whiten         = false;
+    bool flip           = false;
+    bool invert         = false;
+
+    uint16_t actual_width  = 0;
+    uint16_t actual_height = 0;
+
+    int upload_flags = 0;
+    int max_pix      = 0;
+    int max_size     = 0;
+    int mipmapping   = 0;
+
+    // results
+    uint16_t  real_bottom   = 0;
+    uint16_t  real_top      = 0;
+    uint16_t  real_left     = 0;
+    uint16_t  real_right    = 0;
+    RGBAColor average_color = kRGBANoValue;
+
+    // filled in when the mip chain is built on a worker
+    std::vector<ImageData *> levels;
+    int                      total_bytes = 0;
+
+    ~ImageUploadJob()
+    {
+        delete image;
+
+        for (ImageData *level : levels)
+            delete level;
+    }
+};
+
+static ImageUploadJob *PrepareImageJob(Image *rim, const Colormap *trans, bool do_whiten)
 {
     bool clamp  = IM_ShouldClamp(rim);
     bool mip    = IM_ShouldMipmap(rim);
@@ -1129,8 +1218,6 @@ static GLuint LoadImageOGL(Image *rim, const Colormap *trans, bool do_whiten)
     bool flip   = false;
     bool invert = false;
 
-    int max_pix = IM_PixelLimit();
-
     if (rim->source_type_ == kImageSourceUser)
     {
         if (rim->source_.user.def->special_ & kImageSpecialClamp)
@@ -1170,10 +1257,7 @@ static GLuint LoadImageOGL(Image *rim, const Colormap *trans, bool do_whiten)
         invert = (rim->source_.graphic.special & kImageSpecialInvert);
     }
 
-    const uint8_t *what_palette    = (const uint8_t *)&playpal_data[0];
-    bool           what_pal_cached = false;
-
-    static uint8_t trans_pal[256 * 3];
+    ImageUploadJob *job = new ImageUploadJob;
 
     if (trans != nullptr)
     {
@@ -1181,28 +1265,83 @@ static GLuint LoadImageOGL(Image *rim, const Colormap *trans, bool do_whiten)
         // the translation table itself would not match the other palette,
         // and so we would still end up with messed up colours.
 
-        TranslatePalette(trans_pal, what_palette, trans);
-        what_palette = trans_pal;
+        TranslatePalette(job->palette, (const uint8_t *)&playpal_data[0], trans);
+        job->remap_palette = true;
     }
     else if (rim->source_palette_ >= 0)
     {
-        what_palette    = (const uint8_t *)LoadLumpIntoMemory(rim->source_palette_);
-        what_pal_cached = true;
+        const uint8_t *what_palette = (const uint8_t *)LoadLumpIntoMemory(rim->source_palette_);
+        memcpy(job->palette, what_palette, 256 * 3);
+        delete[] what_palette;
+    }
+    else
+        memcpy(job->palette, &playpal_data[0], 256 * 3);
+
+    if (ReadAsEncodedBlock(rim, &job->encoded))
+        job->is_encoded = true;
+    else
+    {
+        job->image = ReadAsEpiBlock(rim);
+
+        if (rim->opacity_ == kOpacityUnknown)
+            rim->opacity_ = DetermineOpacity(job->image, &rim->is_empty_);
     }
 
-    ImageData *tmp_img = ReadAsEpiBlock(rim);
+    job->is_font        = rim->is_font_;
+    job->opacity        = rim->opacity_;
+    job->is_empty       = rim->is_empty_;
+    job->hsv_rotation   = rim->hsv_rotation_;
+    job->hsv_saturation = rim->hsv_saturation_;
+    job->hsv_value      = rim->hsv_value_;
+    job->whiten         = do_whiten;
+    job->flip           = flip;
+    job->invert         = invert;
+    job->actual_width   = rim->actual_width_;
+    job->actual_height  = rim->actual_height_;
+
+    job->upload_flags = (clamp ? kUploadClamp : 0) | (mip ? kUploadMipMap : 0) | (smooth ? kUploadSmooth : 0) |
+                        ((rim->opacity_ == kOpacityMasked) ? kUploadThresh : 0);
+    job->max_pix    = IM_PixelLimit();
+    job->max_size   = render_backend->GetMaxTextureSize();
+    job->mipmapping = image_mipmapping;
+
+    return job;
+}
+
+// Note: must not touch the parent Image, this can run on an image worker.
+static void ProcessImageJob(ImageUploadJob *job, bool build_mips)
+{
+    if (job->is_encoded)
+    {
+        job->image = DecodeEncodedBlock(job->encoded, &job->opacity, &job->is_empty);
+
+        // reported by FinishImageJob()
+        if (!job->image)
+        {
+            job->decode_failed = true;
+            return;
+        }
 
-    if (rim->opacity_ == kOpacityUnknown)
-        rim->opacity_ = DetermineOpacity(tmp_img, &rim->is_empty_);
+        if (job->opacity == kOpacityUnknown)
+            job->opacity = DetermineOpacity(job->image, &job->is_empty);
+
+        if (job->opacity == kOpacityMasked)
+            job->upload_flags |= kUploadThresh;
+
+        job->encoded.data.clear();
+        job->encoded.data.shrink_to_fit();
+    }
+
+    ImageData *tmp_img = job->image;
 
     if (tmp_img->depth_ == 1)
     {
-        ImageData *rgb_img = RGBFromPalettised(tmp_img, what_palette, rim->opacity_);
+        ImageData *rgb_img = RGBFromPalettised(tmp_img, job->palette, job->opacity);
 
-        if (rim->is_font_)
+        if (job->is_font)
         {
             rgb_img->RemoveBackground();
-            rim->opacity_ = DetermineOpacity(tmp_img, &rim->is_empty_);
+            job->opacity = DetermineOpacity(tmp_img, &job->is_empty);
         }
 
         delete tmp_img;
@@ -1210,62 +1349,709 @@ static GLuint LoadImageOGL(Image *rim, const Colormap *trans, bool do_whiten)
     }
     else if (tmp_img->depth_ >= 3)
     {
-        if (rim->is_font_)
+        if (job->is_font)
         {
             tmp_img->RemoveBackground();
-            rim->opacity_ = DetermineOpacity(tmp_img, &rim->is_empty_);
+            job->opacity = DetermineOpacity(tmp_img, &job->is_empty);
         }
-        if (trans != nullptr)
-            PaletteRemapRGBA(tmp_img, what_palette, (const uint8_t *)&playpal_data[0]);
+        if (job->remap_palette)
+            PaletteRemapRGBA(tmp_img, job->palette, (const uint8_t *)&playpal_data[0]);
     }
 
-    if (rim->hsv_rotation_ || rim->hsv_saturation_ > -1 || rim->hsv_value_)
-        tmp_img->SetHSV(rim->hsv_rotation_, rim->hsv_saturation_, rim->hsv_value_);
+    job->image = tmp_img;
+
+    if (job->hsv_rotation || job->hsv_saturation > -1 || job->hsv_value)
+        tmp_img->SetHSV(job->hsv_rotation, job->hsv_saturation, job->hsv_value);
 
-    if (do_whiten)
+    if (job->whiten)
         tmp_img->Whiten();
 
     // Need to flip or invert before checking image bounds.
-    if (flip)
+    if (job->flip)
         tmp_img->Flip();
 
-    if (invert)
+    if (job->invert)
         tmp_img->Invert();
 
-    if (tmp_img->depth_ == 4 || (tmp_img->depth_ == 3 && rim->is_font_))
+    if (tmp_img->depth_ == 4 || (tmp_img->depth_ == 3 && job->is_font))
     {
         RGBAColor background = kRGBATransparent;
 
         if (tmp_img->depth_ == 3)
             background = epi::MakeRGBA(tmp_img->pixels_[0], tmp_img->pixels_[1], tmp_img->pixels_[2]);
 
-        tmp_img->DetermineRealBounds(&rim->real_bottom_, &rim->real_left_, &rim->real_right_, &rim->real_top_,
+        tmp_img->DetermineRealBounds(&job->real_bottom, &job->real_left, &job->real_right, &job->real_top,
                                      background);
     }
     else
     {
-        rim->real_left_   = 0;
-        rim->real_bottom_ = 0;
-        rim->real_top_    = rim->actual_height_;
-        rim->real_right_  = rim->actual_width_;
+        job->real_left   = 0;
+        job->real_bottom = 0;
+        job->real_top    = job->actual_height;
+        job->real_right  = job->actual_width;
     }
 
-    rim->average_color_ = tmp_img->AverageColor();
+    job->average_color = tmp_img->AverageColor();
 
-    GLuint tex_id =
-        UploadTexture(tmp_img,
-                      (clamp ? kUploadClamp : 0) | (mip ? kUploadMipMap : 0) | (smooth ? kUploadSmooth : 0) |
-                          ((rim->opacity_ == kOpacityMasked) ? kUploadThresh : 0),
-                      max_pix);
+    if (build_mips)
+    {
+        BuildTextureMipChain(tmp_img, job->upload_flags, job->max_pix, job->max_size, job->mipmapping, job->levels);
 
-    delete tmp_img;
+        for (ImageData *level : job->levels)
+            job->total_bytes += level->width_ * level->height_ * level->depth_;
 
-    if (what_pal_cached)
-        delete[] what_palette;
+        delete job->image;
+        job->image = nullptr;
+    }
+}
+
+static void FinishImageJob(Image *rim, const ImageUploadJob *job)
+{
+    if (job->decode_failed)
+        FatalError("Error loading image: %s\n", job->encoded.name.c_str());
+
+    rim->opacity_       = job->opacity;
+    rim->is_empty_      = job->is_empty;
+    rim->real_bottom_   = job->real_bottom;
+    rim->real_top_      = job->real_top;
+    rim->real_left_     = job->real_left;
+    rim->real_right_    = job->real_right;
+    rim->average_color_ = job->average_color;
+}
+
+static void KeepAtlasPixels(CachedImage *rc, ImageData **img, int upload_flags);
+
+static GLuint LoadImageOGL(CachedImage *rc, const Colormap *trans, bool do_whiten)
+{
+    Image *rim = rc->parent;
+
+    ImageUploadJob *job = PrepareImageJob(rim, trans, do_whiten);
+
+    ProcessImageJob(job, false);
+    FinishImageJob(rim, job);
+
+    GLuint tex_id = UploadTexture(job->image, job->upload_flags, job->max_pix);
+
+    KeepAtlasPixels(rc, &job->image, job->upload_flags);
+
+    delete job;
 
     return tex_id;
 }
 
+//----------------------------------------------------------------------------
+//
+//  ATLAS PAGES
+//
+//  Small HUD graphics and sprites are also copied into a few shared
+//  atlas pages, so that drawing a run of them doesn't need a texture
+//  change for each one.  Images are added the frame after they are first
+//  drawn through ImageCacheAtlas() (until then their own texture is
+//  used), and each page is sent to the GPU at most once per frame.
+//
+
+EDGE_DEFINE_CONSOLE_VARIABLE(image_atlas, "1", kConsoleVariableFlagArchive)
+
+static constexpr int kAtlasPageSize     = 1024;
+static constexpr int kAtlasMaxPages     = 8;
+static constexpr int kAtlasMaxImageSize = 64;
+
+struct AtlasPage
+{
+    ImageData *data = nullptr;
+
+    stbrp_context           context;
+    std::vector<stbrp_node> nodes;
+
+    GLuint texture_id = 0;
+
+    bool smooth = false;
+    bool dirty  = false;
+};
+
+static std::vector<AtlasPage *>  atlas_pages;
+static std::vector<CachedImage *> atlas_queue;
+
+static bool IM_ShouldAtlas(const Image *rim)
+{
+    if (rim->is_font_)
+        return false;
+
+    if (rim->actual_width_ > kAtlasMaxImageSize || rim->actual_height_ > kAtlasMaxImageSize)
+        return false;
+
+    // only things which are clamped and never mipmapped
+    if (!IM_ShouldClamp(rim) || IM_ShouldMipmap(rim))
+        return false;
+
+    switch (rim->source_type_)
+    {
+    case kImageSourceGraphic:
+    case kImageSourceSprite:
+        return true;
+
+    case kImageSourceUser:
+        return rim->source_.user.def->belong_ == kImageNamespaceGraphic ||
+               rim->source_.user.def->belong_ == kImageNamespaceSprite;
+
+    default:
+        return false;
+    }
+}
+
+// After a normal upload, take the pixels of an image which may go into
+// the atlas later, leaving *img null.  Without mipmaps the upload is the
+// single level, so these are exactly what the texture was made from.
+static void KeepAtlasPixels(CachedImage *rc, ImageData **img, int upload_flags)
+{
+    if (!image_atlas.d_ || !*img || (upload_flags & kUploadMipMap))
+        return;
+
+    if (rc->translation_map || rc->is_whitened || rc->atlas_tried || !IM_ShouldAtlas(rc->parent))
+        return;
+
+    delete rc->atlas_pixels;
+
+    rc->atlas_pixels = *img;
+    rc->atlas_smooth = (upload_flags & kUploadSmooth) ? true : false;
+
+    *img = nullptr;
+}
+
+static AtlasPage *NewAtlasPage(bool smooth)
+{
+    int size = HMM_MIN(kAtlasPageSize, render_backend->GetMaxTextureSize());
+
+    AtlasPage *page = new AtlasPage;
+
+    page->data = new ImageData(size, size, 4);
+    page->data->Clear(0);
+
+    page->nodes.resize(size);
+    stbrp_init_target(&page->context, size, size, page->nodes.data(), size);
+
+    page->texture_id = CreateDynamicTexture(size, size, kUploadClamp | (smooth ? kUploadSmooth : 0));
+    page->smooth     = smooth;
+
+    atlas_pages.push_back(page);
+
+    return page;
+}
+
+//
+// Copy the image into the page at the given spot, with a one pixel
+// border which repeats the edge pixels (like clamping does).
+//
+static void BlitIntoAtlasPage(AtlasPage *page, const ImageData *img, int w, int h, int px, int py)
+{
+    for (int y = -1; y <= h; y++)
+    {
+        int sy = HMM_Clamp(0, y, h - 1);
+
+        for (int x = -1; x <= w; x++)
+        {
+            int sx = HMM_Clamp(0, x, w - 1);
+
+            const uint8_t *src  = img->PixelAt(sx, sy);
+            uint8_t       *dest = page->data->PixelAt(px + 1 + x, py + 1 + y);
+
+            dest[0] = src[0];
+            dest[1] = src[1];
+            dest[2] = src[2];
+            dest[3] = (img->depth_ == 4) ? src[3] : 255;
+        }
+    }
+
+    page->dirty = true;
+}
+
+static void AddToAtlas(CachedImage *rc)
+{
+    Image *rim = rc->parent;
+
+    ImageData *img    = rc->atlas_pixels;
+    bool       smooth = rc->atlas_smooth;
+
+    rc->atlas_pixels = nullptr;
+
+    // only when loaded before the atlas was turned on
+    if (!img)
+    {
+        ImageUploadJob *job = PrepareImageJob(rim, nullptr, false);
+
+        ProcessImageJob(job, false);
+        FinishImageJob(rim, job);
+
+        img    = job->image;
+        smooth = (job->upload_flags & kUploadSmooth) ? true : false;
+
+        job->image = nullptr;
+        delete job;
+    }
+
+    // size of the part which texture coordinates can reach
+    int w = HMM_MIN(img->width_, (int)ceilf(rim->Right() * img->width_));
+    int h = HMM_MIN(img->height_, (int)ceilf(rim->Top() * img->height_));
+
+    if (img->depth_ < 3 || w < 1 || h < 1)
+    {
+        delete img;
+        return;
+    }
+
+    stbrp_rect rect;
+    EPI_CLEAR_MEMORY(&rect, stbrp_rect, 1);
+
+    rect.w = w + 2;
+    rect.h = h + 2;
+
+    AtlasPage *page = nullptr;
+
+    for (AtlasPage *try_page : atlas_pages)
+    {
+        if (try_page->smooth != smooth)
+            continue;
+
+        if (stbrp_pack_rects(&try_page->context, &rect, 1) && rect.was_packed)
+        {
+            page = try_page;
+            break;
+        }
+    }
+
+    if (!page && (int)atlas_pages.size() < kAtlasMaxPages)
+    {
+        AtlasPage *new_page = NewAtlasPage(smooth);
+
+        if (stbrp_pack_rects(&new_page->context, &rect, 1) && rect.was_packed)
+            page = new_page;
+    }
+
+    if (page)
+    {
+        BlitIntoAtlasPage(page, img, w, h, rect.x, rect.y);
+
+        float page_w = (float)page->data->width_;
+        float page_h = (float)page->data->height_;
+
+        rc->atlas_page    = (int)(std::find(atlas_pages.begin(), atlas_pages.end(), page) - atlas_pages.begin());
+        rc->atlas_x       = (rect.x + 1) / page_w;
+        rc->atlas_y       = (rect.y + 1) / page_h;
+        rc->atlas_scale_x = img->width_ / page_w;
+        rc->atlas_scale_y = img->height_ / page_h;
+    }
+
+    delete img;
+}
+
+static void ProcessAtlasQueue(void)
+{
+    if (atlas_queue.empty())
+        return;
+
+    for (CachedImage *rc : atlas_queue)
+        AddToAtlas(rc);
+
+    atlas_queue.clear();
+
+    for (AtlasPage *page : atlas_pages)
+    {
+        if (page->dirty)
+        {
+            UpdateDynamicTexture(page->texture_id, page->data);
+            page->dirty = false;
+        }
+    }
+}
+
+static void DeleteAtlasPages(void)
+{
+    for (AtlasPage *page : atlas_pages)
+    {
+        render_state->DeleteTexture(&page->texture_id);
+        delete page->data;
+        delete page;
+    }
+
+    atlas_pages.clear();
+    atlas_queue.clear();
+}
+
+//----------------------------------------------------------------------------
+//
+//  ASYNCHRONOUS LOADING
+//
+//  Wall and flat textures met for the first time during play are handed
+//  to a small pool of image workers, which do the palette conversion and
+//  build the mipmap chain.  The render thread uploads the finished ones at
+//  the start of each frame (within a budget), drawing a placeholder until
+//  then.  Level precaching always takes the synchronous path.
+//
+
+EDGE_DEFINE_CONSOLE_VARIABLE(image_async_upload, "1", kConsoleVariableFlagArchive)
+EDGE_DEFINE_CONSOLE_VARIABLE(image_upload_budget, "8", kConsoleVariableFlagArchive)
+EDGE_DEFINE_CONSOLE_VARIABLE(image_upload_budget_kb, "4096", kConsoleVariableFlagArchive)
+
+constexpr uint8_t kImageWorkerCount = 2;
+
+struct ImageWorkers
+{
+    thread_ptr_t        threads_[kImageWorkerCount];
+    thread_mutex_t      mutex_;
+    thread_signal_t     signal_work_;
+    thread_atomic_int_t exit_flag_;
+    thread_atomic_int_t busy_count_;
+
+    // both protected by mutex_
+    std::deque<ImageUploadJob *> queued_;
+    std::deque<ImageUploadJob *> finished_;
+
+    bool started_ = false;
+};
+
+static ImageWorkers image_workers;
+
+static GLuint placeholder_solid_texture = 0;
+static GLuint placeholder_clear_texture = 0;
+
+static int32_t ImageWorkerProc(void *thread_data)
+{
+    EPI_UNUSED(thread_data);
+
+    while (thread_atomic_int_load(&image_workers.exit_flag_) == 0)
+    {
+        ImageUploadJob *job = nullptr;
+
+        thread_mutex_lock(&image_workers.mutex_);
+
+        if (!image_workers.queued_.empty())
+        {
+            job = image_workers.queued_.front();
+            image_workers.queued_.pop_front();
+
+            thread_atomic_int_inc(&image_workers.busy_count_);
+
+            // let the other worker(s) pick up the rest
+            if (!image_workers.queued_.empty())
+                thread_signal_raise(&image_workers.signal_work_);
+        }
+
+        thread_mutex_unlock(&image_workers.mutex_);
+
+        if (!job)
+        {
+            thread_signal_wait(&image_workers.signal_work_, 100);
+            continue;
+        }
+
+        ProcessImageJob(job, true);
+
+        thread_mutex_lock(&image_workers.mutex_);
+        image_workers.finished_.push_back(job);
+        thread_mutex_unlock(&image_workers.mutex_);
+
+        thread_atomic_int_dec(&image_workers.busy_count_);
+    }
+
+    return 0;
+}
+
+static void StartImageWorkers(void)
+{
+    if (image_workers.started_)
+        return;
+
+    thread_mutex_init(&image_workers.mutex_);
+    thread_signal_init(&image_workers.signal_work_);
+    thread_atomic_int_store(&image_workers.exit_flag_, 0);
+    thread_atomic_int_store(&image_workers.busy_count_, 0);
+
+    for (int i = 0; i < kImageWorkerCount; i++)
+        image_workers.threads_[i] = thread_create(ImageWorkerProc, nullptr, THREAD_STACK_SIZE_DEFAULT);
+
+    image_workers.started_ = true;
+}
+
+//
+// Throw away every queued or finished job, waiting for the workers to
+// finish whatever they are busy with.  The cache entries go back to
+// being unloaded.
+//
+static void CancelImageJobs(void)
+{
+    if (!image_workers.started_)
+        return;
+
+    std::deque<ImageUploadJob *> dropped;
+
+    thread_mutex_lock(&image_workers.mutex_);
+    dropped.swap(image_workers.queued_);
+    thread_mutex_unlock(&image_workers.mutex_);
+
+    while (thread_atomic_int_load(&image_workers.busy_count_) > 0)
+        thread_yield();
+
+    thread_mutex_lock(&image_workers.mutex_);
+    dropped.insert(dropped.end(), image_workers.finished_.begin(), image_workers.finished_.end());
+    image_workers.finished_.clear();
+    thread_mutex_unlock(&image_workers.mutex_);
+
+    for (ImageUploadJob *job : dropped)
+    {
+        job->cache->is_pending = false;
+        delete job;
+    }
+}
+
+static void StopImageWorkers(void)
+{
+    if (!image_workers.started_)
+        return;
+
+    CancelImageJobs();
+
+    thread_atomic_int_store(&image_workers.exit_flag_, 1);
+
+    for (int i = 0; i < kImageWorkerCount; i++)
+        thread_signal_raise(&image_workers.signal_work_);
+
+    for (int i = 0; i < kImageWorkerCount; i++)
+        thread_join(image_workers.threads_[i]);
+
+    thread_signal_term(&image_workers.signal_work_);
+    thread_mutex_term(&image_workers.mutex_);
+
+    image_workers.started_ = false;
+}
+
+static GLuint CreatePlaceholderTexture(uint8_t grey, uint8_t alpha)
+{
+    ImageData img(2, 2, 4);
+
+    for (int i = 0; i < 4; i++)
+    {
+        img.pixels_[i * 4 + 0] = grey;
+        img.pixels_[i * 4 + 1] = grey;
+        img.pixels_[i * 4 + 2] = grey;
+        img.pixels_[i * 4 + 3] = alpha;
+    }
+
+    return UploadTexture(&img, kUploadNone);
+}
+
+static GLuint PlaceholderTexture(const Image *rim)
+{
+    if (rim->opacity_ == kOpacitySolid)
+    {
+        if (placeholder_solid_texture == 0)
+            placeholder_solid_texture = CreatePlaceholderTexture(96, 255);
+
+        return placeholder_solid_texture;
+    }
+
+    if (placeholder_clear_texture == 0)
+        placeholder_clear_texture = CreatePlaceholderTexture(0, 0);
+
+    return placeholder_clear_texture;
+}
+
+// only wall and flat textures are deferred, anything else (sprites,
+// fonts, HUD graphics, skies) needs its real bounds straight away.
+static bool IM_ShouldDefer(const Image *rim)
+{
+    if (rim->is_font_)
+        return false;
+
+    // the "SKY" check here is a hack...
+    if (epi::StringPrefixCaseCompareASCII(rim->name_, "SKY") == 0)
+        return false;
+
+    switch (rim->source_type_)
+    {
+    case kImageSourceTexture:
+    case kImageSourceFlat:
+    case kImageSourceTXHI:
+        return true;
+
+    case kImageSourceUser:
+        switch (rim->source_.user.def->belong_)
+        {
+        case kImageNamespaceTexture:
+        case kImageNamespaceFlat:
+            return true;
+
+        default:
+            return false;
+        }
+
+    default:
+        return false;
+    }
+}
+
+static void QueueImageJob(CachedImage *rc, const Colormap *trans, bool do_whiten)
+{
+    StartImageWorkers();
+
+    ImageUploadJob *job = PrepareImageJob(rc->parent, trans, do_whiten);
+
+    job->cache     = rc;
+    rc->is_pending = true;
+
+    thread_mutex_lock(&image_workers.mutex_);
+    image_workers.queued_.push_back(job);
+    thread_mutex_unlock(&image_workers.mutex_);
+
+    thread_signal_raise(&image_workers.signal_work_);
+}
+
+static ImageUploadJob *PopFinishedImageJob(void)
+{
+    ImageUploadJob *job = nullptr;
+
+    thread_mutex_lock(&image_workers.mutex_);
+
+    if (!image_workers.finished_.empty())
+    {
+        job = image_workers.finished_.front();
+        image_workers.finished_.pop_front();
+    }
+
+    thread_mutex_unlock(&image_workers.mutex_);
+
+    return job;
+}
+
+// returns the number of bytes uploaded
+static int UploadFinishedImageJob(ImageUploadJob *job)
+{
+    CachedImage *rc = job->cache;
+
+    FinishImageJob(rc->parent, job);
+
+    rc->texture_id = UploadTextureMipChain(job->levels, job->upload_flags, job->mipmapping);
+    rc->is_pending = false;
+
+    if (job->levels.size() == 1)
+        KeepAtlasPixels(rc, &job->levels[0], job->upload_flags);
+
+    int bytes = job->total_bytes;
+
+    delete job;
+
+    return bytes;
+}
+
+//
+// Upload the textures which the image workers have finished, within the
+// per-frame budget.  Called once at the start of each frame.
+//
+void ProcessImageUploads(void)
+{
+    ProcessAtlasQueue();
+
+    if (!image_workers.started_)
+        return;
+
+    int count = 0;
+    int bytes = 0;
+
+    for (;;)
+    {
+        // always upload at least one, so we can't stall on a huge image
+        if (count > 0)
+        {
+            if (count >= image_upload_budget.d_)
+                break;
+
+            if (image_upload_budget_kb.d_ > 0 && bytes >= image_upload_budget_kb.d_ * 1024)
+                break;
+        }
+
+        ImageUploadJob *job = PopFinishedImageJob();
+
+        if (!job)
+            break;
+
+        bytes += UploadFinishedImageJob(job);
+        count++;
+    }
+}
+
+//
+// Level precaching.  Between ImageBeginPrecache() and ImageFinishPrecache()
+// every ImagePrecache() only reads the image and queues it, then all of
+// them are decoded in parallel (the main thread lends a hand) and the
+// textures are uploaded in one go.
+//
+
+static bool precache_batch_active = false;
+static int  precache_batch_count  = 0;
+static int  precache_batch_start  = 0;
+
+void ImageBeginPrecache(void)
+{
+    EPI_ASSERT(!precache_batch_active);
+
+    precache_batch_active = true;
+    precache_batch_count  = 0;
+    precache_batch_start  = GetMilliseconds();
+}
+
+void ImageFinishPrecache(void)
+{
+    EPI_ASSERT(precache_batch_active);
+
+    precache_batch_active = false;
+
+    if (!image_workers.started_)
+        return;
+
+    for (;;)
+    {
+        ImageUploadJob *job = nullptr;
+
+        thread_mutex_lock(&image_workers.mutex_);
+
+        bool all_done = image_workers.queued_.empty() && thread_atomic_int_load(&image_workers.busy_count_) == 0;
+
+        if (!image_workers.queued_.empty())
+        {
+            job = image_workers.queued_.front();
+            image_workers.queued_.pop_front();
+        }
+
+        thread_mutex_unlock(&image_workers.mutex_);
+
+        if (all_done)
+            break;
+
+        if (!job)
+        {
+            thread_yield();
+            continue;
+        }
+
+        ProcessImageJob(job, true);
+
+        thread_mutex_lock(&image_workers.mutex_);
+        image_workers.finished_.push_back(job);
+        thread_mutex_unlock(&image_workers.mutex_);
+    }
+
+    int count = 0;
+    int bytes = 0;
+
+    for (ImageUploadJob *job = PopFinishedImageJob(); job; job = PopFinishedImageJob())
+    {
+        bytes += UploadFinishedImageJob(job);
+        count++;
+    }
+
+    LogPrint("Precached %d images (%d textures, %d KB) in %d ms\n", precache_batch_count, count, bytes / 1024,
+             GetMilliseconds() - precache_batch_start);
+}
+
 //----------------------------------------------------------------------------
 //  IMAGE LOOKUP
 //----------------------------------------------------------------------------
@@ -1624,7 +2410,7 @@ void ImageMakeSaveString(const Image *image, char *type, char *namebuf)
 //  IMAGE USAGE
 //
 
-static CachedImage *ImageCacheOGL(Image *rim, const Colormap *trans, bool do_whiten)
+static CachedImage *ImageCacheOGL(Image *rim, const Colormap *trans, bool do_whiten, ImageLoadMode mode)
 {
     // check if image + translation is already cached
 
@@ -1669,6 +2455,11 @@ static CachedImage *ImageCacheOGL(Image *rim, const Colormap *trans, bool do_whi
         rc->hue             = kRGBANoValue;
         rc->texture_id      = 0;
         rc->is_whitened     = do_whiten ? true : false;
+        rc->is_pending      = false;
+        rc->atlas_page      = -1;
+        rc->atlas_tried     = false;
+        rc->atlas_pixels    = nullptr;
+        rc->atlas_smooth    = false;
 
         image_cache.push_back(rc);
 
@@ -1680,20 +2471,48 @@ static CachedImage *ImageCacheOGL(Image *rim, const Colormap *trans, bool do_whi
 
     EPI_ASSERT(rc);
 
-    if (rc->texture_id == 0)
+    if (rc->texture_id == 0 && !rc->is_pending)
     {
-        // load image into cache
-        rc->texture_id = LoadImageOGL(rim, trans, do_whiten);
+        if (mode == kImageLoadPrecache ||
+            (mode == kImageLoadDeferred && image_async_upload.d_ && IM_ShouldDefer(rim)))
+            QueueImageJob(rc, trans, do_whiten);
+        else // load image into cache
+            rc->texture_id = LoadImageOGL(rc, trans, do_whiten);
     }
 
     return rc;
 }
 
+static GLuint ImageCacheInternal(const Image *image, bool anim, const Colormap *trans, bool do_whiten,
+                                 ImageLoadMode mode)
+{
+    // Intentional Const Override
+    Image *rim = (Image *)image;
+
+    // handle animations
+    if (anim)
+        rim = rim->animation_.current;
+
+    CachedImage *rc = ImageCacheOGL(rim, trans, do_whiten, mode);
+
+    EPI_ASSERT(rc->parent);
+
+    if (rc->is_pending)
+        return PlaceholderTexture(rim);
+
+    return rc->texture_id;
+}
+
 //
 // The top-level routine for caching in an image.  Mainly just a
 // switch to more specialised routines.
 //
 GLuint ImageCache(const Image *image, bool anim, const Colormap *trans, bool do_whiten)
+{
+    return ImageCacheInternal(image, anim, trans, do_whiten, kImageLoadDeferred);
+}
+
+GLuint ImageCacheAtlas(const Image *image, bool anim, float *tx1, float *ty1, float *tx2, float *ty2)
 {
     // Intentional Const Override
     Image *rim = (Image *)image;
@@ -1702,16 +2521,51 @@ GLuint ImageCache(const Image *image, bool anim, const Colormap *trans, bool do_
     if (anim)
         rim = rim->animation_.current;
 
-    CachedImage *rc = ImageCacheOGL(rim, trans, do_whiten);
+    CachedImage *rc = ImageCacheOGL(rim, nullptr, false, kImageLoadDeferred);
 
     EPI_ASSERT(rc->parent);
 
-    return rc->texture_id;
+    if (rc->is_pending)
+        return PlaceholderTexture(rim);
+
+    if (!image_atlas.d_)
+        return rc->texture_id;
+
+    if (rc->atlas_page < 0)
+    {
+        if (!rc->atlas_tried && IM_ShouldAtlas(rim))
+        {
+            rc->atlas_tried = true;
+            atlas_queue.push_back(rc);
+        }
+
+        return rc->texture_id;
+    }
+
+    // coordinates outside the image need wrapping, which only the image's
+    // own texture can do.
+    const float eps = 0.0001f;
+
+    if (HMM_MIN(*tx1, *tx2) < -eps || HMM_MAX(*tx1, *tx2) > rim->Right() + eps || HMM_MIN(*ty1, *ty2) < -eps ||
+        HMM_MAX(*ty1, *ty2) > rim->Top() + eps)
+        return rc->texture_id;
+
+    *tx1 = rc->atlas_x + *tx1 * rc->atlas_scale_x;
+    *tx2 = rc->atlas_x + *tx2 * rc->atlas_scale_x;
+    *ty1 = rc->atlas_y + *ty1 * rc->atlas_scale_y;
+    *ty2 = rc->atlas_y + *ty2 * rc->atlas_scale_y;
+
+    return atlas_pages[rc->atlas_page]->texture_id;
 }
 
 void ImagePrecache(const Image *image)
 {
-    ImageCache(image, false);
+    ImageLoadMode mode = precache_batch_active ? kImageLoadPrecache : kImageLoadNow;
+
+    if (precache_batch_active)
+        precache_batch_count++;
+
+    ImageCacheInternal(image, false, nullptr, false, mode);
 
     // Intentional Const Override
     Image *rim = (Image *)image;
@@ -1727,7 +2581,7 @@ void ImagePrecache(const Image *image)
         const Image *alt = ImageContainerLookupInternal(real_textures, epi::StringHash(alt_name));
 
         if (alt)
-            ImageCache(alt, false);
+            ImageCacheInternal(alt, false, nullptr, false, mode);
     }
 }
 
@@ -1789,6 +2643,11 @@ void AnimationTicker(void)
 
 void DeleteAllImages(bool shutdown)
 {
+    if (shutdown)
+        StopImageWorkers();
+    else
+        CancelImageJobs();
+
     std::list<CachedImage *>::iterator CI;
 
     for (CI = image_cache.begin(); CI != image_cache.end(); CI++)
@@ -1801,8 +2660,21 @@ void DeleteAllImages(bool shutdown)
             render_state->DeleteTexture(&rc->texture_id);
             rc->texture_id = 0;
         }
+
+        rc->atlas_page  = -1;
+        rc->atlas_tried = false;
+
+        delete rc->atlas_pixels;
+        rc->atlas_pixels = nullptr;
     }
 
+    DeleteAtlasPages();
+
+    if (placeholder_solid_texture != 0)
+        render_state->DeleteTexture(&placeholder_solid_texture);
+    if (placeholder_clear_texture != 0)
+        render_state->DeleteTexture(&placeholder_clear_texture);
+
     DeleteSkyTextures();
     DeleteColourmapTextures();
 
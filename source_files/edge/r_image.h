@@ -50,6 +50,23 @@ enum ImageOpacity
     kOpacityComplex = 3, // uses full range of alpha values
 };
 
+// the still-encoded bytes of a PNG/JPEG/TGA image, plus what is needed to
+// finish it off after decoding (see ReadAsEncodedBlock in r_doomtex.cc).
+struct EncodedImage
+{
+    std::vector<uint8_t> data;
+    std::string          name;
+
+    uint16_t actual_width  = 0;
+    uint16_t actual_height = 0;
+
+    // user defined images (DDF IMAGES.DDF entries) are finished
+    // differently to graphics found in wads and packages.
+    bool user_file = false;
+    bool is_font   = false;
+    bool blacken   = false;
+};
+
 class Image
 {
   public:
@@ -270,6 +287,15 @@ void CreateFallbackTexture(void);
 GLuint ImageCache(const Image *image, bool anim = true, const Colormap *trans = nullptr, bool do_whiten = false);
 void   ImagePrecache(const Image *image);
 
+// like ImageCache(), but small HUD graphics and sprites may be drawn from
+// a shared atlas page, in which case the texture coordinates (in the usual
+// 0..Right() and 0..Top() range) are remapped to it.
+GLuint ImageCacheAtlas(const Image *image, bool anim, float *tx1, float *ty1, float *tx2, float *ty2);
+
+void   ImageBeginPrecache(void);
+void   ImageFinishPrecache(void);
+void   ProcessImageUploads(void);
+
 // this only needed during initialisation -- r_things.cpp
 const Image **GetUserSprites(int *count);
 
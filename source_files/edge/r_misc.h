@@ -98,6 +98,12 @@ RegionProperties *GetViewPointProperties(Subsector *sub, float z);
 // Renders the view for the next frame.
 void RenderView(int x, int y, int w, int h, MapObject *camera, bool full_height, float expand_w);
 
+// Subsectors drawn by the last RenderView, and a hash of what they show
+// (heights, lighting, surfaces, things, and the sectors just behind
+// their two-sided lines) for callers caching the view.
+const std::vector<Subsector *> &RenderViewSubsectors(void);
+uint64_t                        SubsectorStateHash(const std::vector<Subsector *> &subsectors);
+
 // Called by startup code.
 void RendererStartup(void);
 // Called by shutdown code
@@ -106,5 +112,13 @@ void RendererShutdown(void);
 // Called during level shutdown
 void RendererShutdownLevel();
 
+// Called when a sector height changes outside of UpdateSectorInterpolation,
+// so cached wall geometry around that sector gets rebuilt.
+void InvalidateSectorGeometry(const Sector *sector);
+
+// Bumped by the above, by any interpolated height change and at level
+// shutdown; things cached from sector heights compare against it.
+uint32_t SectorGeometryGeneration(void);
+
 //--- editor settings ---
 // vi:ts=4:sw=4:noexpandtab
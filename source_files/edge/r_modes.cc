@@ -258,6 +258,8 @@ void SoftInitializeResolution(void)
     else
         current_font_size = 2;
 
+    hud_fonts.LoadTrueTypeSize(current_font_size);
+
     // -ES- 1999/08/29 Fixes the garbage palettes, and the blank 16-bit console
     SetPalette(kPaletteNormal, 0);
 
@@ -292,6 +294,8 @@ static bool DoExecuteChangeResolution(DisplayMode *mode)
     else
         current_font_size = 2;
 
+    hud_fonts.LoadTrueTypeSize(current_font_size);
+
     DeterminePixelAspect();
 
     return true;
@@ -18,9 +18,14 @@
 
 #include "r_occlude.h"
 
+#include <float.h>
+#include <math.h>
+#include <stdint.h>
+
 #include "ddf_types.h"
 #include "epi.h"
 #include "epi_bam.h"
+#include "r_state.h"
 
 // #define EDGE_DEBUG_OCCLUSION 1
 
@@ -37,6 +42,19 @@ static AngleRange *occlusion_buffer_tail = nullptr;
 
 static AngleRange *free_occlusion_range = nullptr;
 
+// Vertical coverage: the full circle is cut into equal columns (relative
+// to the view angle, like the ranges above), each keeping the lowest and
+// highest elevation still open behind the segs walked so far.
+static constexpr int kOcclusionColumnShift = 22;
+static constexpr int kOcclusionColumns     = 1 << (32 - kOcclusionColumnShift);
+
+static float occlusion_span_bottom[kOcclusionColumns];
+static float occlusion_span_top[kOcclusionColumns];
+
+// map-space direction of the ray along the right edge of each column
+// (the last one wraps round to the first)
+static HMM_Vec2 occlusion_column_edges[kOcclusionColumns + 1];
+
 #ifdef EDGE_DEBUG_OCCLUSION
 static void ValidateBuffer(void)
 {
@@ -87,6 +105,19 @@ void OcclusionClear(void)
         occlusion_buffer_tail = nullptr;
     }
 
+    for (int c = 0; c < kOcclusionColumns; c++)
+    {
+        occlusion_span_bottom[c] = -FLT_MAX;
+        occlusion_span_top[c]    = FLT_MAX;
+    }
+
+    for (int e = 0; e <= kOcclusionColumns; e++)
+    {
+        BAMAngle ang = view_angle + ((BAMAngle)e << kOcclusionColumnShift);
+
+        occlusion_column_edges[e] = {{epi::BAMCos(ang), epi::BAMSin(ang)}};
+    }
+
 #ifdef EDGE_DEBUG_OCCLUSION
     ValidateBuffer();
 #endif
@@ -253,5 +284,160 @@ bool OcclusionTest(BAMAngle low, BAMAngle high)
         return DoTest(low, kBAMAngle360) && DoTest(0, high);
 }
 
+static inline bool SpanClosed(int c)
+{
+    return occlusion_span_bottom[c] >= occlusion_span_top[c];
+}
+
+// Where the ray along column edge e meets the seg line: returns false if
+// it misses the seg, else the distance from the eye and the fraction
+// along the seg.
+static inline bool EdgeHitsSeg(int e, float x1, float y1, float dx, float dy, float &dist, float &along)
+{
+    const HMM_Vec2 &ray = occlusion_column_edges[e];
+
+    float denom = ray.X * dy - ray.Y * dx;
+
+    if (fabs(denom) < 0.0001f)
+        return false;
+
+    float ox = x1 - view_x;
+    float oy = y1 - view_y;
+
+    dist  = (ox * dy - oy * dx) / denom;
+    along = (ox * ray.Y - oy * ray.X) / denom;
+
+    return dist > 0 && along > -0.001f && along < 1.001f;
+}
+
+static void DoNarrow(BAMAngle low, BAMAngle high, float x1, float y1, float x2, float y2, float floor_h,
+                     float ceiling_h)
+{
+    // only columns which the seg covers from edge to edge
+    int first = (int)(((uint64_t)low + (1 << kOcclusionColumnShift) - 1) >> kOcclusionColumnShift);
+    int last  = (int)((((uint64_t)high + 1) >> kOcclusionColumnShift) - 1);
+
+    float dx = x2 - x1;
+    float dy = y2 - y1;
+
+    float length_sq = dx * dx + dy * dy;
+
+    if (first > last || length_sq < 1.0f)
+        return;
+
+    // nearest point of the seg line to the eye, for columns containing it
+    float foot_along = ((view_x - x1) * dx + (view_y - y1) * dy) / length_sq;
+    float foot_dist  = fabs((view_x - x1) * dy - (view_y - y1) * dx) / sqrtf(length_sq);
+
+    int closed_from = -1;
+
+    for (int c = first; c <= last + 1; c++)
+    {
+        if (c <= last && !SpanClosed(c))
+        {
+            float near_d, far_d, along_0, along_1;
+
+            if (EdgeHitsSeg(c, x1, y1, dx, dy, near_d, along_0) && EdgeHitsSeg(c + 1, x1, y1, dx, dy, far_d, along_1))
+            {
+                if (near_d > far_d)
+                {
+                    float tmp = near_d;
+                    near_d    = far_d;
+                    far_d     = tmp;
+                }
+
+                if ((foot_along - along_0) * (foot_along - along_1) < 0)
+                    near_d = foot_dist;
+
+                if (near_d > 0.01f)
+                {
+                    if (ceiling_h < FLT_MAX)
+                    {
+                        float top = (ceiling_h - view_z) / (ceiling_h > view_z ? near_d : far_d);
+
+                        occlusion_span_top[c] = HMM_MIN(occlusion_span_top[c], top);
+                    }
+
+                    if (floor_h > -FLT_MAX)
+                    {
+                        float bottom = (floor_h - view_z) / (floor_h > view_z ? far_d : near_d);
+
+                        occlusion_span_bottom[c] = HMM_MAX(occlusion_span_bottom[c], bottom);
+                    }
+
+                    if (SpanClosed(c))
+                    {
+                        if (closed_from < 0)
+                            closed_from = c;
+                        continue;
+                    }
+                }
+            }
+        }
+
+        // a run of freshly closed columns has ended
+        if (closed_from >= 0)
+        {
+            DoSet((BAMAngle)closed_from << kOcclusionColumnShift, ((BAMAngle)c << kOcclusionColumnShift) - 1);
+            closed_from = -1;
+        }
+    }
+}
+
+void OcclusionNarrow(BAMAngle low, BAMAngle high, float x1, float y1, float x2, float y2, float floor_h,
+                     float ceiling_h)
+{
+    // Angles are relative to the VIEW angle, (x1,y1) is at the left end
+    // of the seg as seen from the eye.
+
+    EPI_ASSERT((BAMAngle)(high - low) < kBAMAngle180);
+
+    if (low <= high)
+        DoNarrow(low, high, x1, y1, x2, y2, floor_h, ceiling_h);
+    else
+    {
+        DoNarrow(low, kBAMAngle360, x1, y1, x2, y2, floor_h, ceiling_h);
+        DoNarrow(0, high, x1, y1, x2, y2, floor_h, ceiling_h);
+    }
+
+#ifdef EDGE_DEBUG_OCCLUSION
+    ValidateBuffer();
+#endif
+}
+
+static bool DoTestSpans(BAMAngle low, BAMAngle high, float bottom, float top)
+{
+    int first = (int)(low >> kOcclusionColumnShift);
+    int last  = (int)(high >> kOcclusionColumnShift);
+
+    for (int c = first; c <= last; c++)
+    {
+        if (bottom <= occlusion_span_top[c] && top >= occlusion_span_bottom[c])
+            return false;
+    }
+
+    return true;
+}
+
+bool OcclusionTestSpans(BAMAngle low, BAMAngle high, float near_dist, float far_dist, float floor_h,
+                        float ceiling_h)
+{
+    // Returns true if the whole volume is hidden.
+
+    EPI_ASSERT((BAMAngle)(high - low) < kBAMAngle180);
+
+    if (near_dist < 1.0f || floor_h <= -FLT_MAX || ceiling_h >= FLT_MAX)
+        return false;
+
+    // widest elevations the volume can reach over its distances
+    float top    = (ceiling_h - view_z) / (ceiling_h > view_z ? near_dist : far_dist);
+    float bottom = (floor_h - view_z) / (floor_h > view_z ? far_dist : near_dist);
+
+    if (low <= high)
+        return DoTestSpans(low, high, bottom, top);
+    else
+        return DoTestSpans(low, kBAMAngle360, bottom, top) && DoTestSpans(0, high, bottom, top);
+}
+
 //--- editor settings ---
 // vi:ts=4:sw=4:noexpandtab
\ No newline at end of file
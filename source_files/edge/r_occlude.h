@@ -24,5 +24,22 @@ void OcclusionClear(void);
 void OcclusionSet(BAMAngle low, BAMAngle high);
 bool OcclusionTest(BAMAngle low, BAMAngle high);
 
+// Vertical coverage.  Each column of the view keeps the window of
+// elevations (height above the eye over horizontal distance) which is
+// still open behind everything walked so far.  Heights are in map units;
+// pass -FLT_MAX / FLT_MAX when a side doesn't close anything.
+
+// Narrows the window of the columns which the seg (x1,y1)-(x2,y2) fully
+// covers between low and high.  Columns which close up completely are
+// set in the angular buffer too.
+void OcclusionNarrow(BAMAngle low, BAMAngle high, float x1, float y1, float x2, float y2, float floor_h,
+                     float ceiling_h);
+
+// Returns true if a volume spanning the given angles, between near_dist
+// and far_dist from the eye and floor_h to ceiling_h in height, falls
+// outside the window of every column it touches.
+bool OcclusionTestSpans(BAMAngle low, BAMAngle high, float near_dist, float far_dist, float floor_h,
+                        float ceiling_h);
+
 //--- editor settings ---
 // vi:ts=4:sw=4:noexpandtab
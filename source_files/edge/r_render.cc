@@ -26,6 +26,7 @@
 #include "r_render.h"
 
 #include <math.h>
+#include <string.h>
 
 #include <unordered_map>
 #include <unordered_set>
@@ -77,6 +78,8 @@ static Seg           *current_seg;
 extern unsigned int root_node;
 
 EDGE_DEFINE_CONSOLE_VARIABLE(force_flat_lighting, "0", kConsoleVariableFlagArchive)
+EDGE_DEFINE_CONSOLE_VARIABLE(renderer_cache_geometry, "1", kConsoleVariableFlagArchive)
+EDGE_DEFINE_CONSOLE_VARIABLE(renderer_sky_background, "1", kConsoleVariableFlagArchive)
 
 bool solid_mode;
 int  detail_level       = 1;
@@ -134,10 +137,171 @@ static float Slope_GetHeight(SlopePlane *slope, float x, float y)
     return slope->delta_z1 + along * (slope->delta_z2 - slope->delta_z1);
 }
 
+//
+// Level geometry cache.
+//
+// Most walls and flats come out the same from one frame to the next, so
+// their finished positions and texture coordinates are kept here and
+// only rebuilt when something they were made from has changed: the
+// heights, offsets, scale or image size of the surface, or (for walls,
+// whose edges GreetNeighbourSector splits at the neighbouring heights)
+// the height of any sector around the seg.  Sloped planes are not
+// cached.  Anything which depends on the view, like the colormap
+// distance and dynamic lights, is still worked out by the shaders
+// every frame.
+//
+struct WallGeometryKey
+{
+    float    lz1, lz2, rz1, rz2;
+    float    tx0, tx_mul, ty0, ty_mul;
+    uint32_t height_generation; // zero when not split at neighbours
+};
+
+struct WallGeometry
+{
+    WallGeometryKey key;
+
+    int first    = -1; // in wall_geometry_vertices, -1 until first built
+    int capacity = 0;
+    int count    = 0;
+};
+
+struct PlaneGeometryKey
+{
+    float    h;
+    float    tx0, ty0;
+    float    image_w, image_h;
+    HMM_Vec2 x_mat, y_mat;
+    BAMAngle rotation;
+};
+
+struct PlaneGeometry
+{
+    PlaneGeometryKey key;
+
+    int   first = 0; // in plane_geometry_vertices, room for the subsector
+    int   count = 0; // zero until first built
+    float bbox[4];
+};
+
+// three per seg (top, middle and bottom of its sidedef)
+static std::vector<WallGeometry> wall_geometry;
+static std::vector<HMM_Vec3>     wall_geometry_vertices;
+static std::vector<HMM_Vec2>     wall_geometry_texcoords;
+
+// two per subsector (floor, ceiling)
+static std::vector<PlaneGeometry> plane_geometry;
+static std::vector<HMM_Vec3>      plane_geometry_vertices;
+static std::vector<HMM_Vec2>      plane_geometry_texcoords;
+
+// bumped whenever the interpolated height of any sector changes
+static uint32_t sector_height_generation = 1;
+
+// and per sector, which is what the walls are keyed on
+static std::vector<uint32_t> sector_height_generations;
+
+static inline bool SameWallGeometry(const WallGeometryKey &A, const WallGeometryKey &B)
+{
+    return A.lz1 == B.lz1 && A.lz2 == B.lz2 && A.rz1 == B.rz1 && A.rz2 == B.rz2 && A.tx0 == B.tx0 &&
+           A.tx_mul == B.tx_mul && A.ty0 == B.ty0 && A.ty_mul == B.ty_mul &&
+           A.height_generation == B.height_generation;
+}
+
+static inline bool SamePlaneGeometry(const PlaneGeometryKey &A, const PlaneGeometryKey &B)
+{
+    return A.h == B.h && A.tx0 == B.tx0 && A.ty0 == B.ty0 && A.image_w == B.image_w && A.image_h == B.image_h &&
+           A.x_mat.X == B.x_mat.X && A.x_mat.Y == B.x_mat.Y && A.y_mat.X == B.y_mat.X && A.y_mat.Y == B.y_mat.Y &&
+           A.rotation == B.rotation;
+}
+
+static void BeginGeometryCache(void)
+{
+    if (!plane_geometry.empty() || total_level_subsectors == 0)
+        return;
+
+    wall_geometry.resize(total_level_segs * 3);
+
+    sector_height_generations.assign(total_level_sectors, 1);
+
+    plane_geometry.resize(total_level_subsectors * 2);
+
+    int total = 0;
+
+    for (int i = 0; i < total_level_subsectors; i++)
+    {
+        int num_vert = 0;
+
+        for (Seg *seg = level_subsectors[i].segs; seg && num_vert < kMaximumPolygonVertices; seg = seg->subsector_next)
+            num_vert++;
+
+        plane_geometry[i * 2 + 0].first = total;
+        plane_geometry[i * 2 + 1].first = total + num_vert;
+
+        total += num_vert * 2;
+    }
+
+    plane_geometry_vertices.resize(total);
+    plane_geometry_texcoords.resize(total);
+}
+
+static void ShutdownGeometryCache(void)
+{
+    wall_geometry.clear();
+    wall_geometry_vertices.clear();
+    wall_geometry_texcoords.clear();
+
+    plane_geometry.clear();
+    plane_geometry_vertices.clear();
+    plane_geometry_texcoords.clear();
+
+    sector_height_generations.clear();
+
+    // the next level's nodes and heights are all new
+    sector_height_generation++;
+}
+
+void InvalidateSectorGeometry(const Sector *sector)
+{
+    sector_height_generation++;
+
+    size_t index = sector - level_sectors;
+
+    if (index < sector_height_generations.size())
+        sector_height_generations[index]++;
+}
+
+// Sum of the generations of every sector whose heights a wall on this
+// seg is made from.  They only ever go up, so the sum changes whenever
+// any one of them does.
+static uint32_t WallHeightGeneration(const Seg *seg)
+{
+    uint32_t generation = sector_height_generations[seg->front_sector - level_sectors];
+
+    if (seg->back_sector)
+        generation += sector_height_generations[seg->back_sector - level_sectors];
+
+    for (const VertexSectorList *seclist : seg->vertex_sectors)
+    {
+        if (!seclist)
+            continue;
+
+        for (int k = 0; k < seclist->total; k++)
+            generation += sector_height_generations[seclist->sectors[k]];
+    }
+
+    return generation;
+}
+
+uint32_t SectorGeometryGeneration(void)
+{
+    return sector_height_generation;
+}
+
 struct WallCoordinateData
 {
     int             v_count;
     const HMM_Vec3 *vertices;
+    const HMM_Vec2 *texcoords;
 
     GLuint tex_id;
 
@@ -167,28 +331,36 @@ static void WallCoordFunc(void *d, int v_idx, HMM_Vec3 *pos, RGBAColor *rgb, HMM
     *rgb    = epi::MakeRGBA((uint8_t)(data->R * render_view_red_multiplier),
                             (uint8_t)(data->G * render_view_green_multiplier),
                             (uint8_t)(data->B * render_view_blue_multiplier), epi::GetRGBAAlpha(*rgb));
+    *texc   = data->texcoords[v_idx];
+
+    *lit_pos = *pos;
+}
 
-    float along;
+static void WallTextureCoordinates(const WallCoordinateData *data, HMM_Vec2 *texcoords)
+{
+    bool use_x = fabs(data->div.delta_x) > fabs(data->div.delta_y);
 
-    if (fabs(data->div.delta_x) > fabs(data->div.delta_y))
+    for (int v_idx = 0; v_idx < data->v_count; v_idx++)
     {
-        along = (pos->X - data->div.x) / data->div.delta_x;
-    }
-    else
-    {
-        along = (pos->Y - data->div.y) / data->div.delta_y;
-    }
+        const HMM_Vec3 *pos = &data->vertices[v_idx];
 
-    texc->X = data->tx0 + along * data->tx_mul;
-    texc->Y = data->ty0 + pos->Z * data->ty_mul;
+        float along;
 
-    *lit_pos = *pos;
+        if (use_x)
+            along = (pos->X - data->div.x) / data->div.delta_x;
+        else
+            along = (pos->Y - data->div.y) / data->div.delta_y;
+
+        texcoords[v_idx].X = data->tx0 + along * data->tx_mul;
+        texcoords[v_idx].Y = data->ty0 + pos->Z * data->ty_mul;
+    }
 }
 
 struct PlaneCoordinateData
 {
     int             v_count;
     const HMM_Vec3 *vertices;
+    const HMM_Vec2 *texcoords;
 
     GLuint tex_id;
 
@@ -198,20 +370,12 @@ struct PlaneCoordinateData
     float R, G, B;
     float trans;
 
-    float tx0, ty0;
-    float image_w, image_h;
-
-    HMM_Vec2 x_mat;
-    HMM_Vec2 y_mat;
-
     HMM_Vec3 normal;
 
     // multiplier for plane_z_bob
     float bob_amount = 0;
 
     SlopePlane *slope;
-
-    BAMAngle rotation = 0;
 };
 
 static void PlaneCoordFunc(void *d, int v_idx, HMM_Vec3 *pos, RGBAColor *rgb, HMM_Vec2 *texc, HMM_Vec3 *normal,
@@ -224,17 +388,7 @@ static void PlaneCoordFunc(void *d, int v_idx, HMM_Vec3 *pos, RGBAColor *rgb, HM
     *rgb    = epi::MakeRGBA((uint8_t)(data->R * render_view_red_multiplier),
                             (uint8_t)(data->G * render_view_green_multiplier),
                             (uint8_t)(data->B * render_view_blue_multiplier), epi::GetRGBAAlpha(*rgb));
-
-    HMM_Vec2 rxy = {{(data->tx0 + pos->X), (data->ty0 + pos->Y)}};
-
-    if (data->rotation)
-        rxy = HMM_RotateV2(rxy, epi::RadiansFromBAM(data->rotation));
-
-    rxy.X /= data->image_w;
-    rxy.Y /= data->image_h;
-
-    texc->X = rxy.X * data->x_mat.X + rxy.Y * data->x_mat.Y;
-    texc->Y = rxy.X * data->y_mat.X + rxy.Y * data->y_mat.Y;
+    *texc   = data->texcoords[v_idx];
 
     if (data->bob_amount > 0)
         pos->Z += (plane_z_bob * data->bob_amount);
@@ -377,7 +531,7 @@ enum WallTileFlag
 
 static void DrawWallPart(DrawFloor *dfloor, float x1, float y1, float lz1, float lz2, float x2, float y2, float rz1,
                          float rz2, float tex_top_h, MapSurface *surf, const Image *image, bool mid_masked, bool opaque,
-                         float tex_x1, float tex_x2, RegionProperties *props = nullptr)
+                         float tex_x1, float tex_x2, RegionProperties *props = nullptr, int geometry_slot = -1)
 {
     // Note: tex_x1 and tex_x2 are in world coordinates.
     //       top, bottom and tex_top_h as well.
@@ -448,46 +602,6 @@ static void DrawWallPart(DrawFloor *dfloor, float x1, float y1, float lz1, float
     LogDebug("WALL (%d,%d,%d) -> (%d,%d,%d)\n", (int)x1, (int)y1, (int)top, (int)x2, (int)y2, (int)bottom);
 #endif
 
-    // -AJA- 2007/08/07: ugly code here ensures polygon edges
-    //       match up with adjacent linedefs (otherwise small
-    //       gaps can appear which look bad).
-
-    float left_h[kMaximumEdgeVertices];
-    int   left_num = 2;
-    float right_h[kMaximumEdgeVertices];
-    int   right_num = 2;
-
-    left_h[0]  = lz1;
-    left_h[1]  = lz2;
-    right_h[0] = rz1;
-    right_h[1] = rz2;
-
-    if (solid_mode && !mid_masked)
-    {
-        GreetNeighbourSector(left_h, left_num, current_seg->vertex_sectors[0]);
-        GreetNeighbourSector(right_h, right_num, current_seg->vertex_sectors[1]);
-    }
-
-    HMM_Vec3 vertices[kMaximumEdgeVertices * 2];
-
-    int v_count = 0;
-
-    for (int LI = 0; LI < left_num; LI++)
-    {
-        vertices[v_count].X = x1;
-        vertices[v_count].Y = y1;
-        vertices[v_count].Z = left_h[LI];
-        v_count++;
-    }
-
-    for (int RI = right_num - 1; RI >= 0; RI--)
-    {
-        vertices[v_count].X = x2;
-        vertices[v_count].Y = y2;
-        vertices[v_count].Z = right_h[RI];
-        v_count++;
-    }
-
     // -AJA- 2006-06-22: fix for midmask wrapping bug
     if (mid_masked &&
         (!current_seg->linedef->special || AlmostEquals(current_seg->linedef->special->s_yspeed_,
@@ -496,8 +610,7 @@ static void DrawWallPart(DrawFloor *dfloor, float x1, float y1, float lz1, float
 
     WallCoordinateData data;
 
-    data.v_count  = v_count;
-    data.vertices = vertices;
+    data.vertices = nullptr;
 
     data.R = data.G = data.B = 255;
 
@@ -513,6 +626,105 @@ static void DrawWallPart(DrawFloor *dfloor, float x1, float y1, float lz1, float
 
     data.normal = {{(y2 - y1), (x1 - x2), 0}};
 
+    bool greet_neighbours = solid_mode && !mid_masked;
+
+    WallGeometry *geometry = nullptr;
+
+    if (geometry_slot >= 0 && renderer_cache_geometry.d_)
+    {
+        WallGeometryKey key;
+
+        key.lz1               = lz1;
+        key.lz2               = lz2;
+        key.rz1               = rz1;
+        key.rz2               = rz2;
+        key.tx0               = tx0;
+        key.tx_mul            = tx_mul;
+        key.ty0               = ty0;
+        key.ty_mul            = ty_mul;
+        key.height_generation = greet_neighbours ? WallHeightGeneration(current_seg) : 0;
+
+        geometry = &wall_geometry[(current_seg - level_segs) * 3 + geometry_slot];
+
+        if (geometry->first >= 0 && SameWallGeometry(geometry->key, key))
+        {
+            data.v_count   = geometry->count;
+            data.vertices  = &wall_geometry_vertices[geometry->first];
+            data.texcoords = &wall_geometry_texcoords[geometry->first];
+        }
+        else
+        {
+            if (geometry->capacity == 0)
+            {
+                geometry->first    = (int)wall_geometry_vertices.size();
+                geometry->capacity = kMaximumEdgeVertices * 2;
+
+                wall_geometry_vertices.resize(geometry->first + geometry->capacity);
+                wall_geometry_texcoords.resize(geometry->first + geometry->capacity);
+            }
+
+            geometry->key = key;
+        }
+    }
+
+    HMM_Vec3 vertices[kMaximumEdgeVertices * 2];
+    HMM_Vec2 texcoords[kMaximumEdgeVertices * 2];
+
+    if (!data.vertices)
+    {
+        // -AJA- 2007/08/07: ugly code here ensures polygon edges
+        //       match up with adjacent linedefs (otherwise small
+        //       gaps can appear which look bad).
+
+        float left_h[kMaximumEdgeVertices];
+        int   left_num = 2;
+        float right_h[kMaximumEdgeVertices];
+        int   right_num = 2;
+
+        left_h[0]  = lz1;
+        left_h[1]  = lz2;
+        right_h[0] = rz1;
+        right_h[1] = rz2;
+
+        if (greet_neighbours)
+        {
+            GreetNeighbourSector(left_h, left_num, current_seg->vertex_sectors[0]);
+            GreetNeighbourSector(right_h, right_num, current_seg->vertex_sectors[1]);
+        }
+
+        int v_count = 0;
+
+        for (int LI = 0; LI < left_num; LI++)
+        {
+            vertices[v_count].X = x1;
+            vertices[v_count].Y = y1;
+            vertices[v_count].Z = left_h[LI];
+            v_count++;
+        }
+
+        for (int RI = right_num - 1; RI >= 0; RI--)
+        {
+            vertices[v_count].X = x2;
+            vertices[v_count].Y = y2;
+            vertices[v_count].Z = right_h[RI];
+            v_count++;
+        }
+
+        data.v_count   = v_count;
+        data.vertices  = vertices;
+        data.texcoords = texcoords;
+
+        WallTextureCoordinates(&data, texcoords);
+
+        if (geometry)
+        {
+            std::copy(vertices, vertices + v_count, wall_geometry_vertices.begin() + geometry->first);
+            std::copy(texcoords, texcoords + v_count, wall_geometry_texcoords.begin() + geometry->first);
+
+            geometry->count = v_count;
+        }
+    }
+
     data.tex_id     = tex_id;
     data.pass       = 0;
     data.blending   = blending;
@@ -790,9 +1002,19 @@ static void DrawTile(Seg *seg, DrawFloor *dfloor, float lz1, float lz2, float rz
         rz2 += seg->sidedef->sector->properties.special->ceiling_bob_;
     }
 
+    // which of the sidedef's parts this is, for the geometry cache
+    int geometry_slot = -1;
+
+    if (surf == &seg->sidedef->top)
+        geometry_slot = 0;
+    else if (surf == &seg->sidedef->middle)
+        geometry_slot = 1;
+    else if (surf == &seg->sidedef->bottom)
+        geometry_slot = 2;
+
     DrawWallPart(dfloor, x1, y1, lz1, lz2, x2, y2, rz1, rz2, tex_top_h, surf, image,
                  (flags & kWallTileMidMask) ? true : false, opaque, tex_x1, tex_x2,
-                 (flags & kWallTileMidMask) ? &seg->sidedef->sector->properties : nullptr);
+                 (flags & kWallTileMidMask) ? &seg->sidedef->sector->properties : nullptr, geometry_slot);
 }
 
 static inline void AddWallTile(Seg *seg, DrawFloor *dfloor, MapSurface *surf, float z1, float z2, float tex_z,
@@ -1354,92 +1576,154 @@ static void RenderPlane(DrawFloor *dfloor, float h, MapSurface *surf, int face_d
         return;
     }
 
-    // count number of actual vertices
-    Seg *seg;
-    for (seg = current_subsector->segs, num_vert = 0; seg; seg = seg->subsector_next, num_vert++)
-    {
-        /* no other code needed */
-    }
+    float tx0, ty0;
 
-    // -AJA- make sure polygon has enough vertices.  Sometimes a subsector
-    // ends up with only 1 or 2 segs due to level problems (e.g. MAP22).
-    if (num_vert < 3)
-        return;
+    if (!AlmostEquals(surf->old_offset.X, surf->offset.X) && !console_active && !paused && !menu_active &&
+        !time_stop_active && !erraticism_active)
+        tx0 = fmod(HMM_Lerp(surf->old_offset.X, fractional_tic, surf->offset.X), surf->image->actual_width_);
+    else
+        tx0 = surf->offset.X;
+    if (!AlmostEquals(surf->old_offset.Y, surf->offset.Y) && !console_active && !paused && !menu_active &&
+        !time_stop_active && !erraticism_active)
+        ty0 = fmod(HMM_Lerp(surf->old_offset.Y, fractional_tic, surf->offset.Y), surf->image->actual_height_);
+    else
+        ty0 = surf->offset.Y;
 
-    if (num_vert > kMaximumPolygonVertices)
-        num_vert = kMaximumPolygonVertices;
+    PlaneCoordinateData data;
 
-    HMM_Vec3 vertices[kMaximumPolygonVertices];
+    data.vertices = nullptr;
 
     float v_bbox[4];
 
-    BoundingBoxClear(v_bbox);
+    PlaneGeometry *geometry = nullptr;
+
+    if (!slope && renderer_cache_geometry.d_)
+    {
+        PlaneGeometryKey key;
+
+        key.h        = orig_h;
+        key.tx0      = tx0;
+        key.ty0      = ty0;
+        key.image_w  = surf->image->ScaledWidthActual();
+        key.image_h  = surf->image->ScaledHeightActual();
+        key.x_mat    = surf->x_matrix;
+        key.y_mat    = surf->y_matrix;
+        key.rotation = surf->rotation;
 
-    int v_count = 0;
+        geometry = &plane_geometry[(current_subsector - level_subsectors) * 2 + (face_dir > 0 ? 0 : 1)];
 
-    for (seg = current_subsector->segs, i = 0; seg && (i < kMaximumPolygonVertices); seg = seg->subsector_next, i++)
+        if (geometry->count > 0 && SamePlaneGeometry(geometry->key, key))
+        {
+            data.v_count   = geometry->count;
+            data.vertices  = &plane_geometry_vertices[geometry->first];
+            data.texcoords = &plane_geometry_texcoords[geometry->first];
+
+            std::copy(geometry->bbox, geometry->bbox + 4, v_bbox);
+        }
+        else
+            geometry->key = key;
+    }
+
+    HMM_Vec3 vertices[kMaximumPolygonVertices];
+    HMM_Vec2 texcoords[kMaximumPolygonVertices];
+
+    if (!data.vertices)
     {
-        if (v_count < kMaximumPolygonVertices)
+        // count number of actual vertices
+        Seg *seg;
+        for (seg = current_subsector->segs, num_vert = 0; seg; seg = seg->subsector_next, num_vert++)
         {
-            float x = seg->vertex_1->X;
-            float y = seg->vertex_1->Y;
-            float z = h;
+            /* no other code needed */
+        }
 
-            BoundingBoxAddPoint(v_bbox, x, y);
+        // -AJA- make sure polygon has enough vertices.  Sometimes a subsector
+        // ends up with only 1 or 2 segs due to level problems (e.g. MAP22).
+        if (num_vert < 3)
+            return;
 
-            if (current_subsector->sector->floor_vertex_slope && face_dir > 0)
-            {
-                // floor - check vertex heights
-                if (seg->vertex_1->Z < 32767.0f && seg->vertex_1->Z > -32768.0f)
-                    z = seg->vertex_1->Z;
-            }
+        if (num_vert > kMaximumPolygonVertices)
+            num_vert = kMaximumPolygonVertices;
 
-            if (current_subsector->sector->ceiling_vertex_slope && face_dir < 0)
-            {
-                // ceiling - check vertex heights
-                if (seg->vertex_1->W < 32767.0f && seg->vertex_1->W > -32768.0f)
-                    z = seg->vertex_1->W;
-            }
+        BoundingBoxClear(v_bbox);
+
+        int v_count = 0;
 
-            if (slope)
+        for (seg = current_subsector->segs, i = 0; seg && (i < kMaximumPolygonVertices);
+             seg = seg->subsector_next, i++)
+        {
+            if (v_count < kMaximumPolygonVertices)
             {
-                z = orig_h + Slope_GetHeight(slope, x, y);
+                float x = seg->vertex_1->X;
+                float y = seg->vertex_1->Y;
+                float z = h;
+
+                BoundingBoxAddPoint(v_bbox, x, y);
+
+                if (current_subsector->sector->floor_vertex_slope && face_dir > 0)
+                {
+                    // floor - check vertex heights
+                    if (seg->vertex_1->Z < 32767.0f && seg->vertex_1->Z > -32768.0f)
+                        z = seg->vertex_1->Z;
+                }
+
+                if (current_subsector->sector->ceiling_vertex_slope && face_dir < 0)
+                {
+                    // ceiling - check vertex heights
+                    if (seg->vertex_1->W < 32767.0f && seg->vertex_1->W > -32768.0f)
+                        z = seg->vertex_1->W;
+                }
+
+                if (slope)
+                {
+                    z = orig_h + Slope_GetHeight(slope, x, y);
+                }
+
+                vertices[v_count].X = x;
+                vertices[v_count].Y = y;
+                vertices[v_count].Z = z;
+
+                v_count++;
             }
+        }
 
-            vertices[v_count].X = x;
-            vertices[v_count].Y = y;
-            vertices[v_count].Z = z;
+        float image_w = surf->image->ScaledWidthActual();
+        float image_h = surf->image->ScaledHeightActual();
 
-            v_count++;
+        for (int v_idx = 0; v_idx < v_count; v_idx++)
+        {
+            HMM_Vec2 rxy = {{(tx0 + vertices[v_idx].X), (ty0 + vertices[v_idx].Y)}};
+
+            if (surf->rotation)
+                rxy = HMM_RotateV2(rxy, epi::RadiansFromBAM(surf->rotation));
+
+            rxy.X /= image_w;
+            rxy.Y /= image_h;
+
+            texcoords[v_idx].X = rxy.X * surf->x_matrix.X + rxy.Y * surf->x_matrix.Y;
+            texcoords[v_idx].Y = rxy.X * surf->y_matrix.X + rxy.Y * surf->y_matrix.Y;
         }
-    }
 
-    PlaneCoordinateData data;
+        data.v_count   = v_count;
+        data.vertices  = vertices;
+        data.texcoords = texcoords;
+
+        if (geometry)
+        {
+            std::copy(vertices, vertices + v_count, plane_geometry_vertices.begin() + geometry->first);
+            std::copy(texcoords, texcoords + v_count, plane_geometry_texcoords.begin() + geometry->first);
+            std::copy(v_bbox, v_bbox + 4, geometry->bbox);
+
+            geometry->count = v_count;
+        }
+    }
 
-    data.v_count  = v_count;
-    data.vertices = vertices;
     data.R = data.G = data.B = 255;
-    if (!AlmostEquals(surf->old_offset.X, surf->offset.X) && !console_active && !paused && !menu_active &&
-        !time_stop_active && !erraticism_active)
-        data.tx0 = fmod(HMM_Lerp(surf->old_offset.X, fractional_tic, surf->offset.X), surf->image->actual_width_);
-    else
-        data.tx0 = surf->offset.X;
-    if (!AlmostEquals(surf->old_offset.Y, surf->offset.Y) && !console_active && !paused && !menu_active &&
-        !time_stop_active && !erraticism_active)
-        data.ty0 = fmod(HMM_Lerp(surf->old_offset.Y, fractional_tic, surf->offset.Y), surf->image->actual_height_);
-    else
-        data.ty0 = surf->offset.Y;
-    data.image_w  = surf->image->ScaledWidthActual();
-    data.image_h  = surf->image->ScaledHeightActual();
-    data.x_mat    = surf->x_matrix;
-    data.y_mat    = surf->y_matrix;
     data.normal   = {{0, 0, (view_z > h) ? 1.0f : -1.0f}};
     data.tex_id   = tex_id;
     data.pass     = 0;
     data.blending = blending;
     data.trans    = trans;
     data.slope    = slope;
-    data.rotation = surf->rotation;
 
     if (current_subsector->sector->properties.special)
     {
@@ -1688,6 +1972,110 @@ static void InitializeCamera(MapObject *mo, bool full_height, float expand_w)
 
 // Render world index, the root world render is 0
 static int32_t render_world_index = 0;
+
+// Subsectors drawn by the last RenderView, so a cached view can tell
+// whether anything it showed has changed since.
+static std::vector<Subsector *> view_subsectors;
+
+const std::vector<Subsector *> &RenderViewSubsectors(void)
+{
+    return view_subsectors;
+}
+
+static inline void HashBits(uint64_t &hash, uint64_t value)
+{
+    // FNV-1a, a word at a time
+    hash = (hash ^ value) * 0x100000001B3ULL;
+}
+
+static inline void HashFloat(uint64_t &hash, float value)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+
+    HashBits(hash, bits);
+}
+
+static inline void HashPointer(uint64_t &hash, const void *ptr)
+{
+    HashBits(hash, (uint64_t)(uintptr_t)ptr);
+}
+
+static void HashSurface(uint64_t &hash, const MapSurface &surf)
+{
+    HashPointer(hash, surf.image ? surf.image->animation_.current : nullptr);
+    HashFloat(hash, surf.translucency);
+    HashFloat(hash, surf.offset.X);
+    HashFloat(hash, surf.offset.Y);
+    HashPointer(hash, surf.override_properties);
+}
+
+uint64_t SubsectorStateHash(const std::vector<Subsector *> &subsectors)
+{
+    uint64_t hash = 0xCBF29CE484222325ULL;
+
+    HashPointer(hash, sky_image ? sky_image->animation_.current : nullptr);
+
+    for (const Subsector *sub : subsectors)
+    {
+        const Sector *sec = sub->sector;
+
+        HashPointer(hash, sub);
+        HashFloat(hash, sec->interpolated_floor_height);
+        HashFloat(hash, sec->interpolated_ceiling_height);
+        HashPointer(hash, sec->active_properties);
+        HashBits(hash, (uint32_t)sec->active_properties->light_level);
+        HashPointer(hash, sec->active_properties->colourmap);
+        HashSurface(hash, sec->floor);
+        HashSurface(hash, sec->ceiling);
+
+        for (const Seg *seg = sub->segs; seg; seg = seg->subsector_next)
+        {
+            if (!seg->sidedef)
+                continue;
+
+            HashSurface(hash, seg->sidedef->top);
+            HashSurface(hash, seg->sidedef->middle);
+            HashSurface(hash, seg->sidedef->bottom);
+
+            // the sector behind was not drawn when (say) a closed door
+            // hid it, but opening the door must still change the hash.
+            const Sector *back = seg->back_sector;
+
+            if (!back)
+                continue;
+
+            HashFloat(hash, back->interpolated_floor_height);
+            HashFloat(hash, back->interpolated_ceiling_height);
+            HashBits(hash, (uint32_t)back->active_properties->light_level);
+            HashSurface(hash, back->floor);
+            HashSurface(hash, back->ceiling);
+
+            const Side *back_side = seg->linedef->side[seg->side ^ 1];
+
+            if (back_side)
+            {
+                HashSurface(hash, back_side->top);
+                HashSurface(hash, back_side->middle);
+                HashSurface(hash, back_side->bottom);
+            }
+        }
+
+        for (const MapObject *mo = sub->thing_list; mo; mo = mo->subsector_next_)
+        {
+            HashPointer(hash, mo);
+            HashFloat(hash, mo->x);
+            HashFloat(hash, mo->y);
+            HashFloat(hash, mo->z);
+            HashBits(hash, mo->angle_);
+            HashPointer(hash, mo->state_);
+            HashBits(hash, (uint32_t)mo->flags_);
+            HashFloat(hash, mo->visibility_);
+        }
+    }
+
+    return hash;
+}
 void           RendererEndFrame()
 {
     render_world_index = 0;
@@ -1697,10 +2085,14 @@ void RendererShutdownLevel()
 {
     deferred_sky_items.clear();
     ShutdownSky();
+    ShutdownGeometryCache();
 }
 
 void UpdateSectorInterpolation(Sector *sector)
 {
+    float old_floor   = sector->interpolated_floor_height;
+    float old_ceiling = sector->interpolated_ceiling_height;
+
     if (!time_stop_active && !console_active && !paused && !erraticism_active && !menu_active && !rts_menu_active)
     {
         // Interpolate between current and last floor/ceiling position.
@@ -1720,6 +2112,9 @@ void UpdateSectorInterpolation(Sector *sector)
         sector->interpolated_floor_height   = sector->floor_height;
         sector->interpolated_ceiling_height = sector->ceiling_height;
     }
+
+    if (sector->interpolated_floor_height != old_floor || sector->interpolated_ceiling_height != old_ceiling)
+        InvalidateSectorGeometry(sector);
 }
 
 //
@@ -1732,12 +2127,15 @@ void UpdateSectorInterpolation(Sector *sector)
 //
 void RenderTrueBSP(void)
 {
-    EDGE_ZoneScoped;
+    EDGE_ProfileZone("RenderTrueBSP");
 
     FuzzUpdate();
 
     ClearBSP();
     OcclusionClear();
+    BeginGeometryCache();
+
+    view_subsectors.clear();
 
     Player *v_player = view_camera_map_object->player_;
 
@@ -1784,19 +2182,31 @@ void RenderTrueBSP(void)
 
             FlushSky(); // flush any deferred sky units
 
-            int current = renderer_dumb_sky.d_;
+            render_backend->SetRenderLayer(kRenderLayerSky, false);
+
+            if (renderer_sky_background.d_)
+            {
+                // The simple pass below fills everywhere the sky walls didn't
+                // and the masked pass fills where they did, so together they
+                // cover the whole view; draw it once instead.  The sky walls
+                // have still put their depth down for what comes after.
+                FinishSky(true);
+            }
+            else
+            {
+                int current = renderer_dumb_sky.d_;
 
-            // Always render a simple sky, when rendering sky walls/planes they are deferred
-            // from previous frame, so fast movement will cause issus on screen edges
-            renderer_dumb_sky.d_ = 1;
+                // Always render a simple sky, when rendering sky walls/planes they are deferred
+                // from previous frame, so fast movement will cause issus on screen edges
+                renderer_dumb_sky.d_ = 1;
 
-            render_backend->SetRenderLayer(kRenderLayerSky, false);
-            FinishSky();
+                FinishSky();
 
-            renderer_dumb_sky.d_ = 0;
-            FinishSky();
+                renderer_dumb_sky.d_ = 0;
+                FinishSky();
 
-            renderer_dumb_sky.d_ = current;
+                renderer_dumb_sky.d_ = current;
+            }
         }
         else if (need_to_draw_sky)
         {
@@ -1841,6 +2251,7 @@ void RenderTrueBSP(void)
             {
             case kRenderSubsector:
                 items.push_back(item);
+                view_subsectors.push_back(item->subsector_->subsector);
                 RenderSubsector(item->subsector_);
                 break;
             case kRenderSkyWall:
@@ -1915,7 +2326,7 @@ void RenderTrueBSP(void)
 
 void RenderView(int x, int y, int w, int h, MapObject *camera, bool full_height, float expand_w)
 {
-    EDGE_ZoneScoped;
+    EDGE_ProfileZone("RenderView");
 
     view_window_x      = x;
     view_window_y      = y;
@@ -20,6 +20,8 @@
 
 #include <math.h>
 
+#include <vector>
+
 #include "dm_state.h"
 #include "epi.h"
 #include "g_game.h" // current_map
@@ -54,6 +56,9 @@ extern ConsoleVariable draw_culling;
 
 static RGBAColor sky_cap_color;
 
+// sky_cap_color and culling_fog_color are worked out from this image
+static const Image *sky_color_image = nullptr;
+
 static uint32_t total_sky_verts = 0;
 
 static RendererVertex *sky_glvert = nullptr;
@@ -236,6 +241,8 @@ void DeleteSkyTextures(void)
 
         DeleteSkyTexGroup(SK);
     }
+
+    sky_color_image = nullptr;
 }
 
 static void BeginSkyUnit(void)
@@ -271,29 +278,54 @@ static void BuildSkyCircle()
     }
 }
 
+//
+// The cylinder only depends on the stretch mode, the sky's size, the
+// far clip and the cap colours, so it is built once into sky_mesh and
+// reused every frame.  Scrolling is applied while copying it out: the
+// side texture coordinates are stored without any offset, and the
+// mirrored lower half has its Y flipped already, so both just get
+// (offx, -offy) added.
+//
+struct SkyMeshUnit
+{
+    int  first;
+    int  count;
+    bool textured; // sides (sky texture) versus caps (flat colour)
+};
+
+struct SkyMeshKey
+{
+    SkyStretch stretch;
+    float      width, height;
+    float      dist;
+    RGBAColor  top_cap, bottom_cap;
+};
+
+static std::vector<RendererVertex> sky_mesh_vertices;
+static std::vector<SkyMeshUnit>    sky_mesh_units;
+static SkyMeshKey                  sky_mesh_key;
+static bool                        sky_mesh_valid = false;
+
+static RendererVertex *AddSkyMeshUnit(int count, bool textured)
+{
+    SkyMeshUnit unit = {(int)sky_mesh_vertices.size(), count, textured};
+
+    sky_mesh_units.push_back(unit);
+    sky_mesh_vertices.resize(unit.first + count);
+
+    return &sky_mesh_vertices[unit.first];
+}
+
 // -----------------------------------------------------------------------------
-// Renders a cylindrical 'slice' of the sky between [top] and [bottom] on the z
+// Builds a cylindrical 'slice' of the sky between [top] and [bottom] on the z
 // axis
 // -----------------------------------------------------------------------------
-static void RenderSkySlice(float top, float bottom, float atop, float abottom, float dist, float tx, float ty,
-                           float offx, float offy, GLuint sky_tex_id, BlendingMode blend, RGBAColor fc_to_use,
-                           float fd_to_use)
+static void BuildSkySlice(float top, float bottom, float atop, float abottom, float dist, float tx, float ty)
 {
-    float tc_x  = offx;
+    float tc_x  = 0;
     float tc_y1 = (top + 1.0f) * (ty * 0.5f);
     float tc_y2 = (bottom + 1.0f) * (ty * 0.5f);
 
-    if (current_sky_stretch == kSkyStretchMirror && bottom < -0.5f)
-    {
-        tc_y1 += offy;
-        tc_y2 += offy;
-    }
-    else
-    {
-        tc_y1 -= offy;
-        tc_y2 -= offy;
-    }
-
     if (current_sky_stretch == kSkyStretchMirror && bottom < -0.5f)
     {
         tc_y1 = -tc_y1;
@@ -303,8 +335,7 @@ static void RenderSkySlice(float top, float bottom, float atop, float abottom, f
     RGBAColor topcol    = epi::MakeRGBA(255, 255, 255, (uint8_t)(atop * 255.0f));
     RGBAColor bottomcol = epi::MakeRGBA(255, 255, 255, (uint8_t)(abottom * 255.0f));
 
-    RendererVertex *glvert = BeginRenderUnit(GL_QUADS, 128, GL_MODULATE, sky_tex_id, (GLuint)kTextureEnvironmentDisable,
-                                             0, 0, blend, fc_to_use, fd_to_use);
+    RendererVertex *glvert = AddSkyMeshUnit(128, true);
 
     // Go through circular points
     for (unsigned a = 0; a < 31; a++)
@@ -344,25 +375,47 @@ static void RenderSkySlice(float top, float bottom, float atop, float abottom, f
     glvert->rgba                   = bottomcol;
     glvert->texture_coordinates[0] = {{tc_x + tx, tc_y2}};
     glvert->position               = {{(sky_circle[0].X * dist), -(sky_circle[0].Y * dist), (bottom * dist)}};
+}
+
+static void BuildSkyCap(float cap_dist, float cap_z, RGBAColor unit_col)
+{
+    RendererVertex *glvert = AddSkyMeshUnit(4, false);
 
-    EndRenderUnit(128);
+    glvert->rgba       = unit_col;
+    glvert++->position = {{-cap_dist, -cap_dist, cap_z}};
+    glvert->rgba       = unit_col;
+    glvert++->position = {{-cap_dist, cap_dist, cap_z}};
+    glvert->rgba       = unit_col;
+    glvert++->position = {{cap_dist, cap_dist, cap_z}};
+    glvert->rgba       = unit_col;
+    glvert->position   = {{cap_dist, -cap_dist, cap_z}};
 }
 
-static void RenderSkyCylinder(void)
+static void BuildSkyMesh(void)
 {
-    GLuint sky_tex_id = ImageCache(sky_image, true, render_view_effect_colormap);
+    RGBAColor bottom_cap = (current_sky_stretch > kSkyStretchMirror) ? culling_fog_color : sky_cap_color;
 
-    if (current_map->forced_skystretch_ > kSkyStretchUnset)
-        current_sky_stretch = current_map->forced_skystretch_;
-    else if (!level_flags.mouselook)
-        current_sky_stretch = kSkyStretchVanilla;
-    else
-        current_sky_stretch = (SkyStretch)sky_stretch_mode.d_;
+    SkyMeshKey key;
 
-    // Center skybox a bit below the camera view
-    SetupSkyMatrices();
+    key.stretch    = current_sky_stretch;
+    key.width      = sky_image->ScaledWidthActual();
+    key.height     = sky_image->ScaledHeightActual();
+    key.dist       = renderer_far_clip.f_ * 2.0f;
+    key.top_cap    = sky_cap_color;
+    key.bottom_cap = bottom_cap;
+
+    if (sky_mesh_valid && key.stretch == sky_mesh_key.stretch && key.width == sky_mesh_key.width &&
+        key.height == sky_mesh_key.height && key.dist == sky_mesh_key.dist && key.top_cap == sky_mesh_key.top_cap &&
+        key.bottom_cap == sky_mesh_key.bottom_cap)
+        return;
+
+    sky_mesh_key   = key;
+    sky_mesh_valid = true;
 
-    float dist     = renderer_far_clip.f_ * 2.0f;
+    sky_mesh_vertices.clear();
+    sky_mesh_units.clear();
+
+    float dist     = key.dist;
     float cap_dist = dist * 2.0f; // Ensure the caps extend beyond the cylindrical
                                   // projection Calculate some stuff based on sky height
     float sky_h_ratio;
@@ -379,6 +432,105 @@ static void RenderSkyCylinder(void)
         solid_sky_h = sky_h_ratio * 0.75f;
     float cap_z = dist * sky_h_ratio;
 
+    // Top cap
+    BuildSkyCap(cap_dist, cap_z, sky_cap_color);
+
+    // Bottom cap
+    if (current_sky_stretch == kSkyStretchVanilla)
+        cap_z = 0;
+
+    BuildSkyCap(cap_dist, -cap_z, bottom_cap);
+
+    // Check for odd sky sizes
+    float tx = 0.125f;
+    float ty = 2.0f;
+    if (sky_image->ScaledWidthActual() > 256)
+        tx = 0.125f / ((float)sky_image->ScaledWidthActual() / 256.0f);
+
+    if (current_sky_stretch == kSkyStretchMirror)
+    {
+        if (sky_image->ScaledHeightActual() > 128)
+        {
+            BuildSkySlice(sky_h_ratio, solid_sky_h, 0.0f, 1.0f, dist, tx, ty);   // Top Fade
+            BuildSkySlice(solid_sky_h, 0.0f, 1.0f, 1.0f, dist, tx, ty);          // Top Solid
+            BuildSkySlice(0.0f, -solid_sky_h, 1.0f, 1.0f, dist, tx, ty);         // Bottom Solid
+            BuildSkySlice(-solid_sky_h, -sky_h_ratio, 1.0f, 0.0f, dist, tx, ty); // Bottom Fade
+        }
+        else
+        {
+            BuildSkySlice(1.0f, 0.75f, 0.0f, 1.0f, dist, tx, ty);   // Top Fade
+            BuildSkySlice(0.75f, 0.0f, 1.0f, 1.0f, dist, tx, ty);   // Top Solid
+            BuildSkySlice(0.0f, -0.75f, 1.0f, 1.0f, dist, tx, ty);  // Bottom Solid
+            BuildSkySlice(-0.75f, -1.0f, 1.0f, 0.0f, dist, tx, ty); // Bottom Fade
+        }
+    }
+    else if (current_sky_stretch == kSkyStretchRepeat)
+    {
+        if (sky_image->ScaledHeightActual() > 128)
+        {
+            BuildSkySlice(sky_h_ratio, solid_sky_h, 0.0f, 1.0f, dist, tx, ty);   // Top Fade
+            BuildSkySlice(solid_sky_h, -solid_sky_h, 1.0f, 1.0f, dist, tx, ty);  // Middle Solid
+            BuildSkySlice(-solid_sky_h, -sky_h_ratio, 1.0f, 0.0f, dist, tx, ty); // Bottom Fade
+        }
+        else
+        {
+            BuildSkySlice(1.0f, 0.75f, 0.0f, 1.0f, dist, tx, ty);   // Top Fade
+            BuildSkySlice(0.75f, -0.75f, 1.0f, 1.0f, dist, tx, ty); // Middle Solid
+            BuildSkySlice(-0.75f, -1.0f, 1.0f, 0.0f, dist, tx, ty); // Bottom Fade
+        }
+    }
+    else if (current_sky_stretch == kSkyStretchStretch)
+    {
+        if (sky_image->ScaledHeightActual() > 128)
+        {
+            ty = ((float)sky_image->ScaledHeightActual() / 256.0f);
+            BuildSkySlice(sky_h_ratio, solid_sky_h, 0.0f, 1.0f, dist, tx, ty);   // Top Fade
+            BuildSkySlice(solid_sky_h, -solid_sky_h, 1.0f, 1.0f, dist, tx, ty);  // Middle Solid
+            BuildSkySlice(-solid_sky_h, -sky_h_ratio, 1.0f, 0.0f, dist, tx, ty); // Bottom Fade
+        }
+        else
+        {
+            ty = 1.0f;
+            BuildSkySlice(1.0f, 0.75f, 0.0f, 1.0f, dist, tx, ty);   // Top Fade
+            BuildSkySlice(0.75f, -0.75f, 1.0f, 1.0f, dist, tx, ty); // Middle Solid
+            BuildSkySlice(-0.75f, -1.0f, 1.0f, 0.0f, dist, tx, ty); // Bottom Fade
+        }
+    }
+    else // Vanilla (or sane value if somehow this gets set out of expected
+         // range)
+    {
+        if (sky_image->ScaledHeightActual() > 128)
+        {
+            BuildSkySlice(sky_h_ratio, solid_sky_h, 0.0f, 1.0f, dist / 2, tx, ty);               // Top Fade
+            BuildSkySlice(solid_sky_h, sky_h_ratio - solid_sky_h, 1.0f, 1.0f, dist / 2, tx, ty); // Middle Solid
+            BuildSkySlice(sky_h_ratio - solid_sky_h, 0.0f, 1.0f, 0.0f, dist / 2, tx, ty);        // Bottom Fade
+        }
+        else
+        {
+            ty *= 1.5f;
+            BuildSkySlice(1.0f, 0.98f, 0.0f, 1.0f, dist / 3, tx, ty);  // Top Fade
+            BuildSkySlice(0.98f, 0.35f, 1.0f, 1.0f, dist / 3, tx, ty); // Middle Solid
+            BuildSkySlice(0.35f, 0.33f, 1.0f, 0.0f, dist / 3, tx, ty); // Bottom Fade
+        }
+    }
+}
+
+static void RenderSkyCylinder(void)
+{
+    GLuint sky_tex_id = ImageCache(sky_image, true, render_view_effect_colormap);
+
+    if (current_map->forced_skystretch_ > kSkyStretchUnset)
+        current_sky_stretch = current_map->forced_skystretch_;
+    else if (!level_flags.mouselook)
+        current_sky_stretch = kSkyStretchVanilla;
+    else
+        current_sky_stretch = (SkyStretch)sky_stretch_mode.d_;
+
+    // Center skybox a bit below the camera view
+    SetupSkyMatrices();
+
+    BuildSkyMesh();
+
     RGBAColor    fc_to_use = current_map->outdoor_fog_color_;
     float        fd_to_use = 0.01f * current_map->outdoor_fog_density_;
     BlendingMode blend     = kBlendingNoZBuffer;
@@ -399,53 +551,8 @@ static void RenderSkyCylinder(void)
         fd_to_use *= (current_sky_stretch == kSkyStretchVanilla ? 0.009f : 0.003f);
     }
 
-    // Render top cap
-    RendererVertex *glvert   = BeginRenderUnit(GL_QUADS, 4, GL_MODULATE, 0, (GLuint)kTextureEnvironmentDisable, 0, 0,
-                                               blend, fc_to_use, fd_to_use);
-    RGBAColor       unit_col = sky_cap_color;
-
-    glvert->rgba       = unit_col;
-    glvert++->position = {{-cap_dist, -cap_dist, cap_z}};
-    glvert->rgba       = unit_col;
-    glvert++->position = {{-cap_dist, cap_dist, cap_z}};
-    glvert->rgba       = unit_col;
-    glvert++->position = {{cap_dist, cap_dist, cap_z}};
-    glvert->rgba       = unit_col;
-    glvert->position   = {{cap_dist, -cap_dist, cap_z}};
-
-    EndRenderUnit(4);
-
-    // Render bottom cap
-    if (current_sky_stretch > kSkyStretchMirror)
-        unit_col = culling_fog_color;
-    if (current_sky_stretch == kSkyStretchVanilla)
-        cap_z = 0;
-
-    glvert = BeginRenderUnit(GL_QUADS, 4, GL_MODULATE, 0, (GLuint)kTextureEnvironmentDisable, 0, 0, blend, fc_to_use,
-                             fd_to_use);
-
-    glvert->rgba       = unit_col;
-    glvert++->position = {{-cap_dist, -cap_dist, -cap_z}};
-    glvert->rgba       = unit_col;
-    glvert++->position = {{-cap_dist, cap_dist, -cap_z}};
-    glvert->rgba       = unit_col;
-    glvert++->position = {{cap_dist, cap_dist, -cap_z}};
-    glvert->rgba       = unit_col;
-    glvert->position   = {{cap_dist, -cap_dist, -cap_z}};
-
-    EndRenderUnit(4);
-
-    // Render skybox sides
-
-    blend = (BlendingMode)(blend | kBlendingAlpha);
-
-    // Check for odd sky sizes
-    float tx   = 0.125f;
-    float ty   = 2.0f;
     float offx = 0;
     float offy = 0;
-    if (sky_image->ScaledWidthActual() > 256)
-        tx = 0.125f / ((float)sky_image->ScaledWidthActual() / 256.0f);
 
     // Set scrolling...I guess MBF transfers should take precedence since part of their purpose is to
     // override the normal sky - Dasho
@@ -492,104 +599,27 @@ static void RenderSkyCylinder(void)
         }
     }
 
-    if (current_sky_stretch == kSkyStretchMirror)
+    for (const SkyMeshUnit &unit : sky_mesh_units)
     {
-        if (sky_image->ScaledHeightActual() > 128)
-        {
-            RenderSkySlice(sky_h_ratio, solid_sky_h, 0.0f, 1.0f, dist, tx, ty, offx, offy, sky_tex_id, blend, fc_to_use,
-                           fd_to_use); // Top Fade
-            RenderSkySlice(solid_sky_h, 0.0f, 1.0f, 1.0f, dist, tx, ty, offx, offy, sky_tex_id, blend, fc_to_use,
-                           fd_to_use); // Top Solid
-            RenderSkySlice(0.0f, -solid_sky_h, 1.0f, 1.0f, dist, tx, ty, offx, offy, sky_tex_id, blend, fc_to_use,
-                           fd_to_use); // Bottom Solid
-            RenderSkySlice(-solid_sky_h, -sky_h_ratio, 1.0f, 0.0f, dist, tx, ty, offx, offy, sky_tex_id, blend,
-                           fc_to_use,
-                           fd_to_use); // Bottom Fade
-        }
-        else
-        {
-            RenderSkySlice(1.0f, 0.75f, 0.0f, 1.0f, dist, tx, ty, offx, offy, sky_tex_id, blend, fc_to_use,
-                           fd_to_use); // Top Fade
-            RenderSkySlice(0.75f, 0.0f, 1.0f, 1.0f, dist, tx, ty, offx, offy, sky_tex_id, blend, fc_to_use,
-                           fd_to_use); // Top Solid
-            RenderSkySlice(0.0f, -0.75f, 1.0f, 1.0f, dist, tx, ty, offx, offy, sky_tex_id, blend, fc_to_use,
-                           fd_to_use); // Bottom Solid
-            RenderSkySlice(-0.75f, -1.0f, 1.0f, 0.0f, dist, tx, ty, offx, offy, sky_tex_id, blend, fc_to_use,
-                           fd_to_use); // Bottom Fade
-        }
-    }
-    else if (current_sky_stretch == kSkyStretchRepeat)
-    {
-        if (sky_image->ScaledHeightActual() > 128)
-        {
-            RenderSkySlice(sky_h_ratio, solid_sky_h, 0.0f, 1.0f, dist, tx, ty, offx, offy, sky_tex_id, blend, fc_to_use,
-                           fd_to_use); // Top Fade
-            RenderSkySlice(solid_sky_h, -solid_sky_h, 1.0f, 1.0f, dist, tx, ty, offx, offy, sky_tex_id, blend,
-                           fc_to_use,
-                           fd_to_use); // Middle Solid
-            RenderSkySlice(-solid_sky_h, -sky_h_ratio, 1.0f, 0.0f, dist, tx, ty, offx, offy, sky_tex_id, blend,
-                           fc_to_use,
-                           fd_to_use); // Bottom Fade
-        }
-        else
-        {
-            RenderSkySlice(1.0f, 0.75f, 0.0f, 1.0f, dist, tx, ty, offx, offy, sky_tex_id, blend, fc_to_use,
-                           fd_to_use); // Top Fade
-            RenderSkySlice(0.75f, -0.75f, 1.0f, 1.0f, dist, tx, ty, offx, offy, sky_tex_id, blend, fc_to_use,
-                           fd_to_use); // Middle Solid
-            RenderSkySlice(-0.75f, -1.0f, 1.0f, 0.0f, dist, tx, ty, offx, offy, sky_tex_id, blend, fc_to_use,
-                           fd_to_use); // Bottom Fade
-        }
-    }
-    else if (current_sky_stretch == kSkyStretchStretch)
-    {
-        if (sky_image->ScaledHeightActual() > 128)
-        {
-            ty = ((float)sky_image->ScaledHeightActual() / 256.0f);
-            RenderSkySlice(sky_h_ratio, solid_sky_h, 0.0f, 1.0f, dist, tx, ty, offx, offy, sky_tex_id, blend, fc_to_use,
-                           fd_to_use); // Top Fade
-            RenderSkySlice(solid_sky_h, -solid_sky_h, 1.0f, 1.0f, dist, tx, ty, offx, offy, sky_tex_id, blend,
-                           fc_to_use,
-                           fd_to_use); // Middle Solid
-            RenderSkySlice(-solid_sky_h, -sky_h_ratio, 1.0f, 0.0f, dist, tx, ty, offx, offy, sky_tex_id, blend,
-                           fc_to_use,
-                           fd_to_use); // Bottom Fade
-        }
-        else
-        {
-            ty = 1.0f;
-            RenderSkySlice(1.0f, 0.75f, 0.0f, 1.0f, dist, tx, ty, offx, offy, sky_tex_id, blend, fc_to_use,
-                           fd_to_use); // Top Fade
-            RenderSkySlice(0.75f, -0.75f, 1.0f, 1.0f, dist, tx, ty, offx, offy, sky_tex_id, blend, fc_to_use,
-                           fd_to_use); // Middle Solid
-            RenderSkySlice(-0.75f, -1.0f, 1.0f, 0.0f, dist, tx, ty, offx, offy, sky_tex_id, blend, fc_to_use,
-                           fd_to_use); // Bottom Fade
-        }
-    }
-    else                               // Vanilla (or sane value if somehow this gets set out of expected
-                                       // range)
-    {
-        if (sky_image->ScaledHeightActual() > 128)
-        {
-            RenderSkySlice(sky_h_ratio, solid_sky_h, 0.0f, 1.0f, dist / 2, tx, ty, offx, offy, sky_tex_id, blend,
-                           fc_to_use,
-                           fd_to_use);                   // Top Fade
-            RenderSkySlice(solid_sky_h, sky_h_ratio - solid_sky_h, 1.0f, 1.0f, dist / 2, tx, ty, offx, offy, sky_tex_id,
-                           blend, fc_to_use, fd_to_use); // Middle Solid
-            RenderSkySlice(sky_h_ratio - solid_sky_h, 0.0f, 1.0f, 0.0f, dist / 2, tx, ty, offx, offy, sky_tex_id, blend,
-                           fc_to_use,
-                           fd_to_use);                   // Bottom Fade
-        }
-        else
+        RendererVertex *glvert =
+            BeginRenderUnit(GL_QUADS, unit.count, GL_MODULATE, unit.textured ? sky_tex_id : 0,
+                            (GLuint)kTextureEnvironmentDisable, 0, 0,
+                            unit.textured ? (BlendingMode)(blend | kBlendingAlpha) : blend, fc_to_use, fd_to_use);
+
+        const RendererVertex *src = &sky_mesh_vertices[unit.first];
+
+        for (int i = 0; i < unit.count; i++, glvert++, src++)
         {
-            ty *= 1.5f;
-            RenderSkySlice(1.0f, 0.98f, 0.0f, 1.0f, dist / 3, tx, ty, offx, offy, sky_tex_id, blend, fc_to_use,
-                           fd_to_use); // Top Fade
-            RenderSkySlice(0.98f, 0.35f, 1.0f, 1.0f, dist / 3, tx, ty, offx, offy, sky_tex_id, blend, fc_to_use,
-                           fd_to_use); // Middle Solid
-            RenderSkySlice(0.35f, 0.33f, 1.0f, 0.0f, dist / 3, tx, ty, offx, offy, sky_tex_id, blend, fc_to_use,
-                           fd_to_use); // Bottom Fade
+            *glvert = *src;
+
+            if (unit.textured)
+            {
+                glvert->texture_coordinates[0].X += offx;
+                glvert->texture_coordinates[0].Y -= offy;
+            }
         }
+
+        EndRenderUnit(unit.count);
     }
 }
 
@@ -757,7 +787,7 @@ void FlushSky(void)
         FinishSkyUnit();
 }
 
-void FinishSky()
+void FinishSky(bool background)
 {
 
     render_state->ColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
@@ -765,10 +795,12 @@ void FinishSky()
     if (!need_to_draw_sky)
         return;
 
-    if (draw_culling.d_)
+    if (draw_culling.d_ || background)
         render_state->Disable(GL_DEPTH_TEST);
 
-    if (!renderer_dumb_sky.d_)
+    if (background)
+        render_state->DepthMask(false);
+    else if (!renderer_dumb_sky.d_)
         render_state->DepthFunction(GL_GREATER);
     else
         render_state->DepthMask(false);
@@ -793,10 +825,12 @@ void FinishSky()
     renderer_dumb_clamp = old_dumb_clamp;
 #endif
 
-    if (draw_culling.d_)
+    if (draw_culling.d_ || background)
         render_state->Enable(GL_DEPTH_TEST);
 
-    if (!renderer_dumb_sky.d_)
+    if (background)
+        render_state->DepthMask(true);
+    else if (!renderer_dumb_sky.d_)
         render_state->DepthFunction(GL_LEQUAL);
     else
         render_state->DepthMask(true);
@@ -936,24 +970,30 @@ int UpdateSkyboxTextures(void)
         ImageLookup(UserSkyFaceName(sky_image->name_.c_str(), kSkyboxNorth), kImageNamespaceTexture, kImageLookupNull);
 
     // Set colors for culling fog and faux skybox caps - Dasho
-    const uint8_t *what_palette = nullptr;
-    if (sky_image->source_palette_ >= 0)
-        what_palette = (const uint8_t *)LoadLumpIntoMemory(sky_image->source_palette_);
-    ImageData *tmp_img_data = ReadAsEpiBlock((Image *)sky_image);
-    if (tmp_img_data->depth_ == 1)
+    // (these don't depend on the colormap, so only redo them for a new sky)
+    if (sky_color_image != sky_image)
     {
-        ImageData *rgb_img_data = RGBFromPalettised(
-            tmp_img_data, what_palette ? what_palette : (const uint8_t *)&playpal_data[0], sky_image->opacity_);
+        sky_color_image = sky_image;
+
+        const uint8_t *what_palette = nullptr;
+        if (sky_image->source_palette_ >= 0)
+            what_palette = (const uint8_t *)LoadLumpIntoMemory(sky_image->source_palette_);
+        ImageData *tmp_img_data = ReadAsEpiBlock((Image *)sky_image);
+        if (tmp_img_data->depth_ == 1)
+        {
+            ImageData *rgb_img_data = RGBFromPalettised(
+                tmp_img_data, what_palette ? what_palette : (const uint8_t *)&playpal_data[0], sky_image->opacity_);
+            delete tmp_img_data;
+            tmp_img_data = rgb_img_data;
+        }
+        culling_fog_color = tmp_img_data->AverageColor(0, sky_image->actual_width_, 0, sky_image->actual_height_ / 2);
+        sky_cap_color     = tmp_img_data->AverageColor(0, sky_image->actual_width_, sky_image->actual_height_ * 3 / 4,
+                                                       sky_image->actual_height_);
         delete tmp_img_data;
-        tmp_img_data = rgb_img_data;
-    }
-    culling_fog_color = tmp_img_data->AverageColor(0, sky_image->actual_width_, 0, sky_image->actual_height_ / 2);
-    sky_cap_color     = tmp_img_data->AverageColor(0, sky_image->actual_width_, sky_image->actual_height_ * 3 / 4,
-                                                   sky_image->actual_height_);
-    delete tmp_img_data;
 
-    if (what_palette)
-        delete[] what_palette;
+        if (what_palette)
+            delete[] what_palette;
+    }
 
     if (info->face[kSkyboxNorth])
     {
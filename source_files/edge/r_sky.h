@@ -49,7 +49,9 @@ void ComputeSkyHeights(void);
 
 void BeginSky(void);
 void FlushSky(void);
-void FinishSky(void);
+// When 'background' is true the sky is drawn over the whole view with
+// no depth test, behind whatever comes after it.
+void FinishSky(bool background = false);
 
 void RenderSkyPlane(Subsector *sub, float h);
 void RenderSkyWall(Seg *seg, float h1, float h2);
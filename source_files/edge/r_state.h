@@ -51,6 +51,9 @@ extern Sector *level_sectors;
 extern int        total_level_subsectors;
 extern Subsector *level_subsectors;
 
+extern int  total_level_segs;
+extern Seg *level_segs;
+
 extern int      total_level_nodes;
 extern BSPNode *level_nodes;
 
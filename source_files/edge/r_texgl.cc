@@ -19,6 +19,7 @@
 #include "r_texgl.h"
 
 #include <limits.h>
+#include <string.h>
 
 #include <unordered_map>
 
@@ -86,76 +87,75 @@ ImageData *RGBFromPalettised(ImageData *src, const uint8_t *palette, int opacity
         ImageData *dest    = new ImageData(src->width_, src->height_, bpp);
         dest->used_width_  = src->used_width_;
         dest->used_height_ = src->used_height_;
-        for (int y = 0; y < src->height_; y++)
-            for (int x = 0; x < src->width_; x++)
-            {
-                uint8_t src_pix = *src->PixelAt(x, y);
 
-                uint8_t *dest_pix = dest->PixelAt(x, y);
+        // expand the palette into a lookup table once, the transparent
+        // index becoming all zeros, then it's just a copy per pixel.
+        uint8_t lookup[256][4];
 
-                if (src_pix == kTransparentPixelIndex)
-                {
-                    dest_pix[0] = dest_pix[1] = dest_pix[2] = 0;
+        for (int i = 0; i < 256; i++)
+        {
+            lookup[i][0] = palette[i * 3 + 0];
+            lookup[i][1] = palette[i * 3 + 1];
+            lookup[i][2] = palette[i * 3 + 2];
+            lookup[i][3] = 255;
+        }
 
-                    if (bpp == 4)
-                        dest_pix[3] = 0;
-                }
-                else
-                {
-                    dest_pix[0] = palette[src_pix * 3 + 0];
-                    dest_pix[1] = palette[src_pix * 3 + 1];
-                    dest_pix[2] = palette[src_pix * 3 + 2];
+        memset(lookup[kTransparentPixelIndex], 0, 4);
+
+        const uint8_t *src_pix  = src->pixels_;
+        const uint8_t *src_end  = src_pix + src->width_ * src->height_;
+        uint8_t       *dest_pix = dest->pixels_;
+
+        if (bpp == 4)
+        {
+            for (; src_pix < src_end; src_pix++, dest_pix += 4)
+                memcpy(dest_pix, lookup[*src_pix], 4);
+        }
+        else
+        {
+            for (; src_pix < src_end; src_pix++, dest_pix += 3)
+                memcpy(dest_pix, lookup[*src_pix], 3);
+        }
 
-                    if (bpp == 4)
-                        dest_pix[3] = 255;
-                }
-            }
         return dest;
     }
     else
         return src;
 }
 
-GLuint UploadTexture(ImageData *img, int flags, int max_pix)
+// scale down, if necessary, to fit the maximum size
+static void ComputeUploadSize(const ImageData *img, int max_pix, int max_size, int *new_w, int *new_h)
 {
-    /* Send the texture data to the GL, and returns the texture ID
-     * assigned to it.
-     */
+    int w, h;
 
-    // Only OpenGL supports RGB format for textures, so promote to RGBA
-    if (img->depth_ == 3)
-    {
-        img->SetAlpha(255);
-    }
-
-    EPI_ASSERT(img->depth_ == 3 || img->depth_ == 4);
-
-    bool clamp  = (flags & kUploadClamp) ? true : false;
-    bool nomip  = (flags & kUploadMipMap) ? false : true;
-    bool smooth = (flags & kUploadSmooth) ? true : false;
-
-    int total_w = img->width_;
-    int total_h = img->height_;
-
-    int new_w, new_h;
-
-    // scale down, if necessary, to fix the maximum size
-    for (new_w = total_w; new_w > render_backend->GetMaxTextureSize(); new_w /= 2)
+    for (w = img->width_; w > max_size; w /= 2)
     { /* nothing here */
     }
 
-    for (new_h = total_h; new_h > render_backend->GetMaxTextureSize(); new_h /= 2)
+    for (h = img->height_; h > max_size; h /= 2)
     { /* nothing here */
     }
 
-    while (new_w * new_h > max_pix)
+    while (w * h > max_pix)
     {
-        if (new_h >= new_w)
-            new_h /= 2;
+        if (h >= w)
+            h /= 2;
         else
-            new_w /= 2;
+            w /= 2;
     }
 
+    *new_w = w;
+    *new_h = h;
+}
+
+// creates the texture object and sets up wrapping and filtering,
+// leaving it bound ready for the TexImage2D calls.
+static GLuint BeginTextureUpload(int flags, int mipmapping)
+{
+    bool clamp  = (flags & kUploadClamp) ? true : false;
+    bool nomip  = (flags & kUploadMipMap) ? false : true;
+    bool smooth = (flags & kUploadSmooth) ? true : false;
+
     render_state->PixelStorei(GL_UNPACK_ALIGNMENT, 1);
 
     GLuint id;
@@ -178,7 +178,7 @@ GLuint UploadTexture(ImageData *img, int flags, int max_pix)
     render_state->TextureMagFilter(smooth ? GL_LINEAR : GL_NEAREST);
 
     // minification mode
-    int mip_level = HMM_Clamp(0, image_mipmapping, 2);
+    int mip_level = HMM_Clamp(0, mipmapping, 2);
 
     // special logic for mid-masked textures.  The kUploadThresh flag
     // guarantees that each texture level has simple alpha (0 or 255),
@@ -193,6 +193,31 @@ GLuint UploadTexture(ImageData *img, int flags, int max_pix)
 
     render_state->TextureMinFilter(minif_modes[(smooth ? 3 : 0) + (nomip ? 0 : mip_level)]);
 
+    return id;
+}
+
+// Shrinks `img` in place to each level of its mip chain in turn (the
+// first being the upload size), calling `func` with it at every level.
+// Safe to call from a worker thread, as no render state is used.
+typedef void (*TextureMipFunc)(const ImageData *img, int mip, void *data);
+
+static void ForEachTextureMip(ImageData *img, int flags, int max_pix, int max_size, int mipmapping,
+                              TextureMipFunc func, void *data)
+{
+    // Only OpenGL supports RGB format for textures, so promote to RGBA
+    if (img->depth_ == 3)
+    {
+        img->SetAlpha(255);
+    }
+
+    EPI_ASSERT(img->depth_ == 3 || img->depth_ == 4);
+
+    bool nomip = (flags & kUploadMipMap) ? false : true;
+
+    int new_w, new_h;
+
+    ComputeUploadSize(img, max_pix, max_size, &new_w, &new_h);
+
     for (int mip = 0;; mip++)
     {
         if (img->width_ != new_w || img->height_ != new_h)
@@ -203,22 +228,104 @@ GLuint UploadTexture(ImageData *img, int flags, int max_pix)
                 img->ThresholdAlpha((mip & 1) ? 96 : 144);
         }
 
-        render_state->TexImage2D(GL_TEXTURE_2D, mip, img->depth_ == 3 ? GL_RGB : GL_RGBA, new_w, new_h, 0,
-                                 img->depth_ == 3 ? GL_RGB : GL_RGBA, GL_UNSIGNED_BYTE, img->PixelAt(0, 0));
+        func(img, mip, data);
 
         // stop if mipmapping disabled or we have reached the end
-        if (nomip || !image_mipmapping || (new_w == 1 && new_h == 1))
+        if (nomip || !mipmapping || (new_w == 1 && new_h == 1))
             break;
 
         new_w = HMM_MAX(1, new_w / 2);
         new_h = HMM_MAX(1, new_h / 2);
     }
+}
+
+static void UploadTextureMip(const ImageData *img, int mip, void *data)
+{
+    (void)data;
+
+    render_state->TexImage2D(GL_TEXTURE_2D, mip, img->depth_ == 3 ? GL_RGB : GL_RGBA, img->width_, img->height_, 0,
+                             img->depth_ == 3 ? GL_RGB : GL_RGBA, GL_UNSIGNED_BYTE, img->PixelAt(0, 0));
+}
+
+static void CopyTextureMip(const ImageData *img, int mip, void *data)
+{
+    (void)mip;
+
+    std::vector<ImageData *> *levels = (std::vector<ImageData *> *)data;
+
+    ImageData *level    = new ImageData(img->width_, img->height_, img->depth_);
+    level->used_width_  = img->used_width_;
+    level->used_height_ = img->used_height_;
+
+    memcpy(level->pixels_, img->pixels_, img->width_ * img->height_ * img->depth_);
+
+    levels->push_back(level);
+}
+
+GLuint UploadTexture(ImageData *img, int flags, int max_pix)
+{
+    /* Send the texture data to the GL, and returns the texture ID
+     * assigned to it.
+     */
+
+    GLuint id = BeginTextureUpload(flags, image_mipmapping);
+
+    ForEachTextureMip(img, flags, max_pix, render_backend->GetMaxTextureSize(), image_mipmapping, UploadTextureMip,
+                      nullptr);
 
     render_state->FinishTextures(1, &id);
 
     return id;
 }
 
+void BuildTextureMipChain(ImageData *img, int flags, int max_pix, int max_size, int mipmapping,
+                          std::vector<ImageData *> &levels)
+{
+    ForEachTextureMip(img, flags, max_pix, max_size, mipmapping, CopyTextureMip, &levels);
+}
+
+GLuint UploadTextureMipChain(const std::vector<ImageData *> &levels, int flags, int mipmapping)
+{
+    EPI_ASSERT(!levels.empty());
+
+    GLuint id = BeginTextureUpload(flags, mipmapping);
+
+    for (size_t mip = 0; mip < levels.size(); mip++)
+    {
+        const ImageData *img = levels[mip];
+
+        render_state->TexImage2D(GL_TEXTURE_2D, (GLint)mip, img->depth_ == 3 ? GL_RGB : GL_RGBA, img->width_,
+                                 img->height_, 0, img->depth_ == 3 ? GL_RGB : GL_RGBA, GL_UNSIGNED_BYTE,
+                                 img->PixelAt(0, 0));
+    }
+
+    render_state->FinishTextures(1, &id);
+
+    return id;
+}
+
+GLuint CreateDynamicTexture(int width, int height, int flags)
+{
+    GLuint id = BeginTextureUpload(flags & ~kUploadMipMap, 0);
+
+    // On sokol, this only sets up the texture dimensions
+    render_state->TexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr,
+                             kRenderUsageDynamic);
+
+    render_state->FinishTextures(1, &id);
+
+    return id;
+}
+
+void UpdateDynamicTexture(GLuint tex_id, const ImageData *img)
+{
+    EPI_ASSERT(img->depth_ == 4);
+
+    render_state->BindTexture(tex_id);
+    render_state->TexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, img->width_, img->height_, 0, GL_RGBA, GL_UNSIGNED_BYTE,
+                             img->pixels_, kRenderUsageDynamic);
+}
+
 //----------------------------------------------------------------------------
 
 void PaletteRemapRGBA(const ImageData *img, const uint8_t *new_pal, const uint8_t *old_pal)
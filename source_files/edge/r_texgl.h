@@ -18,6 +18,8 @@
 
 #pragma once
 
+#include <vector>
+
 #include "i_defs_gl.h"
 #include "im_data.h"
 
@@ -33,6 +35,20 @@ enum TextureUploadFlag
 
 GLuint UploadTexture(ImageData *img, int flags = kUploadNone, int max_pix = (1 << 30));
 
+// Split version of UploadTexture() for deferred loading.  The first part
+// does all the resizing and mipmap generation and is safe to call from a
+// worker thread (img is modified in the process).  The second part only
+// sends the prepared levels to the GL and must be called from the render
+// thread.
+void   BuildTextureMipChain(ImageData *img, int flags, int max_pix, int max_size, int mipmapping,
+                            std::vector<ImageData *> &levels);
+GLuint UploadTextureMipChain(const std::vector<ImageData *> &levels, int flags, int mipmapping);
+
+// RGBA texture whose contents are replaced as a whole (at most once per
+// frame) by UpdateDynamicTexture().  No mipmaps.
+GLuint CreateDynamicTexture(int width, int height, int flags);
+void   UpdateDynamicTexture(GLuint tex_id, const ImageData *img);
+
 ImageData *RGBFromPalettised(ImageData *src, const uint8_t *palette, int opacity);
 
 void PaletteRemapRGBA(const ImageData *img, const uint8_t *new_pal, const uint8_t *old_pal);
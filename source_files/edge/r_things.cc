@@ -1008,8 +1008,10 @@ static bool RenderThing(DrawThing *dthing, bool solid)
 
     const Image *image = dthing->image;
 
-    GLuint tex_id = ImageCache(
-        image, false, render_view_effect_colormap ? render_view_effect_colormap : dthing->map_object->info_->palremap_);
+    const Colormap *sprite_colormap =
+        render_view_effect_colormap ? render_view_effect_colormap : dthing->map_object->info_->palremap_;
+
+    GLuint tex_id = ImageCache(image, false, sprite_colormap);
 
     // calculate edges of the shape
     float sprite_width  = image->ScaledWidthActual();
@@ -1178,6 +1180,10 @@ static bool RenderThing(DrawThing *dthing, bool solid)
         tex_x2     = right - temp;
     }
 
+    // untranslated sprites can come from the shared atlas
+    if (!sprite_colormap)
+        tex_id = ImageCacheAtlas(image, false, &tex_x1, &tex_y1, &tex_x2, &tex_y2);
+
     ThingCoordinateData data;
 
     data.mo = mo;
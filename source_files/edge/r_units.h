@@ -94,5 +94,25 @@ RendererVertex *BeginRenderUnit(GLuint shape, int max_vert, GLuint env1, GLuint
                                 float fog_density = 0);
 void            EndRenderUnit(int actual_vert);
 
+// Units and vertices flushed per unit shape.  Only the null backend
+// counts these, for the headless render benchmark (r_benchmark.cc).
+enum RenderUnitShape
+{
+    kRenderUnitQuads,
+    kRenderUnitTriangles,
+    kRenderUnitPolygon,
+    kRenderUnitQuadStrip,
+    kRenderUnitLines,
+    kTotalRenderUnitShapes
+};
+
+struct RenderUnitShapeStats
+{
+    uint32_t units[kTotalRenderUnitShapes];
+    uint32_t vertices[kTotalRenderUnitShapes];
+};
+
+extern RenderUnitShapeStats render_unit_shape_stats;
+
 //--- editor settings ---
 // vi:ts=4:sw=4:noexpandtab
@@ -560,13 +560,19 @@ void ScriptDamageMonsters(RADScriptTrigger *R, void *param)
 
     Player *player = GetWhoDunnit(R);
 
-    // If we have a tag, we can scan the active tagged mobj list instead
+    // If we have a tag, we can scan the active tagged mobj list instead.
+    // Killing a monster takes it off that list, so work from a copy.
     if (tag)
     {
-        auto mobjs = active_tagged_map_objects.equal_range(tag);
-        for (auto mobj = mobjs.first; mobj != mobjs.second; ++mobj)
+        std::vector<MapObject *> victims;
+
+        auto mobjs = active_tagged_map_objects.find(tag);
+
+        if (mobjs != active_tagged_map_objects.end())
+            victims = mobjs->second;
+
+        for (MapObject *mo : victims)
         {
-            MapObject *mo = mobj->second;
             if (info && mo->info_ != info)
                 continue;
 
@@ -583,12 +589,9 @@ void ScriptDamageMonsters(RADScriptTrigger *R, void *param)
     {
         MapObject *mo;
         MapObject *next;
-        for (mo = map_object_list_head; mo != nullptr; mo = next)
+        for (mo = info ? FirstMapObjectOfType(info) : map_object_list_head; mo != nullptr; mo = next)
         {
-            next = mo->next_;
-
-            if (info && mo->info_ != info)
-                continue;
+            next = info ? mo->type_next_ : mo->next_;
 
             if (!(mo->extended_flags_ & kExtendedFlagMonster) || mo->health_ <= 0)
                 continue;
@@ -629,24 +632,28 @@ void ScriptThingEvent(RADScriptTrigger *R, void *param)
     // If we have a tag, we can scan the active tagged mobj list instead
     if (tag)
     {
-        auto mobjs = active_tagged_map_objects.equal_range(tag);
-        for (auto mobj = mobjs.first; mobj != mobjs.second; ++mobj)
+        auto mobjs = active_tagged_map_objects.find(tag);
+
+        if (mobjs != active_tagged_map_objects.end())
         {
-            MapObject *mo = mobj->second;
-            if (info && mo->info_ != info)
-                continue;
+            // deferred states can't change any tags, so no copy needed
+            for (MapObject *mo : mobjs->second)
+            {
+                if (info && mo->info_ != info)
+                    continue;
 
-            // ignore certain things (e.g. corpses)
-            if (mo->health_ <= 0)
-                continue;
+                // ignore certain things (e.g. corpses)
+                if (mo->health_ <= 0)
+                    continue;
 
-            if (!ScriptRadiusCheck(mo, R->info))
-                continue;
+                if (!ScriptRadiusCheck(mo, R->info))
+                    continue;
 
-            int state = MapObjectFindLabel(mo, tev->label);
+                int state = MapObjectFindLabel(mo, tev->label);
 
-            if (state)
-                MapObjectSetStateDeferred(mo, state + tev->offset, 0);
+                if (state)
+                    MapObjectSetStateDeferred(mo, state + tev->offset, 0);
+            }
         }
     }
     else
@@ -654,12 +661,9 @@ void ScriptThingEvent(RADScriptTrigger *R, void *param)
         MapObject *mo;
         MapObject *next;
 
-        for (mo = map_object_list_head; mo != nullptr; mo = next)
+        for (mo = info ? FirstMapObjectOfType(info) : map_object_list_head; mo != nullptr; mo = next)
         {
-            next = mo->next_;
-
-            if (info && (mo->info_ != info))
-                continue;
+            next = info ? mo->type_next_ : mo->next_;
 
             // ignore certain things (e.g. corpses)
             if (mo->health_ <= 0)
@@ -922,7 +926,6 @@ void ScriptMoveSector(RADScriptTrigger *R, void *param)
 {
     EPI_UNUSED(R);
     ScriptMoveSectorParameter *t = (ScriptMoveSectorParameter *)param;
-    int                        i;
 
     // SectorV compatibility
     if (t->tag == 0)
@@ -934,12 +937,8 @@ void ScriptMoveSector(RADScriptTrigger *R, void *param)
         return;
     }
 
-    // OPTIMISE !
-    for (i = 0; i < total_level_sectors; i++)
-    {
-        if (level_sectors[i].tag == t->tag)
-            MoveOneSector(level_sectors + i, t);
-    }
+    for (Sector *tsec = FindSectorFromTag(t->tag); tsec; tsec = tsec->tag_next)
+        MoveOneSector(tsec, t);
 }
 
 static void LightOneSector(Sector *sec, ScriptSectorLightParameter *t)
@@ -954,7 +953,6 @@ void ScriptLightSector(RADScriptTrigger *R, void *param)
 {
     EPI_UNUSED(R);
     ScriptSectorLightParameter *t = (ScriptSectorLightParameter *)param;
-    int                         i;
 
     // SectorL compatibility
     if (t->tag == 0)
@@ -966,55 +964,47 @@ void ScriptLightSector(RADScriptTrigger *R, void *param)
         return;
     }
 
-    // OPTIMISE !
-    for (i = 0; i < total_level_sectors; i++)
-    {
-        if (level_sectors[i].tag == t->tag)
-            LightOneSector(level_sectors + i, t);
-    }
+    for (Sector *tsec = FindSectorFromTag(t->tag); tsec; tsec = tsec->tag_next)
+        LightOneSector(tsec, t);
 }
 
 void ScriptFogSector(RADScriptTrigger *R, void *param)
 {
     EPI_UNUSED(R);
     ScriptFogSectorParameter *t = (ScriptFogSectorParameter *)param;
-    int                       i;
 
-    for (i = 0; i < total_level_sectors; i++)
+    for (Sector *tsec = FindSectorFromTag(t->tag); tsec; tsec = tsec->tag_next)
     {
-        if (level_sectors[i].tag == t->tag)
+        if (!t->leave_color)
         {
-            if (!t->leave_color)
-            {
-                if (t->colmap_color)
-                    level_sectors[i].properties.fog_color = ParseFontColor(t->colmap_color);
-                else // should only happen with a CLEAR directive
-                    level_sectors[i].properties.fog_color = kRGBANoValue;
-            }
-            if (!t->leave_density)
+            if (t->colmap_color)
+                tsec->properties.fog_color = ParseFontColor(t->colmap_color);
+            else // should only happen with a CLEAR directive
+                tsec->properties.fog_color = kRGBANoValue;
+        }
+        if (!t->leave_density)
+        {
+            if (t->relative)
             {
-                if (t->relative)
-                {
-                    level_sectors[i].properties.fog_density += (0.01f * t->density);
-                    if (level_sectors[i].properties.fog_density < 0.0001f)
-                        level_sectors[i].properties.fog_density = 0;
-                    if (level_sectors[i].properties.fog_density > 0.01f)
-                        level_sectors[i].properties.fog_density = 0.01f;
-                }
-                else
-                    level_sectors[i].properties.fog_density = 0.01f * t->density;
+                tsec->properties.fog_density += (0.01f * t->density);
+                if (tsec->properties.fog_density < 0.0001f)
+                    tsec->properties.fog_density = 0;
+                if (tsec->properties.fog_density > 0.01f)
+                    tsec->properties.fog_density = 0.01f;
             }
-            for (int j = 0; j < level_sectors[i].line_count; j++)
+            else
+                tsec->properties.fog_density = 0.01f * t->density;
+        }
+        for (int j = 0; j < tsec->line_count; j++)
+        {
+            for (int k = 0; k < 2; k++)
             {
-                for (int k = 0; k < 2; k++)
+                Side *side_check = tsec->lines[j]->side[k];
+                if (side_check && side_check->middle.fog_wall)
                 {
-                    Side *side_check = level_sectors[i].lines[j]->side[k];
-                    if (side_check && side_check->middle.fog_wall)
-                    {
-                        side_check->middle.image = nullptr; // will be rebuilt with proper color later
-                                                            // don't delete the image in case other
-                                                            // fogwalls use the same color
-                    }
+                    side_check->middle.image = nullptr; // will be rebuilt with proper color later
+                                                        // don't delete the image in case other
+                                                        // fogwalls use the same color
                 }
             }
         }
@@ -1458,7 +1448,7 @@ void P_ActReplace(MapObject *mo, const MapObjectDefinition *newThing)
 
     // UnsetThingPosition(mo);
     {
-        mo->info_ = newThing;
+        MapObjectSetType(mo, newThing);
 
         mo->radius_ = mo->info_->radius_;
         mo->height_ = mo->info_->height_;
@@ -1553,15 +1543,14 @@ void ScriptReplaceThing(RADScriptTrigger *R, void *param)
     // scan the mobj list
     // FIXME: optimise for fixed-sized triggers
 
+    // replacing moves an object off its type's list, so remember the next
+    // one first.
     MapObject *mo;
     MapObject *next;
 
-    for (mo = map_object_list_head; mo != nullptr; mo = next)
+    for (mo = oldThing ? FirstMapObjectOfType(oldThing) : map_object_list_head; mo != nullptr; mo = next)
     {
-        next = mo->next_;
-
-        if (oldThing && mo->info_ != oldThing)
-            continue;
+        next = oldThing ? mo->type_next_ : mo->next_;
 
         if (!ScriptRadiusCheck(mo, R->info))
             continue;
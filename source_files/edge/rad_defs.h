@@ -762,6 +762,13 @@ struct RADScriptTrigger
 
     // prevent repeating scripts from clogging the console
     const char *last_con_message = nullptr;
+
+    // spatial index info (see RunScriptTriggers): position within the
+    // active_triggers list, the last pass which collected this trigger,
+    // and whether it is on the "always check" pending list.
+    int  index_order   = 0;
+    int  index_stamp   = 0;
+    bool index_pending = false;
 };
 
 //
@@ -34,11 +34,15 @@
 
 #include "rad_trig.h"
 
+#include <algorithm>
+#include <unordered_map>
+
 #include "am_map.h"
 #include "dm_defs.h"
 #include "dm_state.h"
 #include "e_input.h"
 #include "e_main.h"
+#include "edge_profiling.h"
 #include "epi.h"
 #include "epi_file.h"
 #include "epi_filesystem.h"
@@ -70,6 +74,40 @@ RADScript *current_scripts = nullptr;
 // Dynamic Triggers.  These only exist for the current level.
 RADScriptTrigger *active_triggers = nullptr;
 
+//
+// Spatial index of the active triggers.  Triggers with a bounded radius
+// box are bucketed into a coarse grid laid over the blockmap, so that each
+// tic only those near a live player need to be looked at.  Immediate,
+// sector-based and map-wide triggers are always checked, as are triggers
+// which must keep running regardless of where the players are (counting
+// down a repeat delay, or independent and already activated).
+//
+// The index is rebuilt lazily after the trigger list is recreated (new
+// level or loaded game), and triggers are unlinked as they are removed.
+// Alongside it the triggers are hashed by their number and name tags for
+// ScriptEnableByTag.
+//
+constexpr uint16_t kTriggerUnitSize = 512;
+
+static std::vector<std::vector<RADScriptTrigger *>> trigger_cells;
+static std::vector<RADScriptTrigger *>              trigger_globals;
+static std::vector<RADScriptTrigger *>              trigger_pending;
+static std::vector<RADScriptTrigger *>              trigger_candidates;
+
+static std::unordered_multimap<uint64_t, RADScriptTrigger *> trigger_tags[2];
+
+static int  trigger_cells_width  = 0;
+static int  trigger_cells_height = 0;
+static int  trigger_check_stamp  = 0;
+static bool trigger_index_valid  = false;
+
+static void TriggerIndexBuild(void);
+
+// player positions at the time the candidates were collected
+static float trigger_player_x[kMaximumPlayers];
+static float trigger_player_y[kMaximumPlayers];
+static int   trigger_player_mask = 0;
+
 class rts_menu_c
 {
   private:
@@ -370,18 +408,24 @@ void ClearDeathTriggersByMap(const std::string &mapname)
 //
 void ScriptEnableByTag(uint64_t tag, bool disable, RADScriptTag tagtype)
 {
-    RADScriptTrigger *trig;
-
-    for (trig = active_triggers; trig; trig = trig->next)
+    if (tag == 0)
     {
-        if (trig->info->tag[tagtype] == tag)
+        // untagged triggers aren't hashed
+        for (RADScriptTrigger *trig = active_triggers; trig; trig = trig->next)
         {
-            if (disable)
-                trig->disabled = true;
-            else
-                trig->disabled = false;
+            if (trig->info->tag[tagtype] == 0)
+                trig->disabled = disable;
         }
+        return;
     }
+
+    if (!trigger_index_valid)
+        TriggerIndexBuild();
+
+    auto range = trigger_tags[tagtype].equal_range(tag);
+
+    for (auto iter = range.first; iter != range.second; ++iter)
+        iter->second->disabled = disable;
 }
 
 //
@@ -390,20 +434,7 @@ void ScriptEnableByTag(uint64_t tag, bool disable, RADScriptTag tagtype)
 //
 void ScriptEnableByTag(const char *name, bool disable)
 {
-    RADScriptTrigger *trig;
-
-    uint64_t tag = epi::StringHash::Create(name).Value();
-
-    for (trig = active_triggers; trig; trig = trig->next)
-    {
-        if (trig->info->tag[kTriggerTagHash] == tag)
-        {
-            if (disable)
-                trig->disabled = true;
-            else
-                trig->disabled = false;
-        }
-    }
+    ScriptEnableByTag(epi::StringHash::Create(name).Value(), disable, kTriggerTagHash);
 }
 
 //
@@ -412,17 +443,20 @@ void ScriptEnableByTag(const char *name, bool disable)
 //
 bool CheckActiveScriptByTag(const char *name)
 {
-    RADScriptTrigger *trig;
-
     uint64_t tag = epi::StringHash::Create(name).Value();
 
-    for (trig = active_triggers; trig; trig = trig->next)
+    if (tag == 0)
+        return false;
+
+    if (!trigger_index_valid)
+        TriggerIndexBuild();
+
+    auto range = trigger_tags[kTriggerTagHash].equal_range(tag);
+
+    for (auto iter = range.first; iter != range.second; ++iter)
     {
-        if (trig->info->tag[1] == tag)
-        {
-            if (trig->disabled == false)
-                return true;
-        }
+        if (iter->second->disabled == false)
+            return true;
     }
 
     return false;
@@ -544,13 +578,13 @@ static bool ScriptCheckBossTrigger(ScriptOnDeathParameter *cond)
         }
     }
 
+    if (map_object_list_head != nullptr && seen_monsters.count(cond->cached_info) == 0)
+        return false; // Never on map?
+
     // scan the remaining mobjs to see if all bosses are dead
-    for (mo = map_object_list_head; mo != nullptr; mo = mo->next_)
+    for (mo = FirstMapObjectOfType(cond->cached_info); mo != nullptr; mo = mo->type_next_)
     {
-        if (seen_monsters.count(cond->cached_info) == 0)
-            return false; // Never on map?
-
-        if (mo->info_ == cond->cached_info && mo->health_ > 0)
+        if (mo->health_ > 0)
         {
             count++;
 
@@ -646,6 +680,256 @@ bool ScriptUpdatePath(MapObject *thing)
     return true;
 }
 
+static bool TriggerIsGlobal(const RADScript *r)
+{
+    // these match the cases in ScriptRadiusCheck which do not use the
+    // trigger's radius box.
+    if (r->tagged_immediate)
+        return true;
+
+    if (r->sector_tag > 0)
+        return true;
+
+    if (r->sector_index >= 0 && r->sector_index <= total_level_sectors)
+        return true;
+
+    return (r->rad_x < 0 || r->rad_y < 0);
+}
+
+static bool TriggerNeedsPending(const RADScriptTrigger *trig)
+{
+    return trig->repeat_delay > 0 || (trig->info->tagged_independent && trig->activated);
+}
+
+static void TriggerCheckPending(RADScriptTrigger *trig)
+{
+    if (!trig->index_pending && TriggerNeedsPending(trig))
+    {
+        trig->index_pending = true;
+        trigger_pending.push_back(trig);
+    }
+}
+
+static void TriggerCellRange(float x1, float y1, float x2, float y2, int *cx1, int *cy1, int *cx2, int *cy2)
+{
+    *cx1 = (int)floorf((x1 - blockmap_origin_x) / kTriggerUnitSize);
+    *cy1 = (int)floorf((y1 - blockmap_origin_y) / kTriggerUnitSize);
+    *cx2 = (int)floorf((x2 - blockmap_origin_x) / kTriggerUnitSize);
+    *cy2 = (int)floorf((y2 - blockmap_origin_y) / kTriggerUnitSize);
+
+    // clamping keeps overlapping boxes overlapping, so things outside
+    // the blockmap area simply share the border cells.
+    *cx1 = HMM_Clamp(0, *cx1, trigger_cells_width - 1);
+    *cy1 = HMM_Clamp(0, *cy1, trigger_cells_height - 1);
+    *cx2 = HMM_Clamp(0, *cx2, trigger_cells_width - 1);
+    *cy2 = HMM_Clamp(0, *cy2, trigger_cells_height - 1);
+}
+
+static void TriggerScriptCellRange(const RADScript *r, int *cx1, int *cy1, int *cx2, int *cy2)
+{
+    TriggerCellRange(r->x - r->rad_x, r->y - r->rad_y, r->x + r->rad_x, r->y + r->rad_y, cx1, cy1, cx2, cy2);
+}
+
+static void TriggerIndexClear(void)
+{
+    trigger_cells.clear();
+    trigger_globals.clear();
+    trigger_pending.clear();
+    trigger_candidates.clear();
+    trigger_tags[kTriggerTagNumber].clear();
+    trigger_tags[kTriggerTagHash].clear();
+
+    trigger_cells_width  = 0;
+    trigger_cells_height = 0;
+    trigger_index_valid  = false;
+}
+
+static void TriggerIndexBuild(void)
+{
+    TriggerIndexClear();
+
+    if (blockmap_width > 0 && blockmap_height > 0)
+    {
+        trigger_cells_width  = (blockmap_width * kBlockmapUnitSize + kTriggerUnitSize - 1) / kTriggerUnitSize;
+        trigger_cells_height = (blockmap_height * kBlockmapUnitSize + kTriggerUnitSize - 1) / kTriggerUnitSize;
+
+        trigger_cells.resize(trigger_cells_width * trigger_cells_height);
+    }
+
+    int order = 0;
+
+    for (RADScriptTrigger *trig = active_triggers; trig; trig = trig->next)
+    {
+        trig->index_order   = order++;
+        trig->index_stamp   = 0;
+        trig->index_pending = false;
+
+        TriggerCheckPending(trig);
+
+        for (int tagtype = kTriggerTagNumber; tagtype <= kTriggerTagHash; tagtype++)
+        {
+            if (trig->info->tag[tagtype] != 0)
+                trigger_tags[tagtype].emplace(trig->info->tag[tagtype], trig);
+        }
+
+        if (trigger_cells.empty() || TriggerIsGlobal(trig->info))
+        {
+            trigger_globals.push_back(trig);
+            continue;
+        }
+
+        int cx1, cy1, cx2, cy2;
+        TriggerScriptCellRange(trig->info, &cx1, &cy1, &cx2, &cy2);
+
+        for (int cy = cy1; cy <= cy2; cy++)
+            for (int cx = cx1; cx <= cx2; cx++)
+                trigger_cells[cy * trigger_cells_width + cx].push_back(trig);
+    }
+
+    trigger_check_stamp = 0;
+    trigger_index_valid = true;
+}
+
+static void TriggerListErase(std::vector<RADScriptTrigger *> &list, RADScriptTrigger *trig)
+{
+    std::vector<RADScriptTrigger *>::iterator it = std::find(list.begin(), list.end(), trig);
+
+    if (it != list.end())
+        list.erase(it);
+}
+
+static void TriggerIndexUnlink(RADScriptTrigger *trig)
+{
+    if (!trigger_index_valid)
+        return;
+
+    if (trig->index_pending)
+        TriggerListErase(trigger_pending, trig);
+
+    for (int tagtype = kTriggerTagNumber; tagtype <= kTriggerTagHash; tagtype++)
+    {
+        auto range = trigger_tags[tagtype].equal_range(trig->info->tag[tagtype]);
+
+        for (auto iter = range.first; iter != range.second; ++iter)
+        {
+            if (iter->second == trig)
+            {
+                trigger_tags[tagtype].erase(iter);
+                break;
+            }
+        }
+    }
+
+    if (trigger_cells.empty() || TriggerIsGlobal(trig->info))
+    {
+        TriggerListErase(trigger_globals, trig);
+        return;
+    }
+
+    int cx1, cy1, cx2, cy2;
+    TriggerScriptCellRange(trig->info, &cx1, &cy1, &cx2, &cy2);
+
+    for (int cy = cy1; cy <= cy2; cy++)
+        for (int cx = cx1; cx <= cx2; cx++)
+            TriggerListErase(trigger_cells[cy * trigger_cells_width + cx], trig);
+}
+
+static void TriggerAddCandidate(RADScriptTrigger *trig, int after_order)
+{
+    if (trig->index_stamp == trigger_check_stamp || trig->index_order <= after_order)
+        return;
+
+    trig->index_stamp = trigger_check_stamp;
+    trigger_candidates.push_back(trig);
+}
+
+struct CompareTriggerOrderPredicate
+{
+    inline bool operator()(const RADScriptTrigger *A, const RADScriptTrigger *B) const
+    {
+        return A->index_order < B->index_order;
+    }
+};
+
+//
+// Fill trigger_candidates with every trigger (positioned after
+// `after_order' in the active list) which could possibly pass its
+// radius check this tic, sorted into active list order.
+//
+static void TriggerCollectCandidates(int after_order)
+{
+    trigger_candidates.clear();
+    trigger_check_stamp++;
+
+    for (RADScriptTrigger *trig : trigger_globals)
+        TriggerAddCandidate(trig, after_order);
+
+    // drop pending triggers which no longer need to run unconditionally
+    size_t keep = 0;
+
+    for (RADScriptTrigger *trig : trigger_pending)
+    {
+        if (!TriggerNeedsPending(trig))
+        {
+            trig->index_pending = false;
+            continue;
+        }
+
+        trigger_pending[keep++] = trig;
+        TriggerAddCandidate(trig, after_order);
+    }
+
+    trigger_pending.resize(keep);
+
+    trigger_player_mask = ScriptAlivePlayers();
+
+    for (int pnum = 0; pnum < kMaximumPlayers; pnum++)
+    {
+        if (!(trigger_player_mask & (1 << pnum)))
+            continue;
+
+        MapObject *mo = players[pnum]->map_object_;
+
+        trigger_player_x[pnum] = mo->x;
+        trigger_player_y[pnum] = mo->y;
+
+        if (trigger_cells.empty())
+            continue;
+
+        int cx1, cy1, cx2, cy2;
+        TriggerCellRange(mo->x - mo->radius_, mo->y - mo->radius_, mo->x + mo->radius_, mo->y + mo->radius_, &cx1,
+                         &cy1, &cx2, &cy2);
+
+        for (int cy = cy1; cy <= cy2; cy++)
+            for (int cx = cx1; cx <= cx2; cx++)
+                for (RADScriptTrigger *trig : trigger_cells[cy * trigger_cells_width + cx])
+                    TriggerAddCandidate(trig, after_order);
+    }
+
+    std::sort(trigger_candidates.begin(), trigger_candidates.end(), CompareTriggerOrderPredicate());
+}
+
+static bool TriggerPlayersMoved(void)
+{
+    if (ScriptAlivePlayers() != trigger_player_mask)
+        return true;
+
+    for (int pnum = 0; pnum < kMaximumPlayers; pnum++)
+    {
+        if (!(trigger_player_mask & (1 << pnum)))
+            continue;
+
+        MapObject *mo = players[pnum]->map_object_;
+
+        // exact comparison on purpose: any movement at all invalidates
+        // the collected candidates.
+        if (mo->x != trigger_player_x[pnum] || mo->y != trigger_player_y[pnum])
+            return true;
+    }
+
+    return false;
+}
+
 static void DoRemoveTrigger(RADScriptTrigger *trig)
 {
     // handle tag linkage
@@ -664,157 +948,203 @@ static void DoRemoveTrigger(RADScriptTrigger *trig)
     else
         active_triggers = trig->next;
 
+    TriggerIndexUnlink(trig);
+
     StopSoundEffect(&trig->sound_effects_origin);
 
     delete trig;
 }
 
 //
-// Radius Trigger Event handler.
+// Check the conditions of a single trigger and run its states.
+// Returns true if any state action was executed.
 //
-void RunScriptTriggers(void)
+static bool RunOneTrigger(RADScriptTrigger *trig)
 {
-    RADScriptTrigger *trig, *next;
+    // Don't process, if disabled
+    if (trig->disabled)
+        return false;
 
-    // Start looking through the trigger list.
-    for (trig = active_triggers; trig; trig = next)
+    // Handle repeat delay (from TAGGED_REPEATABLE).  This must be
+    // done *before* all the condition checks, and that's what makes
+    // it different from `wait_tics'.
+    //
+    if (trig->repeat_delay > 0)
     {
-        next = trig->next;
+        trig->repeat_delay--;
+        return false;
+    }
 
-        // stop running all triggers when an RTS menu becomes active
-        if (rts_menu_active)
-            break;
+    // Independent, means you don't have to stay within the trigger
+    // radius for it to operate, It will operate on it's own.
 
-        // Don't process, if disabled
-        if (trig->disabled)
-            continue;
+    if (!(trig->info->tagged_independent && trig->activated))
+    {
+        int mask = ScriptAlivePlayers();
 
-        // Handle repeat delay (from TAGGED_REPEATABLE).  This must be
-        // done *before* all the condition checks, and that's what makes
-        // it different from `wait_tics'.
+        // Immediate triggers are just that. Immediate.
+        // Not within range so skip it.
         //
-        if (trig->repeat_delay > 0)
+        if (!trig->info->tagged_immediate)
         {
-            trig->repeat_delay--;
-            continue;
+            mask = ScriptAllPlayersInRadius(trig->info, mask);
+            if (mask == 0)
+                return false;
         }
 
-        // Independent, means you don't have to stay within the trigger
-        // radius for it to operate, It will operate on it's own.
+        // Check for use key trigger.
+        if (trig->info->tagged_use)
+        {
+            mask = ScriptAllPlayersUsing(mask);
+            if (mask == 0)
+                return false;
+        }
 
-        if (!(trig->info->tagged_independent && trig->activated))
+        // height check...
+        if (trig->info->height_trig)
         {
-            int mask = ScriptAlivePlayers();
+            ScriptOnHeightParameter *cur;
 
-            // Immediate triggers are just that. Immediate.
-            // Not within range so skip it.
-            //
-            if (!trig->info->tagged_immediate)
-            {
-                mask = ScriptAllPlayersInRadius(trig->info, mask);
-                if (mask == 0)
-                    continue;
-            }
+            for (cur = trig->info->height_trig; cur; cur = cur->next)
+                if (!ScriptCheckHeightTrigger(trig, cur))
+                    break;
 
-            // Check for use key trigger.
-            if (trig->info->tagged_use)
-            {
-                mask = ScriptAllPlayersUsing(mask);
-                if (mask == 0)
-                    continue;
-            }
+            // if they all succeeded, then cur will be nullptr...
+            if (cur)
+                return false;
+        }
 
-            // height check...
-            if (trig->info->height_trig)
-            {
-                ScriptOnHeightParameter *cur;
+        // ondeath check...
+        if (trig->info->boss_trig)
+        {
+            ScriptOnDeathParameter *cur;
 
-                for (cur = trig->info->height_trig; cur; cur = cur->next)
-                    if (!ScriptCheckHeightTrigger(trig, cur))
-                        break;
+            for (cur = trig->info->boss_trig; cur; cur = cur->next)
+                if (!ScriptCheckBossTrigger(cur))
+                    break;
 
-                // if they all succeeded, then cur will be nullptr...
-                if (cur)
-                    continue;
-            }
+            // if they all succeeded, then cur will be nullptr...
+            if (cur)
+                return false;
+        }
 
-            // ondeath check...
-            if (trig->info->boss_trig)
-            {
-                ScriptOnDeathParameter *cur;
+        // condition check...
+        if (trig->info->cond_trig)
+        {
+            mask = ScriptAllPlayersCheckCondition(trig->info, mask);
+            if (mask == 0)
+                return false;
+        }
 
-                for (cur = trig->info->boss_trig; cur; cur = cur->next)
-                    if (!ScriptCheckBossTrigger(cur))
-                        break;
+        trig->activated    = true;
+        trig->acti_players = mask;
 
-                // if they all succeeded, then cur will be nullptr...
-                if (cur)
-                    continue;
-            }
+        TriggerCheckPending(trig);
+    }
 
-            // condition check...
-            if (trig->info->cond_trig)
-            {
-                mask = ScriptAllPlayersCheckCondition(trig->info, mask);
-                if (mask == 0)
-                    continue;
-            }
+    // If we are waiting, decrement count and skip it.
+    // Note that we must do this *after* all the condition checks.
+    //
+    if (trig->wait_tics > 0)
+    {
+        trig->wait_tics--;
+        return false;
+    }
 
-            trig->activated    = true;
-            trig->acti_players = mask;
-        }
+    bool ran = false;
 
-        // If we are waiting, decrement count and skip it.
-        // Note that we must do this *after* all the condition checks.
+    // Waiting until monsters are dead?
+    while (trig->wait_tics == 0 && trig->wud_count <= 0)
+    {
+        // Execute current command
+        RADScriptState *state = trig->state;
+        EPI_ASSERT(state);
+
+        // move to next state.  We do this NOW since the action itself
+        // may want to change the trigger's state (to support GOTO type
+        // actions and other possibilities).
         //
-        if (trig->wait_tics > 0)
-        {
-            trig->wait_tics--;
-            continue;
-        }
+        trig->state = trig->state->next;
 
-        // Waiting until monsters are dead?
-        while (trig->wait_tics == 0 && trig->wud_count <= 0)
-        {
-            // Execute current command
-            RADScriptState *state = trig->state;
-            EPI_ASSERT(state);
+        (*state->action)(trig, state->param);
+        ran = true;
 
-            // move to next state.  We do this NOW since the action itself
-            // may want to change the trigger's state (to support GOTO type
-            // actions and other possibilities).
-            //
-            trig->state = trig->state->next;
+        if (!trig->state)
+            break;
 
-            (*state->action)(trig, state->param);
+        trig->wait_tics += trig->state->tics;
 
-            if (!trig->state)
-                break;
+        if (trig->disabled || rts_menu_active)
+            break;
+    }
 
-            trig->wait_tics += trig->state->tics;
+    if (trig->state)
+        return ran;
 
-            if (trig->disabled || rts_menu_active)
-                break;
-        }
+    // we've reached the end of the states.  Delete the trigger unless
+    // it is Tagged_Repeatable and has some more repeats left.
+    //
+    if (trig->info->repeat_count != 0)
+        trig->repeats_left--;
 
-        if (trig->state)
-            continue;
+    if (trig->repeats_left > 0)
+    {
+        trig->state        = trig->info->first_state;
+        trig->wait_tics    = trig->state->tics;
+        trig->repeat_delay = trig->info->repeat_delay;
 
-        // we've reached the end of the states.  Delete the trigger unless
-        // it is Tagged_Repeatable and has some more repeats left.
-        //
-        if (trig->info->repeat_count != 0)
-            trig->repeats_left--;
+        TriggerCheckPending(trig);
+        return ran;
+    }
 
-        if (trig->repeats_left > 0)
-        {
-            trig->state        = trig->info->first_state;
-            trig->wait_tics    = trig->state->tics;
-            trig->repeat_delay = trig->info->repeat_delay;
+    DoRemoveTrigger(trig);
+
+    return ran;
+}
+
+//
+// Radius Trigger Event handler.
+//
+// Only the triggers collected from the spatial index are visited, but they
+// are visited in active list order, so the result is the same as walking
+// the entire list.
+//
+void RunScriptTriggers(void)
+{
+    EDGE_ProfileZone("RunScriptTriggers");
+
+    if (!trigger_index_valid)
+        TriggerIndexBuild();
+
+    TriggerCollectCandidates(-1);
+
+    for (size_t i = 0; i < trigger_candidates.size(); i++)
+    {
+        // stop running all triggers when an RTS menu becomes active
+        if (rts_menu_active)
+            break;
+
+        RADScriptTrigger *trig  = trigger_candidates[i];
+        int               order = trig->index_order;
+
+        // NOTE: trig may be freed after this call
+        if (!RunOneTrigger(trig) || !TriggerPlayersMoved())
             continue;
-        }
 
-        DoRemoveTrigger(trig);
+        // An action has moved (or killed/revived) a player, so the rest of
+        // the list must be re-collected using the new positions.  Keep the
+        // remaining old candidates too, they still get the normal checks.
+        std::vector<RADScriptTrigger *> remaining(trigger_candidates.begin() + i + 1, trigger_candidates.end());
+
+        TriggerCollectCandidates(order);
+
+        for (RADScriptTrigger *other : remaining)
+            TriggerAddCandidate(other, order);
+
+        std::sort(trigger_candidates.begin(), trigger_candidates.end(), CompareTriggerOrderPredicate());
+
+        // restart at the first entry of the new list
+        i = (size_t)-1;
     }
 }
 
@@ -928,6 +1258,8 @@ void SpawnScriptTriggers(const char *map_name)
 
         active_triggers = trig;
     }
+
+    trigger_index_valid = false;
 }
 
 static void ScriptClearCachedInfo(void)
@@ -963,6 +1295,7 @@ void ClearScriptTriggers(void)
         delete trig;
     }
 
+    TriggerIndexClear();
     ScriptClearCachedInfo();
     ResetScriptTips();
 }
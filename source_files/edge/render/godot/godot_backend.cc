@@ -109,6 +109,25 @@ class GodotRenderBackend : public RenderBackend
     {
     }
 
+    bool BeginWorldTarget(int32_t target, int32_t width, int32_t height)
+    {
+        EPI_UNUSED(target);
+        EPI_UNUSED(width);
+        EPI_UNUSED(height);
+        return false;
+    }
+
+    void FinishWorldTarget()
+    {
+    }
+
+    uint32_t GetWorldTargetTexture(int32_t target, bool &upside_down)
+    {
+        EPI_UNUSED(target);
+        upside_down = false;
+        return 0;
+    }
+
     void GetFrameStats(FrameStats &stats)
     {
         EPI_UNUSED(stats);
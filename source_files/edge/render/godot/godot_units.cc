@@ -282,7 +282,7 @@ static void RenderFlush()
 //
 void RenderCurrentUnits(void)
 {
-    EDGE_ZoneScoped;
+    EDGE_ProfileZone("RenderCurrentUnits");
 
     if (render_backend->RenderUnitsLocked())
     {
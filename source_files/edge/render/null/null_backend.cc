@@ -1,7 +1,11 @@
 // clang-format off
 #include "../../r_backend.h"
+#include "../../r_units.h"
 #include <epi.h>
 
+void BSPStartThread();
+void BSPStopThread();
+
 class NullRenderBackend : public RenderBackend
 {
   public:
@@ -21,12 +25,17 @@ class NullRenderBackend : public RenderBackend
     {
       EPI_UNUSED(width);
       EPI_UNUSED(height);
+
+      // nothing is drawn, but counting what would have been lets the
+      // renderer's CPU side be measured without a GPU
+      EPI_CLEAR_MEMORY(&frame_stats_, FrameStats, 1);
     }
 
     void Flush(int32_t commands, int32_t vertices)
     {
-      EPI_UNUSED(commands);
-      EPI_UNUSED(vertices);
+      frame_stats_.num_draw_ += commands;
+      frame_stats_.num_update_buffer_++;
+      frame_stats_.size_update_buffer_ += vertices * sizeof(RendererVertex);
     }
 
     void SwapBuffers()
@@ -46,6 +55,7 @@ class NullRenderBackend : public RenderBackend
 
     void Shutdown()
     {
+        BSPStopThread();
     }
 
 
@@ -61,6 +71,8 @@ class NullRenderBackend : public RenderBackend
     {
         max_texture_size_ = 4096;
         RenderBackend::Init();
+
+        BSPStartThread();
     }
 
     // FIXME: go away!
@@ -109,12 +121,32 @@ class NullRenderBackend : public RenderBackend
     {
     }
 
+    bool BeginWorldTarget(int32_t target, int32_t width, int32_t height)
+    {
+        EPI_UNUSED(target);
+        EPI_UNUSED(width);
+        EPI_UNUSED(height);
+        return false;
+    }
+
+    void FinishWorldTarget()
+    {
+    }
+
+    uint32_t GetWorldTargetTexture(int32_t target, bool &upside_down)
+    {
+        EPI_UNUSED(target);
+        upside_down = false;
+        return 0;
+    }
+
     void GetFrameStats(FrameStats &stats)
     {
-        EPI_UNUSED(stats);
+        stats = frame_stats_;
     }
 
   private:
+    FrameStats frame_stats_ = {};
 };
 
 static NullRenderBackend null_render_backend;
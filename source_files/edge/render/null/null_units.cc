@@ -251,24 +251,37 @@ static void RenderFlush()
         // assume unit will require a command
         num_commands++;
 
+        RenderUnitShape shape = kTotalRenderUnitShapes;
+
         switch (unit->shape)
         {
         case GL_QUADS:
             num_vertices += unit->count / 4 * 6; // quads are emulated as triangle strips, and use 6 vertices internally
+            shape = kRenderUnitQuads;
             break;
         case GL_TRIANGLES:
             num_vertices += unit->count;
+            shape = kRenderUnitTriangles;
             break;
         case GL_POLYGON:
             num_vertices += (unit->count - 1) * 3;
+            shape = kRenderUnitPolygon;
             break;
         case GL_QUAD_STRIP:
             num_vertices += unit->count;
+            shape = kRenderUnitQuadStrip;
             break;
         case GL_LINES:
             num_vertices += (unit->count / 2) * 6; // thick lines are emulated as quads
+            shape = kRenderUnitLines;
             break; // quads are emulated as triangle strips, and use 6 vertices internally
         }
+
+        if (shape != kTotalRenderUnitShapes)
+        {
+            render_unit_shape_stats.units[shape]++;
+            render_unit_shape_stats.vertices[shape] += unit->count;
+        }
     }
 
     render_backend->Flush(num_commands, num_vertices);
@@ -282,7 +295,7 @@ static void RenderFlush()
 //
 void RenderCurrentUnits(void)
 {
-    EDGE_ZoneScoped;
+    EDGE_ProfileZone("RenderCurrentUnits");
 
     if (render_backend->RenderUnitsLocked())
     {
@@ -96,6 +96,7 @@ class SokolRenderBackend : public RenderBackend
         }
 
         FinalizeDeletedImages();
+        FinalizeRetiredTargets();
 
         render_state->Reset();
 
@@ -294,6 +295,13 @@ class SokolRenderBackend : public RenderBackend
     // FIXME: go away!
     void GetPassInfo(PassInfo &info)
     {
+        if (active_target_ >= 0)
+        {
+            info.width_  = world_targets_[active_target_].width_;
+            info.height_ = world_targets_[active_target_].height_;
+            return;
+        }
+
         info.width_  = pass_.swapchain.width;
         info.height_ = pass_.swapchain.height;
     }
@@ -405,6 +413,71 @@ class SokolRenderBackend : public RenderBackend
         SetRenderLayer(kRenderLayerHUD);
     }
 
+    bool BeginWorldTarget(int32_t target, int32_t width, int32_t height)
+    {
+        EPI_ASSERT(target >= 0 && target < kRenderWorldTargetMax);
+        EPI_ASSERT(active_target_ < 0);
+
+        // one context for the target pass, one to resume the frame
+        if (current_context_ + 3 >= kContextPoolSize)
+        {
+            return false;
+        }
+
+        WorldTarget &world_target = world_targets_[target];
+
+        if (world_target.width_ != width || world_target.height_ != height)
+        {
+            if (world_target.color_.id != SG_INVALID_ID)
+            {
+                retired_targets_.push_back(world_target);
+            }
+
+            MakeWorldTarget(world_target, width, height);
+        }
+
+        sg_pass pass;
+        EPI_CLEAR_MEMORY(&pass, sg_pass, 1);
+        pass.action                       = pass_.action;
+        pass.action.colors[0].load_action = SG_LOADACTION_CLEAR;
+        pass.action.depth.load_action     = SG_LOADACTION_CLEAR;
+        pass.attachments                  = world_target.attachments_;
+
+        SwitchPass(pass);
+
+        active_target_ = target;
+
+        return true;
+    }
+
+    void FinishWorldTarget()
+    {
+        EPI_ASSERT(active_target_ >= 0);
+
+        active_target_ = -1;
+
+        // carry on with what was already drawn to screen
+        sg_pass pass                      = pass_;
+        pass.action.colors[0].load_action = SG_LOADACTION_LOAD;
+        pass.action.depth.load_action     = SG_LOADACTION_LOAD;
+        pass.action.stencil.load_action   = SG_LOADACTION_LOAD;
+
+        SwitchPass(pass);
+    }
+
+    uint32_t GetWorldTargetTexture(int32_t target, bool &upside_down)
+    {
+        EPI_ASSERT(target >= 0 && target < kRenderWorldTargetMax);
+
+#ifdef SOKOL_D3D11
+        upside_down = true;
+#else
+        upside_down = false;
+#endif
+
+        return world_targets_[target].color_.id;
+    }
+
     void GetFrameStats(FrameStats &stats)
     {
         sg_frame_stats sg_stats = sg_query_frame_stats();
@@ -428,6 +501,87 @@ class SokolRenderBackend : public RenderBackend
         bool used_;
     };
 
+    struct WorldTarget
+    {
+        sg_image       color_;
+        sg_image       depth_;
+        sg_attachments attachments_;
+        int32_t        width_;
+        int32_t        height_;
+    };
+
+    void MakeWorldTarget(WorldTarget &world_target, int32_t width, int32_t height)
+    {
+        sg_image_desc img_desc;
+        EPI_CLEAR_MEMORY(&img_desc, sg_image_desc, 1);
+        img_desc.render_target = true;
+        img_desc.width         = width;
+        img_desc.height        = height;
+        img_desc.pixel_format  = SG_PIXELFORMAT_RGBA8;
+        img_desc.sample_count  = 1;
+
+        world_target.color_ = sg_make_image(&img_desc);
+
+        img_desc.pixel_format = SG_PIXELFORMAT_DEPTH;
+
+        world_target.depth_ = sg_make_image(&img_desc);
+
+        sg_attachments_desc attachments_desc;
+        EPI_CLEAR_MEMORY(&attachments_desc, sg_attachments_desc, 1);
+        attachments_desc.colors[0].image     = world_target.color_;
+        attachments_desc.depth_stencil.image = world_target.depth_;
+
+        world_target.attachments_ = sg_make_attachments(&attachments_desc);
+        world_target.width_       = width;
+        world_target.height_      = height;
+
+        sg_sampler_desc sampler_desc;
+        EPI_CLEAR_MEMORY(&sampler_desc, sg_sampler_desc, 1);
+        sampler_desc.wrap_u        = SG_WRAP_CLAMP_TO_EDGE;
+        sampler_desc.wrap_v        = SG_WRAP_CLAMP_TO_EDGE;
+        sampler_desc.min_filter    = SG_FILTER_LINEAR;
+        sampler_desc.mag_filter    = SG_FILTER_LINEAR;
+        sampler_desc.mipmap_filter = SG_FILTER_NEAREST;
+
+        RegisterImageSampler(world_target.color_.id, &sampler_desc);
+    }
+
+    // Targets replaced during a frame may still be drawn by it, so they
+    // go at the start of the next one, like deleted images.
+    void FinalizeRetiredTargets()
+    {
+        for (auto itr = retired_targets_.begin(); itr != retired_targets_.end(); itr++)
+        {
+            sg_destroy_attachments(itr->attachments_);
+            sg_destroy_image(itr->depth_);
+            DeleteImage(itr->color_);
+        }
+
+        retired_targets_.clear();
+    }
+
+    // Ends the current pass and starts the given one on a fresh context,
+    // as each context can only be drawn once per frame.
+    void SwitchPass(const sg_pass &pass)
+    {
+        if (sgl_num_vertices())
+        {
+            sgl_context_draw(context_pool_[current_context_]);
+        }
+
+        sg_end_pass();
+
+        current_context_++;
+        EPI_ASSERT(current_context_ < kContextPoolSize);
+
+        sgl_set_context(context_pool_[current_context_]);
+        render_state->OnContextSwitch();
+
+        sg_begin_pass(&pass);
+
+        SetupMatrices(render_state_.layer_, true);
+    }
+
     struct RenderState
     {
         RenderLayer layer_;
@@ -444,6 +598,10 @@ class SokolRenderBackend : public RenderBackend
     sg_pass pass_;
 
     WorldState world_state_[kRenderWorldMax];
+
+    WorldTarget              world_targets_[kRenderWorldTargetMax] = {};
+    std::vector<WorldTarget> retired_targets_;
+    int32_t                  active_target_ = -1;
 };
 
 static SokolRenderBackend sokol_render_backend;
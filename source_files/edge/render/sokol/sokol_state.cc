@@ -200,6 +200,12 @@ class SokolRenderState : public RenderState
 
     void Scissor(GLint x, GLint y, GLsizei width, GLsizei height)
     {
+        if (scissor_.enabled_ &&
+            (scissor_.x_ != x || scissor_.y_ != y || scissor_.width_ != width || scissor_.height_ != height))
+        {
+            scissor_.dirty_ = true;
+        }
+
         scissor_.x_      = x;
         scissor_.y_      = y;
         scissor_.width_  = width;
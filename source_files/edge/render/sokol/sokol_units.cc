@@ -284,7 +284,7 @@ static void RenderFlush()
 //
 void RenderCurrentUnits(void)
 {
-    EDGE_ZoneScoped;
+    EDGE_ProfileZone("RenderCurrentUnits");
 
     if (render_backend->RenderUnitsLocked())
     {
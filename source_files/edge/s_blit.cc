@@ -29,6 +29,7 @@
 
 #include "AlmostEquals.h"
 #include "dm_state.h"
+#include "edge_profiling.h"
 #include "epi.h"
 #ifdef GD_PLATFORM_SDL
 #include "epi_sdl.h"
@@ -117,7 +118,7 @@ void KillSoundChannel(int k)
 
 void UpdateSounds(MapObject *listener, BAMAngle angle)
 {
-    EDGE_ZoneScoped;
+    EDGE_ProfileZone("UpdateSounds");
 
     ma_sound_group_set_volume(&sfx_node, sound_effect_volume.f_ * 0.5f);
 
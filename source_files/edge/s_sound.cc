@@ -19,6 +19,7 @@
 #include "s_sound.h"
 
 #include "dm_state.h"
+#include "edge_profiling.h"
 #include "epi.h"
 #ifdef GD_PLATFORM_SDL
 #include "epi_sdl.h"
@@ -547,6 +548,8 @@ void StopAllSoundEffects(void)
 
 void SoundTicker(void)
 {
+    EDGE_ProfileZone("SoundTicker");
+
     if (no_sound || playing_movie)
         return;
 
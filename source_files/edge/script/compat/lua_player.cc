@@ -1339,12 +1339,12 @@ static int MO_query_tagged(lua_State *L)
     int whatinfo = (int)luaL_checknumber(L, 2);
     // If this tag is not unique, it is not guaranteed which mobj
     // will actually be returned. Plan accordingly - Dasho
-    std::multimap<int, MapObject *>::iterator findme = active_tagged_map_objects.find(whattag);
+    auto findme = active_tagged_map_objects.find(whattag);
 
     if (findme == active_tagged_map_objects.end())
         lua_pushstring(L, "");
     else
-        lua_pushstring(L, GetQueryInfoFromMobj(findme->second, whatinfo).c_str());
+        lua_pushstring(L, GetQueryInfoFromMobj(findme->second.front(), whatinfo).c_str());
 
     return 1;
 }
@@ -1357,12 +1357,12 @@ static int MO_query_tid(lua_State *L)
     int whatinfo = (int)luaL_checknumber(L, 2);
     // TIDs should be unique but if not, it is not guaranteed which mobj
     // will actually be returned. Plan accordingly - Dasho
-    std::multimap<int, MapObject *>::iterator findme = active_tids.find(whattid);
+    auto findme = active_tids.find(whattid);
 
     if (findme == active_tids.end())
         lua_pushstring(L, "");
     else
-        lua_pushstring(L, GetQueryInfoFromMobj(findme->second, whatinfo).c_str());
+        lua_pushstring(L, GetQueryInfoFromMobj(findme->second.front(), whatinfo).c_str());
 
     return 1;
 }
@@ -1825,23 +1825,22 @@ static int MO_object_info(lua_State *L)
 //
 static int MO_tagged_info(lua_State *L)
 {
-    int whattag = (int)luaL_checknumber(L, 1);
-    int count   = active_tagged_map_objects.count(whattag);
+    int  whattag = (int)luaL_checknumber(L, 1);
+    auto findme  = active_tagged_map_objects.find(whattag);
 
-    if (!count)
+    if (findme == active_tagged_map_objects.end())
     {
         lua_pushstring(L, ""); // Found nothing
         return 1;
     }
     else
     {
-        lua_createtable(L, 0, count);
-        auto findme = active_tagged_map_objects.equal_range(whattag);
-        int  index  = 1;
-        for (auto mobj = findme.first; mobj != findme.second; ++mobj, ++index)
+        lua_createtable(L, 0, (int)findme->second.size());
+        int index = 1;
+        for (MapObject *mobj : findme->second)
         {
-            lua_pushnumber(L, index);
-            CreateLuaTable_Mobj(L, mobj->second);
+            lua_pushnumber(L, index++);
+            CreateLuaTable_Mobj(L, mobj);
             lua_settable(L, -3);
         }
         return 1;
@@ -1852,23 +1851,22 @@ static int MO_tagged_info(lua_State *L)
 //
 static int MO_tid_info(lua_State *L)
 {
-    int whattid = (int)luaL_checknumber(L, 1);
-    int count   = active_tids.count(whattid);
+    int  whattid = (int)luaL_checknumber(L, 1);
+    auto findme  = active_tids.find(whattid);
 
-    if (!count)
+    if (findme == active_tids.end())
     {
         lua_pushstring(L, ""); // Found nothing
         return 1;
     }
     else
     {
-        lua_createtable(L, 0, count);
-        auto findme = active_tids.equal_range(whattid);
-        int  index  = 1;
-        for (auto mobj = findme.first; mobj != findme.second; ++mobj, ++index)
+        lua_createtable(L, 0, (int)findme->second.size());
+        int index = 1;
+        for (MapObject *mobj : findme->second)
         {
-            lua_pushnumber(L, index);
-            CreateLuaTable_Mobj(L, mobj->second);
+            lua_pushnumber(L, index++);
+            CreateLuaTable_Mobj(L, mobj);
             lua_settable(L, -3);
         }
         return 1;
@@ -1909,10 +1907,29 @@ static int MO_count(lua_State *L)
     MapObject *mo;
     double     thingcount = 0;
 
-    for (mo = map_object_list_head; mo; mo = mo->next_)
+    if (thingid == 0)
+    {
+        // number 0 is shared by every definition without a doomednum
+        // (plus the template), so the per-type lists don't help here.
+        for (mo = map_object_list_head; mo; mo = mo->next_)
+            if (mo->info_->number_ == thingid && mo->health_ > 0)
+                thingcount++;
+    }
+    else
     {
-        if (mo->info_->number_ == thingid && mo->health_ > 0)
-            thingcount++;
+        // a later DDF entry can redefine a number without removing the
+        // earlier one, and things spawned from either still count.
+        for (const MapObjectDefinition *info : mobjtypes)
+        {
+            if (info->number_ != thingid)
+                continue;
+
+            for (mo = FirstMapObjectOfType(info); mo; mo = mo->type_next_)
+            {
+                if (mo->health_ > 0)
+                    thingcount++;
+            }
+        }
     }
 
     lua_pushinteger(L, thingcount);
@@ -1931,7 +1948,7 @@ static int MO_render_view_tag(lua_State *L)
     int   whattag = (int)luaL_checknumber(L, 5);
     // If this tag is not unique, it is not guaranteed which mobj
     // will actually be returned. Plan accordingly - Dasho
-    std::multimap<int, MapObject *>::iterator findme = active_tagged_map_objects.find(whattag);
+    auto findme = active_tagged_map_objects.find(whattag);
 
     if (findme == active_tagged_map_objects.end())
     {
@@ -1939,7 +1956,7 @@ static int MO_render_view_tag(lua_State *L)
     }
     else
     {
-        HUDRenderWorld(x, y, w, h, findme->second, 1);
+        HUDRenderWorld(x, y, w, h, findme->second.front(), 1);
         lua_pushboolean(L, 1);
     }
 
@@ -1957,7 +1974,7 @@ static int MO_render_view_tid(lua_State *L)
     int   whattid = (int)luaL_checknumber(L, 5);
     // TIDs should be unique, but if not it is not guaranteed which mobj
     // will actually be returned. Plan accordingly - Dasho
-    std::multimap<int, MapObject *>::iterator findme = active_tids.find(whattid);
+    auto findme = active_tids.find(whattid);
 
     if (findme == active_tids.end())
     {
@@ -1965,7 +1982,7 @@ static int MO_render_view_tid(lua_State *L)
     }
     else
     {
-        HUDRenderWorld(x, y, w, h, findme->second, 1);
+        HUDRenderWorld(x, y, w, h, findme->second.front(), 1);
         lua_pushboolean(L, 1);
     }
 
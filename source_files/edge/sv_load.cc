@@ -40,6 +40,9 @@ static SaveArray  *loaded_array_list;
 
 bool sv_loading_hub;
 
+// for the timing logged by FinishSaveGameLoad
+static uint32_t load_start_time;
+
 //----------------------------------------------------------------------------
 //
 //  ADMININISTRATION
@@ -106,6 +109,8 @@ void BeginSaveGameLoad(bool is_hub)
 
     for (A = sv_known_arrays; A; A = A->next)
         A->counterpart = nullptr;
+
+    SaveGameMapObjectClearIndex();
 }
 
 static void LoadFreeStruct(SaveStruct *S)
@@ -161,6 +166,10 @@ void FinishSaveGameLoad(void)
 
         LoadFreeArray(A);
     }
+
+    SaveGameMapObjectClearIndex();
+
+    LogPrint("Loaded game in %1.1f ms.\n", (GetMicroseconds() - load_start_time) / 1000.0f);
 }
 
 static SaveField *StructFindField(SaveStruct *info, const char *name)
@@ -409,6 +418,8 @@ bool LoadAllSaveChunks(void)
 {
     bool result;
 
+    load_start_time = GetMicroseconds();
+
     for (;;)
     {
         if (SaveGetError() != 0)
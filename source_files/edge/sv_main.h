@@ -303,6 +303,7 @@ void SaveGamePutMapObject(void *storage, int index);
 
 int   SaveGameMapObjectGetIndex(MapObject *elem);
 void *SaveGameMapObjectFindByIndex(int index);
+void  SaveGameMapObjectClearIndex(void);
 
 int   SaveGamePlayerGetIndex(Player *elem);
 void *SaveGamePlayerFindByIndex(int index);
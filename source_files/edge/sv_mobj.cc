@@ -27,6 +27,9 @@
 
 #include <string.h>
 
+#include <unordered_map>
+#include <vector>
+
 #include "epi.h"
 #include "epi_str_compare.h"
 #include "epi_str_util.h"
@@ -120,6 +123,8 @@ static SaveField sv_fields_mobj[] = {
                     SaveGameMapObjectGetState, SaveGameMapObjectPutState),
     EDGE_SAVE_FIELD(dummy_map_object, tics_, "tics", 1, kSaveFieldNumeric, 4, nullptr, SaveGameGetInteger,
                     SaveGamePutInteger),
+    EDGE_SAVE_FIELD(dummy_map_object, think_debt_, "think_debt", 1, kSaveFieldNumeric, 4, nullptr, SaveGameGetInteger,
+                    SaveGamePutInteger),
     EDGE_SAVE_FIELD(dummy_map_object, flags_, "flags", 1, kSaveFieldNumeric, 4, nullptr, SaveGameGetInteger,
                     SaveGamePutInteger),
     EDGE_SAVE_FIELD(dummy_map_object, extended_flags_, "extendedflags", 1, kSaveFieldNumeric, 4, nullptr,
@@ -323,6 +328,38 @@ int SaveGameMapObjectCountElems(void)
     return count;
 }
 
+//
+// Index <-> pointer tables for the mobj list.  The list can't change
+// while a game is being saved or loaded, so they are built on first use
+// and thrown away at the start and end of each one; before this, every
+// saved mobj reference walked the list.
+//
+static std::vector<MapObject *>                   save_map_objects;
+static std::unordered_map<const MapObject *, int> save_map_object_indices;
+static bool                                       save_map_object_index_valid = false;
+
+static void SaveGameMapObjectBuildIndex(void)
+{
+    save_map_objects.clear();
+    save_map_object_indices.clear();
+
+    for (MapObject *cur = map_object_list_head; cur; cur = cur->next_)
+    {
+        save_map_object_indices.emplace(cur, (int)save_map_objects.size());
+        save_map_objects.push_back(cur);
+    }
+
+    save_map_object_index_valid = true;
+}
+
+void SaveGameMapObjectClearIndex(void)
+{
+    save_map_objects.clear();
+    save_map_object_indices.clear();
+
+    save_map_object_index_valid = false;
+}
+
 //
 // SaveGameMapObjectFindByIndex
 //
@@ -330,17 +367,13 @@ int SaveGameMapObjectCountElems(void)
 //
 void *SaveGameMapObjectFindByIndex(int index)
 {
-    MapObject *cur;
+    if (!save_map_object_index_valid)
+        SaveGameMapObjectBuildIndex();
 
-    for (cur = map_object_list_head; cur && index > 0; cur = cur->next_)
-        index--;
-
-    if (!cur)
+    if (index < 0 || index >= (int)save_map_objects.size())
         FatalError("LOADGAME: Invalid Mobj: %d\n", index);
 
-    EPI_ASSERT(index == 0);
-
-    return cur;
+    return save_map_objects[index];
 }
 
 //
@@ -350,16 +383,15 @@ void *SaveGameMapObjectFindByIndex(int index)
 //
 int SaveGameMapObjectGetIndex(MapObject *elem)
 {
-    MapObject *cur;
-    int        index;
+    if (!save_map_object_index_valid)
+        SaveGameMapObjectBuildIndex();
 
-    for (cur = map_object_list_head, index = 0; cur && cur != elem; cur = cur->next_)
-        index++;
+    auto iter = save_map_object_indices.find(elem);
 
-    if (!cur)
+    if (iter == save_map_object_indices.end())
         FatalError("LOADGAME: No such MobjPtr: %p\n", elem);
 
-    return index;
+    return iter->second;
 }
 
 void SaveGameMapObjectCreateElems(int num_elems)
@@ -368,6 +400,8 @@ void SaveGameMapObjectCreateElems(int num_elems)
     if (map_object_list_head)
         RemoveAllMapObjects(true);
 
+    SaveGameMapObjectClearIndex();
+
     EPI_ASSERT(map_object_list_head == nullptr);
 
     for (; num_elems > 0; num_elems--)
@@ -394,6 +428,12 @@ void SaveGameMapObjectFinaliseElems(void)
     {
         if (mo->info_ == nullptr)
             mo->info_ = mobjtypes.Lookup(0); // template
+    }
+
+    RelinkMapObjectTypes();
+
+    for (MapObject *mo = map_object_list_head; mo != nullptr; mo = mo->next_)
+    {
 
         // do not link zombie objects into the blockmap
         if (!mo->IsRemoved())
@@ -421,10 +461,10 @@ void SaveGameMapObjectFinaliseElems(void)
         seen_monsters.insert(mo->info_);
 
         if (mo->tag_)
-            active_tagged_map_objects.emplace(mo->tag_, mo);
+            active_tagged_map_objects[mo->tag_].push_back(mo);
         if (mo->tid_)
         {
-            active_tids.emplace(mo->tid_, mo);
+            active_tids[mo->tid_].push_back(mo);
             if (mo->tid_ >= next_available_tid)
                 next_available_tid = mo->tid_ + 1;
         }
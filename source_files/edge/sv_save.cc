@@ -36,16 +36,26 @@
 #include "sv_main.h"
 #include "w_wad.h"
 
+static uint32_t save_start_time;
+
 void BeginSaveGameSave(void)
 {
     LogDebug("SV_BeginSave...\n");
 
+    save_start_time = GetMicroseconds();
+
     ClearAllStaleReferences();
+
+    SaveGameMapObjectClearIndex();
 }
 
 void FinishSaveGameSave(void)
 {
     LogDebug("SV_FinishSave...\n");
+
+    SaveGameMapObjectClearIndex();
+
+    LogPrint("Saved game in %1.1f ms.\n", (GetMicroseconds() - save_start_time) / 1000.0f);
 }
 
 void SaveGameStructSave(void *base, SaveStruct *info)
@@ -30,6 +30,7 @@
 #include "w_flat.h"
 
 #include <algorithm>
+#include <unordered_set>
 #include <vector>
 
 #include "ddf_anim.h"
@@ -438,6 +439,8 @@ static void PrecacheTextures(void)
     EDGE_QSORT(const Image *, images, count, 10);
 #undef EDGE_CMP
 
+    std::unordered_set<const Image *> seen;
+
     for (int i = 0; i < count; i++)
     {
         EPI_ASSERT(images[i]);
@@ -449,6 +452,16 @@ static void PrecacheTextures(void)
             continue;
 
         ImagePrecache(images[i]);
+
+        // animated textures/flats: every frame of the sequence.  A frame
+        // listed twice in a sequence makes a ring which need not lead
+        // back to images[i], so stop at the first frame seen before.
+        seen.clear();
+        seen.insert(images[i]);
+
+        for (const Image *anim = images[i]->animation_.next; anim && seen.insert(anim).second;
+             anim = anim->animation_.next)
+            ImagePrecache(anim);
     }
 
     delete[] images;
@@ -463,8 +476,13 @@ static void PrecacheTextures(void)
 //
 void PrecacheLevelGraphics(void)
 {
+    ImageBeginPrecache();
+
     PrecacheSprites();
     PrecacheTextures();
+
+    ImageFinishPrecache();
+
     PrecacheSky();
 }
 
@@ -31,6 +31,7 @@
 #include "w_sprite.h"
 
 #include <algorithm> // sort
+#include <unordered_set>
 
 #include "e_main.h"
 #include "e_search.h"
@@ -730,6 +731,55 @@ SpriteFrame *GetSpriteFrame(int spr_num, int framenum)
     return frame;
 }
 
+//
+// Mark the sprites used by every state of a thing type, then follow the
+// things it can spawn (attacks, drops, blood, etc).
+//
+static void MarkThingSprites(const MapObjectDefinition *info, uint8_t *sprite_present,
+                             std::unordered_set<const MapObjectDefinition *> &visited);
+
+static void MarkAttackSprites(const AttackDefinition *atk, uint8_t *sprite_present,
+                              std::unordered_set<const MapObjectDefinition *> &visited)
+{
+    if (!atk)
+        return;
+
+    MarkThingSprites(atk->atk_mobj_, sprite_present, visited);
+    MarkThingSprites(atk->spawnedobj_, sprite_present, visited);
+    MarkThingSprites(atk->puff_, sprite_present, visited);
+    MarkThingSprites(atk->blood_, sprite_present, visited);
+}
+
+static void MarkThingSprites(const MapObjectDefinition *info, uint8_t *sprite_present,
+                             std::unordered_set<const MapObjectDefinition *> &visited)
+{
+    if (!info || !visited.insert(info).second)
+        return;
+
+    for (const StateRange &range : info->state_grp_)
+    {
+        for (int st = range.first; st <= range.last; st++)
+        {
+            if (st < 1 || st >= num_states)
+                continue;
+
+            int spr = states[st].sprite;
+
+            if (spr >= 1 && spr < sprite_count)
+                sprite_present[spr] = 1;
+        }
+    }
+
+    MarkThingSprites(info->dropitem_, sprite_present, visited);
+    MarkThingSprites(info->blood_, sprite_present, visited);
+    MarkThingSprites(info->respawneffect_, sprite_present, visited);
+    MarkThingSprites(info->spitspot_, sprite_present, visited);
+
+    MarkAttackSprites(info->closecombat_, sprite_present, visited);
+    MarkAttackSprites(info->rangeattack_, sprite_present, visited);
+    MarkAttackSprites(info->spareattack_, sprite_present, visited);
+}
+
 void PrecacheSprites(void)
 {
     EPI_ASSERT(sprite_count > 1);
@@ -737,14 +787,17 @@ void PrecacheSprites(void)
     uint8_t *sprite_present = new uint8_t[sprite_count];
     EPI_CLEAR_MEMORY(sprite_present, uint8_t, sprite_count);
 
+    std::unordered_set<const MapObjectDefinition *> visited;
+
     for (MapObject *mo = map_object_list_head; mo; mo = mo->next_)
     {
         EPI_ASSERT(mo->state_);
 
-        if (mo->state_->sprite < 1 || mo->state_->sprite >= sprite_count)
-            continue;
+        if (mo->state_->sprite >= 1 && mo->state_->sprite < sprite_count)
+            sprite_present[mo->state_->sprite] = 1;
 
-        sprite_present[mo->state_->sprite] = 1;
+        // everything this thing can turn into or spawn
+        MarkThingSprites(mo->info_, sprite_present, visited);
     }
 
     for (int i = 1; i < sprite_count; i++) // ignore 0